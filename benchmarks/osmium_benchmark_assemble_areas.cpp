@@ -0,0 +1,85 @@
+/*
+
+  The code in this file is released into the Public Domain.
+
+*/
+
+// The times for the different assembly phases are only measured and
+// printed if this is compiled with OSMIUM_WITH_TIMER defined (as in the
+// osmium_benchmark_assemble_areas_timed program). The timers add some
+// overhead, so use the program without them to measure the throughput.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <osmium/area/assembler.hpp>
+#include <osmium/area/multipolygon_collector.hpp>
+#include <osmium/handler/node_locations_for_ways.hpp>
+#include <osmium/index/map/sparse_mem_array.hpp>
+#include <osmium/io/any_input.hpp>
+#include <osmium/visitor.hpp>
+
+using index_type = osmium::index::map::SparseMemArray<osmium::unsigned_object_id_type, osmium::Location>;
+
+using location_handler_type = osmium::handler::NodeLocationsForWays<index_type>;
+
+#ifdef OSMIUM_WITH_TIMER
+double ms(uint64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1000000.0;
+}
+#endif
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " OSMFILE\n";
+        std::exit(1);
+    }
+
+    const osmium::io::File input_file{argv[1]};
+
+    osmium::area::Assembler::config_type assembler_config;
+    osmium::area::MultipolygonCollector<osmium::area::Assembler> collector{assembler_config};
+
+    const auto start = std::chrono::steady_clock::now();
+
+    osmium::io::Reader reader1{input_file, osmium::osm_entity_bits::relation};
+    collector.read_relations(reader1);
+    reader1.close();
+
+    index_type index;
+    location_handler_type location_handler{index};
+    location_handler.ignore_errors();
+
+    uint64_t areas = 0;
+    osmium::io::Reader reader2{input_file};
+    osmium::apply(reader2, location_handler, collector.handler([&areas](osmium::memory::Buffer&& buffer) {
+        for (const auto& area : buffer.select<osmium::Area>()) {
+            (void)area;
+            ++areas;
+        }
+    }));
+    reader2.close();
+
+    const auto stop = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(stop - start).count();
+
+    const osmium::area::area_stats& stats = collector.stats();
+    std::cout << "areas=" << areas
+              << " from_ways=" << stats.from_ways
+              << " from_relations=" << stats.from_relations
+              << " seconds=" << seconds
+              << " areas_per_second=" << static_cast<double>(areas) / seconds
+#ifdef OSMIUM_WITH_TIMER
+              << " ms_simple_way=" << ms(stats.time_simple_way)
+              << " ms_extract_segments=" << ms(stats.time_extract_segments)
+              << " ms_find_intersections=" << ms(stats.time_find_intersections)
+              << " ms_build_rings=" << ms(stats.time_build_rings)
+              << " ms_inner_outer=" << ms(stats.time_inner_outer)
+#endif
+              << " max_scratch_memory=" << stats.max_scratch_memory
+              << "\n";
+}
+
@@ -4,19 +4,83 @@
 
 */
 
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <osmium/io/any_input.hpp>
 #include <osmium/handler.hpp>
+#include <osmium/tags/filter.hpp>
 #include <osmium/visitor.hpp>
 
+// A typical set of rules selecting features for a map.
+const std::vector<std::pair<const char*, const char*>> rules = {
+    {"amenity", "post_box"}, {"amenity", "restaurant"}, {"amenity", "cafe"},
+    {"amenity", "school"}, {"amenity", "parking"}, {"amenity", "bench"},
+    {"shop", nullptr}, {"tourism", nullptr}, {"leisure", nullptr},
+    {"highway", "motorway"}, {"highway", "trunk"}, {"highway", "primary"},
+    {"highway", "secondary"}, {"highway", "tertiary"}, {"highway", "residential"},
+    {"highway", "service"}, {"highway", "track"}, {"highway", "footway"},
+    {"railway", "rail"}, {"railway", "tram"}, {"waterway", "river"},
+    {"waterway", "stream"}, {"natural", "water"}, {"natural", "wood"},
+    {"landuse", "forest"}, {"landuse", "residential"}, {"landuse", "farmland"},
+    {"landuse", "meadow"}, {"landuse", "grass"}, {"boundary", "administrative"},
+    {"place", nullptr}, {"power", "line"}, {"building", "church"},
+    {"building", "school"}, {"man_made", nullptr}, {"aeroway", nullptr}
+};
+
 struct CountHandler : public osmium::handler::Handler {
 
+    using clock = std::chrono::steady_clock;
+
+    osmium::tags::KeyValueFilter filter{false};
+
     uint64_t counter = 0;
     uint64_t all = 0;
+    uint64_t linear_matches = 0;
+    uint64_t filter_matches = 0;
+    clock::duration linear_time{0};
+    clock::duration filter_time{0};
+
+    CountHandler() {
+        for (const auto& rule : rules) {
+            if (rule.second) {
+                filter.add(true, rule.first, rule.second);
+            } else {
+                filter.add(true, rule.first);
+            }
+        }
+    }
+
+    // Check all rules one after the other with string comparisons as a
+    // reference.
+    static bool match_linear(const osmium::Tag& tag) {
+        for (const auto& rule : rules) {
+            if (!std::strcmp(rule.first, tag.key()) && (!rule.second || !std::strcmp(rule.second, tag.value()))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void check_tags(const osmium::OSMObject& object) {
+        const auto start = clock::now();
+        for (const auto& tag : object.tags()) {
+            linear_matches += match_linear(tag);
+        }
+        const auto middle = clock::now();
+        for (const auto& tag : object.tags()) {
+            filter_matches += filter(tag);
+        }
+        const auto stop = clock::now();
+        linear_time += middle - start;
+        filter_time += stop - middle;
+    }
 
     void node(const osmium::Node& node) {
         ++all;
@@ -24,14 +88,19 @@ struct CountHandler : public osmium::handler::Handler {
         if (amenity && !strcmp(amenity, "post_box")) {
             ++counter;
         }
+        if (!node.tags().empty()) {
+            check_tags(node);
+        }
     }
 
-    void way(const osmium::Way&) {
+    void way(const osmium::Way& way) {
         ++all;
+        check_tags(way);
     }
 
-    void relation(const osmium::Relation&) {
+    void relation(const osmium::Relation& relation) {
         ++all;
+        check_tags(relation);
     }
 
 };
@@ -51,6 +120,10 @@ int main(int argc, char* argv[]) {
     osmium::apply(reader, handler);
     reader.close();
 
-    std::cout << "r_all=" << handler.all << " r_counter="  << handler.counter << "\n";
+    std::cout << "r_all=" << handler.all << " r_counter="  << handler.counter
+              << " linear_matches=" << handler.linear_matches
+              << " filter_matches=" << handler.filter_matches
+              << " linear_seconds=" << std::chrono::duration<double>(handler.linear_time).count()
+              << " filter_seconds=" << std::chrono::duration<double>(handler.filter_time).count()
+              << "\n";
 }
-
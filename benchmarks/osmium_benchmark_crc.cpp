@@ -0,0 +1,82 @@
+/*
+
+  The code in this file is released into the Public Domain.
+
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/crc.hpp>
+
+#include <osmium/io/any_input.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/crc.hpp>
+#include <osmium/util/crc32c.hpp>
+
+template <typename TCRC>
+uint32_t checksum_all(const std::vector<osmium::memory::Buffer>& buffers, double& seconds) {
+    uint32_t result = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& buffer : buffers) {
+        for (const auto& item : buffer) {
+            osmium::CRC<TCRC> crc;
+            switch (item.type()) {
+                case osmium::item_type::node:
+                    crc.update(static_cast<const osmium::Node&>(item));
+                    break;
+                case osmium::item_type::way:
+                    crc.update(static_cast<const osmium::Way&>(item));
+                    break;
+                case osmium::item_type::relation:
+                    crc.update(static_cast<const osmium::Relation&>(item));
+                    break;
+                default:
+                    break;
+            }
+            result ^= crc().checksum();
+        }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " OSMFILE\n";
+        std::exit(1);
+    }
+
+    const std::string input_filename{argv[1]};
+
+    std::vector<osmium::memory::Buffer> buffers;
+    uint64_t objects = 0;
+    osmium::io::Reader reader{input_filename, osmium::osm_entity_bits::nwr};
+    while (osmium::memory::Buffer buffer = reader.read()) {
+        for (const auto& item : buffer) {
+            (void)item;
+            ++objects;
+        }
+        buffers.push_back(std::move(buffer));
+    }
+    reader.close();
+
+    double boost_seconds = 0.0;
+    double crc32c_seconds = 0.0;
+    const uint32_t boost_result = checksum_all<boost::crc_32_type>(buffers, boost_seconds);
+    const uint32_t crc32c_result = checksum_all<osmium::util::CRC32C>(buffers, crc32c_seconds);
+
+    std::cout << "objects=" << objects
+              << " crc32c_hardware=" << (osmium::util::CRC32C{}.hardware() ? "yes" : "no")
+              << " boost_seconds=" << boost_seconds
+              << " crc32c_seconds=" << crc32c_seconds
+              << " boost_objects_per_second=" << static_cast<double>(objects) / boost_seconds
+              << " crc32c_objects_per_second=" << static_cast<double>(objects) / crc32c_seconds
+              << " boost_checksum=" << boost_result
+              << " crc32c_checksum=" << crc32c_result
+              << "\n";
+}
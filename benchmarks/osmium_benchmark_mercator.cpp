@@ -4,10 +4,12 @@
 
 */
 
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include <osmium/io/any_input.hpp>
 #include <osmium/handler.hpp>
@@ -25,6 +27,43 @@ struct GeomHandler : public osmium::handler::Handler {
 
 };
 
+// Compares projecting node locations one at a time with projecting
+// all locations in a buffer at once.
+struct ProjectionComparison {
+
+    using clock = std::chrono::steady_clock;
+
+    std::vector<osmium::Location> locations;
+    std::vector<osmium::geom::Coordinates> coordinates;
+    clock::duration scalar_time{0};
+    clock::duration batch_time{0};
+    double checksum = 0.0;
+
+    void operator()(const osmium::memory::Buffer& buffer) {
+        locations.clear();
+        for (const auto& node : buffer.select<osmium::Node>()) {
+            if (node.location().valid()) {
+                locations.push_back(node.location());
+            }
+        }
+        coordinates.assign(locations.size(), osmium::geom::Coordinates{0.0, 0.0});
+
+        const auto start = clock::now();
+        for (size_t i = 0; i < locations.size(); ++i) {
+            coordinates[i] = osmium::geom::lonlat_to_mercator(locations[i]);
+        }
+        const auto middle = clock::now();
+        osmium::geom::lonlat_to_mercator(locations.data(), locations.data() + locations.size(), coordinates.data());
+        const auto stop = clock::now();
+
+        scalar_time += middle - start;
+        batch_time += stop - middle;
+        if (!coordinates.empty()) {
+            checksum += coordinates.back().y;
+        }
+    }
+
+};
 
 int main(int argc, char* argv[]) {
     if (argc != 2) {
@@ -37,7 +76,23 @@ int main(int argc, char* argv[]) {
     osmium::io::Reader reader{input_filename};
 
     GeomHandler handler;
-    osmium::apply(reader, handler);
+    ProjectionComparison comparison;
+    uint64_t nodes = 0;
+    while (osmium::memory::Buffer buffer = reader.read()) {
+        osmium::apply(buffer, handler);
+        comparison(buffer);
+        nodes += comparison.locations.size();
+    }
     reader.close();
+
+    const double scalar_seconds = std::chrono::duration<double>(comparison.scalar_time).count();
+    const double batch_seconds = std::chrono::duration<double>(comparison.batch_time).count();
+    std::cout << "nodes=" << nodes
+              << " scalar_seconds=" << scalar_seconds
+              << " batch_seconds=" << batch_seconds
+              << " scalar_nodes_per_second=" << static_cast<double>(nodes) / scalar_seconds
+              << " batch_nodes_per_second=" << static_cast<double>(nodes) / batch_seconds
+              << " checksum=" << comparison.checksum
+              << "\n";
 }
 
@@ -0,0 +1,100 @@
+/*
+
+  The code in this file is released into the Public Domain.
+
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <osmium/geom/tile.hpp>
+#include <osmium/handler.hpp>
+#include <osmium/handler/node_locations_for_ways.hpp>
+#include <osmium/index/map/sparse_mem_array.hpp>
+#include <osmium/io/any_input.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/visitor.hpp>
+
+using index_type = osmium::index::map::SparseMemArray<osmium::unsigned_object_id_type, osmium::Location>;
+
+using location_handler_type = osmium::handler::NodeLocationsForWays<index_type>;
+
+// Copies all ways where all nodes have a valid location into a buffer.
+struct WayCollector : public osmium::handler::Handler {
+
+    osmium::memory::Buffer buffer{1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+
+    void way(const osmium::Way& way) {
+        for (const auto& nr : way.nodes()) {
+            if (!nr.location().valid()) {
+                return;
+            }
+        }
+        buffer.add_item(way);
+        buffer.commit();
+    }
+
+};
+
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " OSMFILE [ZOOM]\n";
+        std::exit(1);
+    }
+
+    const std::string input_filename{argv[1]};
+    const uint32_t zoom = argc == 3 ? static_cast<uint32_t>(std::atoi(argv[2])) : 15;
+
+    index_type index;
+    location_handler_type location_handler{index};
+    location_handler.ignore_errors();
+
+    WayCollector collector;
+    osmium::io::Reader reader{input_filename, osmium::osm_entity_bits::node | osmium::osm_entity_bits::way};
+    osmium::apply(reader, location_handler, collector);
+    reader.close();
+
+    using clock = std::chrono::steady_clock;
+
+    // Naive approach: project every node and deduplicate the tiles in a
+    // std::set. This misses tiles crossed by a segment between nodes.
+    uint64_t ways = 0;
+    uint64_t naive_tiles = 0;
+    const auto naive_start = clock::now();
+    for (const auto& way : collector.buffer.select<osmium::Way>()) {
+        std::set<osmium::geom::Tile> tiles;
+        for (const auto& nr : way.nodes()) {
+            tiles.emplace(zoom, nr.location());
+        }
+        naive_tiles += tiles.size();
+        ++ways;
+    }
+    const auto naive_stop = clock::now();
+
+    // Line rasterisation into a re-used vector.
+    uint64_t cover_tiles = 0;
+    std::vector<osmium::geom::Tile> tiles;
+    const auto cover_start = clock::now();
+    for (const auto& way : collector.buffer.select<osmium::Way>()) {
+        osmium::geom::tiles_for(way, zoom, tiles);
+        cover_tiles += tiles.size();
+    }
+    const auto cover_stop = clock::now();
+
+    const double naive_seconds = std::chrono::duration<double>(naive_stop - naive_start).count();
+    const double cover_seconds = std::chrono::duration<double>(cover_stop - cover_start).count();
+    std::cout << "ways=" << ways
+              << " zoom=" << zoom
+              << " naive_seconds=" << naive_seconds
+              << " cover_seconds=" << cover_seconds
+              << " naive_ways_per_second=" << static_cast<double>(ways) / naive_seconds
+              << " cover_ways_per_second=" << static_cast<double>(ways) / cover_seconds
+              << " naive_tiles=" << naive_tiles
+              << " cover_tiles=" << cover_tiles
+              << "\n";
+}
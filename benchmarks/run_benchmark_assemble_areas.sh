@@ -0,0 +1,35 @@
+#!/bin/sh
+#
+#  run_benchmark_assemble_areas.sh
+#
+#  After each run the line with the areas per second (as output by the
+#  benchmark program) is printed as a comment. After all runs for a file
+#  the program compiled with timers is run once and its line with the
+#  time spent in each phase of the assembly is printed as a comment.
+#
+
+set -e
+
+BENCHMARK_NAME=assemble_areas
+
+. @CMAKE_BINARY_DIR@/benchmarks/setup.sh
+
+CMD=$OB_DIR/osmium_benchmark_$BENCHMARK_NAME
+CMD_TIMED=$OB_DIR/osmium_benchmark_${BENCHMARK_NAME}_timed
+
+TIME_OUTPUT=`mktemp`
+
+echo "# file size num mem time cpu_kernel cpu_user cpu_percent cmd options"
+for data in $OB_DATA_FILES; do
+    filename=`basename $data`
+    filesize=`stat --format="%s" --dereference $data`
+    for n in $OB_SEQ; do
+        result=`$OB_TIME_CMD -o $TIME_OUTPUT -f "$filename $filesize $n $OB_TIME_FORMAT" $CMD $data`
+        sed -e "s%$DATA_DIR/%%" -e "s%$OB_DIR/%%" $TIME_OUTPUT
+        echo "# $result"
+    done
+    echo "# timed: `$CMD_TIMED $data`"
+done
+
+rm -f $TIME_OUTPUT
+
@@ -0,0 +1,32 @@
+#!/bin/sh
+#
+#  run_benchmark_crc.sh
+#
+#  After each run the line with the number of objects per second checksummed
+#  with the Boost CRC32 and with the CRC32C implementation in libosmium (as
+#  output by the benchmark program) is printed as a comment.
+#
+
+set -e
+
+BENCHMARK_NAME=crc
+
+. @CMAKE_BINARY_DIR@/benchmarks/setup.sh
+
+CMD=$OB_DIR/osmium_benchmark_$BENCHMARK_NAME
+
+TIME_OUTPUT=`mktemp`
+
+echo "# file size num mem time cpu_kernel cpu_user cpu_percent cmd options"
+for data in $OB_DATA_FILES; do
+    filename=`basename $data`
+    filesize=`stat --format="%s" --dereference $data`
+    for n in $OB_SEQ; do
+        result=`$OB_TIME_CMD -o $TIME_OUTPUT -f "$filename $filesize $n $OB_TIME_FORMAT" $CMD $data`
+        sed -e "s%$DATA_DIR/%%" -e "s%$OB_DIR/%%" $TIME_OUTPUT
+        echo "# $result"
+    done
+done
+
+rm -f $TIME_OUTPUT
+
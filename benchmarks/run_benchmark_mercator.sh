@@ -2,6 +2,11 @@
 #
 #  run_benchmark_mercator.sh
 #
+#  After each run the line with the number of nodes projected per second
+#  when projecting one location at a time and when projecting all
+#  locations in a buffer at once (as output by the benchmark program) is
+#  printed as a comment.
+#
 
 set -e
 
@@ -11,12 +16,18 @@ BENCHMARK_NAME=mercator
 
 CMD=$OB_DIR/osmium_benchmark_$BENCHMARK_NAME
 
+TIME_OUTPUT=`mktemp`
+
 echo "# file size num mem time cpu_kernel cpu_user cpu_percent cmd options"
 for data in $OB_DATA_FILES; do
     filename=`basename $data`
     filesize=`stat --format="%s" --dereference $data`
     for n in $OB_SEQ; do
-        $OB_TIME_CMD -f "$filename $filesize $n $OB_TIME_FORMAT" $CMD $data 2>&1 >/dev/null | sed -e "s%$DATA_DIR/%%" | sed -e "s%$OB_DIR/%%"
+        result=`$OB_TIME_CMD -o $TIME_OUTPUT -f "$filename $filesize $n $OB_TIME_FORMAT" $CMD $data`
+        sed -e "s%$DATA_DIR/%%" -e "s%$OB_DIR/%%" $TIME_OUTPUT
+        echo "# $result"
     done
 done
 
+rm -f $TIME_OUTPUT
+
@@ -0,0 +1,33 @@
+#!/bin/sh
+#
+#  run_benchmark_tile_cover.sh
+#
+#  After each run the line with the number of ways per second for which
+#  the tiles on zoom level 15 were found by projecting every node into a
+#  std::set and by rasterising the segments with tiles_for() (as output
+#  by the benchmark program) is printed as a comment.
+#
+
+set -e
+
+BENCHMARK_NAME=tile_cover
+
+. @CMAKE_BINARY_DIR@/benchmarks/setup.sh
+
+CMD=$OB_DIR/osmium_benchmark_$BENCHMARK_NAME
+
+TIME_OUTPUT=`mktemp`
+
+echo "# file size num mem time cpu_kernel cpu_user cpu_percent cmd options"
+for data in $OB_DATA_FILES; do
+    filename=`basename $data`
+    filesize=`stat --format="%s" --dereference $data`
+    for n in $OB_SEQ; do
+        result=`$OB_TIME_CMD -o $TIME_OUTPUT -f "$filename $filesize $n $OB_TIME_FORMAT" $CMD $data`
+        sed -e "s%$DATA_DIR/%%" -e "s%$OB_DIR/%%" $TIME_OUTPUT
+        echo "# $result"
+    done
+done
+
+rm -f $TIME_OUTPUT
+
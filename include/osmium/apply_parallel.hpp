@@ -0,0 +1,430 @@
+#ifndef OSMIUM_APPLY_PARALLEL_HPP
+#define OSMIUM_APPLY_PARALLEL_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <osmium/diff_visitor.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/object.hpp>
+#include <osmium/osm/object_comparisons.hpp>
+#include <osmium/thread/pool.hpp>
+#include <osmium/visitor.hpp>
+
+namespace osmium {
+
+    namespace detail {
+
+        // Maximum number of buffers handed to the thread pool and not yet
+        // finished. If there are more, the caller waits for the oldest.
+        constexpr const size_t max_parallel_buffers_in_flight = 32;
+
+        /**
+         * Handler instances for apply_parallel(). Each worker takes a
+         * handler out of the store, uses it for one buffer and puts it
+         * back, so a handler is never used by two threads at the same
+         * time. New handlers are only created if all existing handlers
+         * are in use, so there are never more handlers than pool threads.
+         */
+        template <typename THandlerFactory>
+        class handler_store {
+
+        public:
+
+            using handler_type = typename std::decay<typename std::result_of<THandlerFactory()>::type>::type;
+
+        private:
+
+            THandlerFactory m_factory;
+            std::mutex m_mutex;
+            std::vector<std::unique_ptr<handler_type>> m_handlers;
+            std::vector<handler_type*> m_free;
+
+        public:
+
+            explicit handler_store(THandlerFactory factory) :
+                m_factory(std::move(factory)) {
+            }
+
+            handler_type* get() {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                if (m_free.empty()) {
+                    m_handlers.emplace_back(new handler_type(m_factory()));
+                    return m_handlers.back().get();
+                }
+                handler_type* handler = m_free.back();
+                m_free.pop_back();
+                return handler;
+            }
+
+            void put_back(handler_type* handler) {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                m_free.push_back(handler);
+            }
+
+            std::vector<std::unique_ptr<handler_type>>& handlers() noexcept {
+                return m_handlers;
+            }
+
+        }; // class handler_store
+
+        template <typename THandlerFactory>
+        class apply_parallel_task {
+
+            std::shared_ptr<handler_store<THandlerFactory>> m_store;
+            osmium::memory::Buffer m_buffer;
+
+        public:
+
+            apply_parallel_task(const std::shared_ptr<handler_store<THandlerFactory>>& store, osmium::memory::Buffer&& buffer) :
+                m_store(store),
+                m_buffer(std::move(buffer)) {
+            }
+
+            void operator()() {
+                auto handler = m_store->get();
+                try {
+                    for (auto& item : m_buffer) {
+                        osmium::apply_item(item, *handler);
+                    }
+                } catch (...) {
+                    m_store->put_back(handler);
+                    throw;
+                }
+                m_store->put_back(handler);
+            }
+
+        }; // class apply_parallel_task
+
+        template <typename THandler>
+        class apply_parallel_ordered_task {
+
+            THandler m_handler;
+            osmium::memory::Buffer m_buffer;
+
+        public:
+
+            apply_parallel_ordered_task(THandler&& handler, osmium::memory::Buffer&& buffer) :
+                m_handler(std::move(handler)),
+                m_buffer(std::move(buffer)) {
+            }
+
+            THandler operator()() {
+                osmium::apply(m_buffer, m_handler);
+                return std::move(m_handler);
+            }
+
+        }; // class apply_parallel_ordered_task
+
+        /**
+         * Task for apply_diff_parallel(). It runs the diff handler on all
+         * versions of one object carried over from the previous buffer
+         * (if any) and then on the objects in the given range of a buffer.
+         * The range only contains complete objects (ie all versions).
+         */
+        template <typename THandlerFactory>
+        class apply_diff_parallel_task {
+
+            std::shared_ptr<handler_store<THandlerFactory>> m_store;
+            osmium::memory::Buffer m_carried;
+            osmium::memory::Buffer m_buffer;
+            size_t m_begin;
+            size_t m_end;
+
+        public:
+
+            apply_diff_parallel_task(const std::shared_ptr<handler_store<THandlerFactory>>& store, osmium::memory::Buffer&& carried, osmium::memory::Buffer&& buffer, size_t begin, size_t end) :
+                m_store(store),
+                m_carried(std::move(carried)),
+                m_buffer(std::move(buffer)),
+                m_begin(begin),
+                m_end(end) {
+            }
+
+            void operator()() {
+                using iterator = osmium::memory::Buffer::t_const_iterator<osmium::OSMObject>;
+
+                auto handler = m_store->get();
+                try {
+                    if (m_carried) {
+                        osmium::apply_diff(m_carried.cbegin<osmium::OSMObject>(), m_carried.cend<osmium::OSMObject>(), *handler);
+                    }
+                    if (m_buffer) {
+                        const unsigned char* end = m_buffer.data() + m_end;
+                        osmium::apply_diff(iterator{m_buffer.data() + m_begin, end}, iterator{end, end}, *handler);
+                    }
+                } catch (...) {
+                    m_store->put_back(handler);
+                    throw;
+                }
+                m_store->put_back(handler);
+            }
+
+        }; // class apply_diff_parallel_task
+
+        /**
+         * Wait for all tasks to finish. Used to make sure no handler is
+         * still running when an exception leaves apply_parallel().
+         */
+        template <typename T>
+        inline void wait_for_all(std::deque<std::future<T>>& results) noexcept {
+            for (auto& result : results) {
+                if (result.valid()) {
+                    result.wait();
+                }
+            }
+        }
+
+    } // namespace detail
+
+    /**
+     * Apply the handlers created by the handler factory to all objects
+     * read from the source (usually an osmium::io::Reader). Buffers are
+     * processed in parallel on the thread pool. Use this for handlers
+     * which don't care about the order of the objects, like most
+     * handlers collecting statistics.
+     *
+     * Every worker gets its own handler instance, so the handlers don't
+     * need to be thread safe. Instances are created with the factory as
+     * needed, there will never be more instances than threads in the
+     * pool. The factory is only called from one thread at a time.
+     *
+     * After all buffers are processed, the flush() function of each
+     * handler is called and then the merge function is called once with
+     * each handler instance (as reference) on the calling thread, so it
+     * can combine the results.
+     *
+     * @code
+     *   uint64_t nodes = 0;
+     *   osmium::apply_parallel(reader,
+     *       []() { return CountHandler{}; },
+     *       [&nodes](CountHandler& handler) { nodes += handler.nodes; });
+     * @endcode
+     *
+     * @param source Source of buffers, must have a read() function
+     *               returning an osmium::memory::Buffer which is invalid
+     *               at the end of data.
+     * @param factory Function (object) without arguments returning a
+     *                new handler.
+     * @param merge Function (object) called with each handler instance.
+     * @throws Any exception thrown by a handler, the factory, or the
+     *         source.
+     */
+    template <typename TSource, typename THandlerFactory, typename TMerge>
+    inline void apply_parallel(TSource& source, THandlerFactory&& factory, TMerge&& merge) {
+        using factory_type = typename std::decay<THandlerFactory>::type;
+        using store_type = detail::handler_store<factory_type>;
+
+        auto store = std::make_shared<store_type>(std::forward<THandlerFactory>(factory));
+        std::deque<std::future<void>> results;
+
+        try {
+            while (osmium::memory::Buffer buffer = source.read()) {
+                results.push_back(osmium::thread::Pool::instance().submit(detail::apply_parallel_task<factory_type>{store, std::move(buffer)}));
+                if (results.size() > detail::max_parallel_buffers_in_flight) {
+                    results.front().get();
+                    results.pop_front();
+                }
+            }
+
+            while (!results.empty()) {
+                results.front().get();
+                results.pop_front();
+            }
+        } catch (...) {
+            detail::wait_for_all(results);
+            throw;
+        }
+
+        for (auto& handler : store->handlers()) {
+            handler->flush();
+            merge(*handler);
+        }
+    }
+
+    /**
+     * Like apply_parallel(), but each buffer is processed by a new
+     * handler instance and the merge function is called with those
+     * handlers in the order of the buffers in the input. Use this if the
+     * results depend on the order of the objects, for instance when
+     * writing them out.
+     *
+     * The factory is called on the calling thread for every buffer read.
+     * The merge function is called on the calling thread with each handler
+     * (as rvalue reference) after the handler is done with its buffer,
+     * so the results are merged while other buffers are still being
+     * processed. The handler type must be move constructible.
+     *
+     * @throws Any exception thrown by a handler, the factory, or the
+     *         source.
+     */
+    template <typename TSource, typename THandlerFactory, typename TMerge>
+    inline void apply_parallel_ordered(TSource& source, THandlerFactory&& factory, TMerge&& merge) {
+        using handler_type = typename std::decay<typename std::result_of<THandlerFactory()>::type>::type;
+
+        std::deque<std::future<handler_type>> results;
+
+        try {
+            while (osmium::memory::Buffer buffer = source.read()) {
+                results.push_back(osmium::thread::Pool::instance().submit(detail::apply_parallel_ordered_task<handler_type>{factory(), std::move(buffer)}));
+                while (!results.empty() &&
+                       (results.size() > detail::max_parallel_buffers_in_flight ||
+                        results.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+                    merge(results.front().get());
+                    results.pop_front();
+                }
+            }
+
+            while (!results.empty()) {
+                merge(results.front().get());
+                results.pop_front();
+            }
+        } catch (...) {
+            detail::wait_for_all(results);
+            throw;
+        }
+    }
+
+    /**
+     * Apply the diff handlers created by the handler factory to all
+     * objects read from the source (usually an osmium::io::Reader reading
+     * a history file). This is the parallel version of
+     * osmium::apply_diff(). The input must be sorted by type, id, and
+     * version.
+     *
+     * Buffers from the source are split at object boundaries. All
+     * versions of an object at the end of a buffer are copied and
+     * processed together with the versions of the same object at the
+     * beginning of the next buffer. Because the handlers always see all
+     * versions of an object together, the DiffObjects they get are the
+     * same as with apply_diff().
+     *
+     * Handler instances are created and merged as in apply_parallel(),
+     * but the handlers are not flushed (diff handlers don't have a
+     * flush() function). The order in which objects are seen by each
+     * handler instance is unspecified.
+     *
+     * @param source Source of buffers, must have a read() function
+     *               returning an osmium::memory::Buffer which is invalid
+     *               at the end of data.
+     * @param factory Function (object) without arguments returning a
+     *                new diff handler.
+     * @param merge Function (object) called with each handler instance.
+     * @throws Any exception thrown by a handler, the factory, or the
+     *         source.
+     */
+    template <typename TSource, typename THandlerFactory, typename TMerge>
+    inline void apply_diff_parallel(TSource& source, THandlerFactory&& factory, TMerge&& merge) {
+        using factory_type = typename std::decay<THandlerFactory>::type;
+        using store_type = detail::handler_store<factory_type>;
+        using task_type = detail::apply_diff_parallel_task<factory_type>;
+
+        auto store = std::make_shared<store_type>(std::forward<THandlerFactory>(factory));
+        std::deque<std::future<void>> results;
+
+        const osmium::object_equal_type_id same_object;
+
+        try {
+            // All versions of the last object in the previous buffer
+            osmium::memory::Buffer carried;
+
+            while (osmium::memory::Buffer buffer = source.read()) {
+                auto it = buffer.cbegin<osmium::OSMObject>();
+                const auto end = buffer.cend<osmium::OSMObject>();
+
+                if (carried) {
+                    const osmium::OSMObject& object = *carried.cbegin<osmium::OSMObject>();
+                    for (; it != end && same_object(*it, object); ++it) {
+                        carried.add_item(*it);
+                        carried.commit();
+                    }
+                }
+
+                if (it == end) {
+                    continue;
+                }
+
+                auto last = it;
+                for (auto o = it; o != end; ++o) {
+                    if (!same_object(*o, *last)) {
+                        last = o;
+                    }
+                }
+
+                osmium::memory::Buffer next_carried{10240, osmium::memory::Buffer::auto_grow::yes};
+                for (auto o = last; o != end; ++o) {
+                    next_carried.add_item(*o);
+                    next_carried.commit();
+                }
+
+                const size_t begin_offset = static_cast<size_t>(it.data() - buffer.data());
+                const size_t end_offset = static_cast<size_t>(last.data() - buffer.data());
+                results.push_back(osmium::thread::Pool::instance().submit(task_type{store, std::move(carried), std::move(buffer), begin_offset, end_offset}));
+                carried = std::move(next_carried);
+
+                if (results.size() > detail::max_parallel_buffers_in_flight) {
+                    results.front().get();
+                    results.pop_front();
+                }
+            }
+
+            if (carried) {
+                results.push_back(osmium::thread::Pool::instance().submit(task_type{store, std::move(carried), osmium::memory::Buffer{}, 0, 0}));
+            }
+
+            while (!results.empty()) {
+                results.front().get();
+                results.pop_front();
+            }
+        } catch (...) {
+            detail::wait_for_all(results);
+            throw;
+        }
+
+        for (auto& handler : store->handlers()) {
+            merge(*handler);
+        }
+    }
+
+} // namespace osmium
+
+#endif // OSMIUM_APPLY_PARALLEL_HPP
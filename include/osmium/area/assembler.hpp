@@ -34,6 +34,7 @@ DEALINGS IN THE SOFTWARE.
 */
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <cstdlib>
@@ -41,10 +42,7 @@ DEALINGS IN THE SOFTWARE.
 #include <iostream>
 #include <iterator>
 #include <list>
-#include <set>
-#include <string>
-#include <map>
-#include <unordered_map>
+#include <memory>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -206,6 +204,11 @@ namespace osmium {
         /**
          * Assembles area objects from closed ways or multipolygon relations
          * and their members.
+         *
+         * An Assembler object can be used to assemble any number of areas
+         * one after the other. The memory it uses for its working data is
+         * kept between calls, so re-using an Assembler avoids most memory
+         * allocations.
          */
         class Assembler {
 
@@ -269,6 +272,33 @@ namespace osmium {
             // The number of members the multipolygon relation has
             size_t m_num_members = 0;
 
+            // Rings that are not in use any more. They are kept around so
+            // that they can be re-used without allocating memory.
+            std::list<detail::ProtoRing> m_spare_rings;
+
+            // Scratch space for ways used in different steps.
+            std::vector<const osmium::Way*> m_ways;
+
+            // Scratch space for (way, ring) pairs in role check.
+            std::vector<std::pair<const osmium::Way*, const detail::ProtoRing*>> m_way_rings;
+
+            // Scratch space for counting tags on outer ways.
+            std::vector<std::pair<const char*, const char*>> m_tags;
+
+            // Scratch space for closed rings in the complex case.
+            std::vector<detail::ProtoRing*> m_closed_rings;
+
+            // Scratch space for inner ways of a multipolygon relation that
+            // should be areas on their own.
+            std::vector<const osmium::Way*> m_ways_that_should_be_areas;
+
+            // Assembler for the areas from those inner ways. Created when
+            // it is needed first and then re-used.
+            std::unique_ptr<Assembler> m_way_assembler;
+
+            // High-water mark of the memory used for the working data.
+            uint64_t m_max_scratch_memory = 0;
+
             bool debug() const noexcept {
                 return m_config.debug_level > 1;
             }
@@ -291,26 +321,36 @@ namespace osmium {
                 builder.add_item(way.tags());
             }
 
-            void add_common_tags(osmium::builder::TagListBuilder& tl_builder, std::set<const osmium::Way*>& ways) const {
-                std::map<std::string, size_t> counter;
+            /**
+             * Add all tags to the builder that are on all of the given ways.
+             */
+            void add_common_tags(osmium::builder::TagListBuilder& tl_builder, const std::vector<const osmium::Way*>& ways) {
+                m_tags.clear();
                 for (const osmium::Way* way : ways) {
                     for (const auto& tag : way->tags()) {
-                        std::string kv {tag.key()};
-                        kv.append(1, '\0');
-                        kv.append(tag.value());
-                        ++counter[kv];
+                        m_tags.emplace_back(tag.key(), tag.value());
                     }
                 }
 
+                std::sort(m_tags.begin(), m_tags.end(), [](const std::pair<const char*, const char*>& lhs, const std::pair<const char*, const char*>& rhs) {
+                    const int c = std::strcmp(lhs.first, rhs.first);
+                    return c < 0 || (c == 0 && std::strcmp(lhs.second, rhs.second) < 0);
+                });
+
                 const size_t num_ways = ways.size();
-                for (const auto& t_c : counter) {
+                auto it = m_tags.cbegin();
+                while (it != m_tags.cend()) {
+                    const auto next = std::find_if(it, m_tags.cend(), [it](const std::pair<const char*, const char*>& tag) {
+                        return std::strcmp(it->first, tag.first) || std::strcmp(it->second, tag.second);
+                    });
+                    const size_t count = std::distance(it, next);
                     if (debug()) {
-                        std::cerr << "        tag " << t_c.first << " is used " << t_c.second << " times in " << num_ways << " ways\n";
+                        std::cerr << "        tag " << it->first << "=" << it->second << " is used " << count << " times in " << num_ways << " ways\n";
                     }
-                    if (t_c.second == num_ways) {
-                        const size_t len = std::strlen(t_c.first.c_str());
-                        tl_builder.add_tag(t_c.first.c_str(), t_c.first.c_str() + len + 1);
+                    if (count == num_ways) {
+                        tl_builder.add_tag(it->first, it->second);
                     }
+                    it = next;
                 }
             }
 
@@ -363,23 +403,25 @@ namespace osmium {
                     if (debug()) {
                         std::cerr << "    use tags from outer ways\n";
                     }
-                    std::set<const osmium::Way*> ways;
+                    m_ways.clear();
                     for (const auto& ring : m_rings) {
                         if (ring.is_outer()) {
-                            ring.get_ways(ways);
+                            ring.get_ways(m_ways);
                         }
                     }
-                    if (ways.size() == 1) {
+                    std::sort(m_ways.begin(), m_ways.end());
+                    m_ways.erase(std::unique(m_ways.begin(), m_ways.end()), m_ways.end());
+                    if (m_ways.size() == 1) {
                         if (debug()) {
                             std::cerr << "      only one outer way\n";
                         }
-                        builder.add_item((*ways.cbegin())->tags());
+                        builder.add_item(m_ways.front()->tags());
                     } else {
                         if (debug()) {
                             std::cerr << "      multiple outer ways, get common tags\n";
                         }
                         osmium::builder::TagListBuilder tl_builder{builder};
-                        add_common_tags(tl_builder, ways);
+                        add_common_tags(tl_builder, m_ways);
                     }
                 }
             }
@@ -413,8 +455,7 @@ namespace osmium {
                     std::cerr << "    Checking inner/outer roles\n";
                 }
 
-                std::unordered_map<const osmium::Way*, const detail::ProtoRing*> way_rings;
-                std::unordered_set<const osmium::Way*> ways_in_multiple_rings;
+                m_way_rings.clear();
 
                 for (const detail::ProtoRing& ring : m_rings) {
                     for (const auto& segment : ring.segments()) {
@@ -435,17 +476,24 @@ namespace osmium {
                             }
                         }
 
-                        auto& r = way_rings[segment->way()];
-                        if (!r) {
-                            r = &ring;
-                        } else if (r != &ring) {
-                            ways_in_multiple_rings.insert(segment->way());
-                        }
+                        m_way_rings.emplace_back(segment->way(), &ring);
+                    }
+                }
 
+                // After sorting and removing duplicates, ways that are
+                // in more than one ring are in more than one entry.
+                std::sort(m_way_rings.begin(), m_way_rings.end());
+                m_way_rings.erase(std::unique(m_way_rings.begin(), m_way_rings.end()), m_way_rings.end());
+
+                m_ways.clear();
+                for (auto it = m_way_rings.cbegin(); it != m_way_rings.cend(); ++it) {
+                    const auto next = std::next(it);
+                    if (next != m_way_rings.cend() && next->first == it->first && (m_ways.empty() || m_ways.back() != it->first)) {
+                        m_ways.push_back(it->first);
                     }
                 }
 
-                for (const osmium::Way* way : ways_in_multiple_rings) {
+                for (const osmium::Way* way : m_ways) {
                     ++m_stats.ways_in_multiple_rings;
                     if (debug()) {
                         std::cerr << "      Way " << way->id() << " is in multiple rings\n";
@@ -508,6 +556,9 @@ namespace osmium {
 
             using rings_stack = std::vector<rings_stack_element>;
 
+            // Scratch space for outer rings found in find_enclosing_ring().
+            rings_stack m_outer_rings;
+
             void remove_duplicates(rings_stack& outer_rings) {
                 while (true) {
                     const auto it = std::adjacent_find(outer_rings.begin(), outer_rings.end());
@@ -535,7 +586,8 @@ namespace osmium {
 
                 int nesting = 0;
 
-                rings_stack outer_rings;
+                rings_stack& outer_rings = m_outer_rings;
+                outer_rings.clear();
                 while (segment >= &m_segment_list.front()) {
                     if (!segment->is_direction_done()) {
                         --segment;
@@ -631,6 +683,20 @@ namespace osmium {
                 }
             }
 
+            /**
+             * Add a new ring starting with the given segment. Re-uses a
+             * spare ring if there is one.
+             */
+            detail::ProtoRing* add_ring(detail::NodeRefSegment* segment) {
+                if (m_spare_rings.empty()) {
+                    m_rings.emplace_back(segment);
+                } else {
+                    m_rings.splice(m_rings.end(), m_spare_rings, m_spare_rings.begin());
+                    m_rings.back().reinitialize(segment);
+                }
+                return &m_rings.back();
+            }
+
             bool is_split_location(const osmium::Location& location) const noexcept {
                 return std::find(m_split_locations.cbegin(), m_split_locations.cend(), location) != m_split_locations.cend();
             }
@@ -650,12 +716,14 @@ namespace osmium {
                 detail::ProtoRing* outer_ring = nullptr;
 
                 if (segment != &m_segment_list.front()) {
+                    osmium::Timer timer_inner_outer;
                     outer_ring = find_enclosing_ring(segment);
+                    timer_inner_outer.stop();
+                    m_stats.time_inner_outer += timer_inner_outer.elapsed_nanoseconds();
                 }
                 segment->mark_direction_done();
 
-                m_rings.emplace_back(segment);
-                detail::ProtoRing* ring = &m_rings.back();
+                detail::ProtoRing* ring = add_ring(segment);
                 if (outer_ring) {
                     if (debug()) {
                         std::cerr << "    This is an inner ring. Outer ring is " << *outer_ring << "\n";
@@ -705,8 +773,7 @@ namespace osmium {
                     segment->reverse();
                 }
 
-                m_rings.emplace_back(segment);
-                detail::ProtoRing* ring = &m_rings.back();
+                detail::ProtoRing* ring = add_ring(segment);
 
                 const osmium::Location& first_location = node.location(m_segment_list);
                 osmium::Location last_location = segment->stop().location();
@@ -760,11 +827,18 @@ namespace osmium {
             }
 
             void find_inner_outer_complex() {
+                osmium::Timer timer_inner_outer;
+                find_inner_outer_complex_impl();
+                timer_inner_outer.stop();
+                m_stats.time_inner_outer += timer_inner_outer.elapsed_nanoseconds();
+            }
+
+            void find_inner_outer_complex_impl() {
                 if (debug()) {
                     std::cerr << "  Finding inner/outer rings\n";
                 }
-                std::vector<detail::ProtoRing*> rings;
-                rings.reserve(m_rings.size());
+                std::vector<detail::ProtoRing*>& rings = m_closed_rings;
+                rings.clear();
                 for (auto& ring : m_rings) {
                     if (ring.closed()) {
                         rings.push_back(&ring);
@@ -876,7 +950,7 @@ namespace osmium {
                     assert(false);
                 }
 
-                m_rings.erase(r2);
+                m_spare_rings.splice(m_spare_rings.end(), m_rings, r2);
                 open_ring_its.remove(r2);
 
                 if (r1->closed()) {
@@ -1176,88 +1250,35 @@ namespace osmium {
              * erase_duplicate_segments step.
              */
             bool ways_were_lost() {
-                std::unordered_set<const osmium::Way*> ways_in_segments;
+                m_ways.clear();
 
                 for (const auto& segment : m_segment_list) {
-                    ways_in_segments.insert(segment.way());
+                    m_ways.push_back(segment.way());
                 }
 
-                return ways_in_segments.size() < m_num_members;
+                std::sort(m_ways.begin(), m_ways.end());
+                const auto num_ways = std::distance(m_ways.begin(), std::unique(m_ways.begin(), m_ways.end()));
+
+                return static_cast<size_t>(num_ways) < m_num_members;
             }
 
             /**
-             * Create rings from segments.
+             * Build rings from the sorted and checked segment list.
              */
-            bool create_rings() {
-                m_stats.nodes += m_segment_list.size();
-
-                // Sort the list of segments (from left to right and bottom
-                // to top).
-                osmium::Timer timer_sort;
-                m_segment_list.sort();
-                timer_sort.stop();
-
-                // Remove duplicate segments. Removal is in pairs, so if there
-                // are two identical segments, they will both be removed. If
-                // there are three, two will be removed and one remains.
-                osmium::Timer timer_dupl;
-                m_stats.duplicate_segments = m_segment_list.erase_duplicate_segments(m_config.problem_reporter);
-                timer_dupl.stop();
-
-                // If there are no segments left at this point, this isn't
-                // a valid area.
-                if (m_segment_list.empty()) {
-                    if (debug()) {
-                        std::cerr << "  No segments left\n";
-                    }
-                    return false;
-                }
-
-                // If one or more complete ways was removed because of
-                // duplicate segments, this isn't a valid area.
-                if (ways_were_lost()) {
-                    if (debug()) {
-                        std::cerr << "  Complete ways removed because of duplicate segments\n";
-                    }
-                    return false;
-                }
-
-                if (m_config.debug_level >= 3) {
-                    std::cerr << "Sorted de-duplicated segment list:\n";
-                    for (const auto& s : m_segment_list) {
-                        std::cerr << "  " << s << "\n";
-                    }
-                }
-
-                // Now we look for segments crossing each other. If there are
-                // any, the multipolygon is invalid.
-                // In the future this could be improved by trying to fix those
-                // cases.
-                osmium::Timer timer_intersection;
-                m_stats.intersections = m_segment_list.find_intersections(m_config.problem_reporter);
-                timer_intersection.stop();
-
-                if (m_stats.intersections) {
-                    return false;
-                }
-
+            bool build_rings() {
                 // This creates an ordered list of locations of both endpoints
                 // of all segments with pointers back to the segments. We will
                 // use this list later to quickly find which segment(s) fits
                 // onto a known segment.
-                osmium::Timer timer_locations_list;
                 create_locations_list();
-                timer_locations_list.stop();
 
                 // Find all locations where more than two segments start or
                 // end. We call those "split" locations. If there are any
                 // "spike" segments found while doing this, we know the area
                 // geometry isn't valid and return.
-                osmium::Timer timer_split;
                 if (!find_split_locations()) {
                     return false;
                 }
-                timer_split.stop();
 
                 // Now report all split locations to the problem reporter.
                 m_stats.touching_rings += m_split_locations.size();
@@ -1284,28 +1305,93 @@ namespace osmium {
                 // whether there were any split locations or not. If there
                 // are no splits, we use the faster "simple algorithm", if
                 // there are, we use the slower "complex algorithm".
-                osmium::Timer timer_simple_case;
-                osmium::Timer timer_complex_case;
                 if (m_split_locations.empty()) {
                     if (debug()) {
                         std::cerr << "  No split locations -> using simple algorithm\n";
                     }
                     ++m_stats.area_simple_case;
 
-                    timer_simple_case.start();
                     create_rings_simple_case();
-                    timer_simple_case.stop();
                 } else {
                     if (debug()) {
                         std::cerr << "  Found split locations -> using complex algorithm\n";
                     }
                     ++m_stats.area_touching_rings_case;
 
-                    timer_complex_case.start();
                     if (!create_rings_complex_case()) {
                         return false;
                     }
-                    timer_complex_case.stop();
+                }
+
+                return true;
+            }
+
+            /**
+             * Create rings from segments.
+             */
+            bool create_rings() {
+                m_stats.nodes += m_segment_list.size();
+
+                // Sort the list of segments (from left to right and bottom
+                // to top).
+                osmium::Timer timer_sort;
+                m_segment_list.sort();
+
+                // Remove duplicate segments. Removal is in pairs, so if there
+                // are two identical segments, they will both be removed. If
+                // there are three, two will be removed and one remains.
+                m_stats.duplicate_segments = m_segment_list.erase_duplicate_segments(m_config.problem_reporter);
+                timer_sort.stop();
+                m_stats.time_extract_segments += timer_sort.elapsed_nanoseconds();
+
+                // If there are no segments left at this point, this isn't
+                // a valid area.
+                if (m_segment_list.empty()) {
+                    if (debug()) {
+                        std::cerr << "  No segments left\n";
+                    }
+                    return false;
+                }
+
+                // If one or more complete ways was removed because of
+                // duplicate segments, this isn't a valid area.
+                if (ways_were_lost()) {
+                    if (debug()) {
+                        std::cerr << "  Complete ways removed because of duplicate segments\n";
+                    }
+                    return false;
+                }
+
+                if (m_config.debug_level >= 3) {
+                    std::cerr << "Sorted de-duplicated segment list:\n";
+                    for (const auto& s : m_segment_list) {
+                        std::cerr << "  " << s << "\n";
+                    }
+                }
+
+                // Now we look for segments crossing each other. If there are
+                // any, the multipolygon is invalid.
+                // In the future this could be improved by trying to fix those
+                // cases.
+                osmium::Timer timer_intersection;
+                m_stats.intersections = m_segment_list.find_intersections(m_config.problem_reporter);
+                timer_intersection.stop();
+                m_stats.time_find_intersections += timer_intersection.elapsed_nanoseconds();
+
+                if (m_stats.intersections) {
+                    return false;
+                }
+
+                // Build the rings. The time spent finding inner and outer
+                // rings is tracked separately, so it is subtracted here.
+                osmium::Timer timer_rings;
+                const uint64_t time_inner_outer = m_stats.time_inner_outer;
+                const bool rings_okay = build_rings();
+                timer_rings.stop();
+                m_stats.time_build_rings += timer_rings.elapsed_nanoseconds() - (m_stats.time_inner_outer - time_inner_outer);
+
+                if (!rings_okay) {
+                    return false;
                 }
 
                 // If the assembler was so configured, now check whether the
@@ -1314,6 +1400,7 @@ namespace osmium {
                     osmium::Timer timer_roles;
                     check_inner_outer_roles();
                     timer_roles.stop();
+                    m_stats.time_inner_outer += timer_roles.elapsed_nanoseconds();
                 }
 
                 m_stats.outer_rings = std::count_if(m_rings.cbegin(), m_rings.cend(), [](const detail::ProtoRing& ring){
@@ -1321,45 +1408,140 @@ namespace osmium {
                 });
                 m_stats.inner_rings = m_rings.size() - m_stats.outer_rings;
 
-#ifdef OSMIUM_WITH_TIMER
-                std::cout << m_stats.nodes << ' ' << m_stats.outer_rings << ' ' << m_stats.inner_rings <<
-                                              ' ' << timer_sort.elapsed_microseconds() <<
-                                              ' ' << timer_dupl.elapsed_microseconds() <<
-                                              ' ' << timer_intersection.elapsed_microseconds() <<
-                                              ' ' << timer_locations_list.elapsed_microseconds() <<
-                                              ' ' << timer_split.elapsed_microseconds();
+                return true;
+            }
 
-                if (m_split_locations.empty()) {
-                    std::cout << ' ' << timer_simple_case.elapsed_microseconds() <<
-                                 " 0";
-                } else {
-                    std::cout << " 0" <<
-                                 ' ' << timer_complex_case.elapsed_microseconds();
+            /**
+             * Ways with up to this many segments are checked for whether
+             * they form a simple valid ring. Most closed ways (buildings
+             * for instance) are small and the checks are quadratic in the
+             * number of segments.
+             */
+            static constexpr const size_t max_segments_in_simple_way = 32;
+
+            /**
+             * Try to create an area from a closed way without going through
+             * the segment list and proto rings. This only works if the way
+             * forms a valid simple ring, ie all locations are valid and
+             * different (except the first and last one which must be the
+             * same node), and there are no intersections between segments.
+             * The area built is exactly the same as the one the full
+             * algorithm would create: The ring starts at the smallest
+             * location and runs counter-clockwise.
+             *
+             * @returns false if the way isn't a simple ring. Nothing has
+             *          been added to the buffer in that case.
+             */
+            bool create_area_from_simple_way(osmium::memory::Buffer& out_buffer, const osmium::Way& way) {
+                const osmium::WayNodeList& nodes = way.nodes();
+                const size_t num_segments = nodes.size() - 1;
+
+                if (num_segments < 3 || num_segments > max_segments_in_simple_way || !way.ends_have_same_id()) {
+                    return false;
+                }
+
+                std::array<osmium::Location, max_segments_in_simple_way> locations;
+                for (size_t i = 0; i < num_segments; ++i) {
+                    if (!nodes[i].location().valid()) {
+                        return false;
+                    }
+                    locations[i] = nodes[i].location();
                 }
 
-                std::cout <<
-# ifdef OSMIUM_AREA_CHECK_INNER_OUTER_ROLES
-                             ' ' << timer_roles.elapsed_microseconds() <<
-# else
-                             " 0" <<
-# endif
-                             '\n';
-#endif
+                const auto locations_end = locations.begin() + num_segments;
+                std::sort(locations.begin(), locations_end);
+                if (std::adjacent_find(locations.begin(), locations_end) != locations_end) {
+                    return false;
+                }
+
+                std::array<detail::NodeRefSegment, max_segments_in_simple_way> segments;
+                int64_t sum = 0;
+                for (size_t i = 0; i < num_segments; ++i) {
+                    segments[i] = detail::NodeRefSegment{nodes[i], nodes[i + 1]};
+                    sum += detail::vec{nodes[i]} * detail::vec{nodes[i + 1]};
+                }
+
+                if (sum == 0) {
+                    return false;
+                }
+
+                for (size_t i = 0; i < num_segments - 1; ++i) {
+                    for (size_t j = i + 1; j < num_segments; ++j) {
+                        const auto& s1 = segments[i];
+                        const auto& s2 = segments[j];
+                        if (!detail::outside_x_range(s1, s2) && !detail::outside_x_range(s2, s1) && detail::y_range_overlap(s1, s2)) {
+                            if (detail::calculate_intersection(s1, s2)) {
+                                return false;
+                            }
+                        }
+                    }
+                }
+
+                size_t start = 0;
+                for (size_t i = 1; i < num_segments; ++i) {
+                    if (nodes[i].location() < nodes[start].location()) {
+                        start = i;
+                    }
+                }
+
+                {
+                    osmium::builder::AreaBuilder builder{out_buffer};
+                    builder.initialize_from_object(way);
+                    add_tags_to_area(builder, way);
+
+                    osmium::builder::OuterRingBuilder ring_builder{builder};
+                    for (size_t i = 0; i <= num_segments; ++i) {
+                        const size_t n = sum > 0 ? start + i : start + num_segments - i;
+                        ring_builder.add_node_ref(nodes[n % num_segments]);
+                    }
+                }
+
+                m_stats.nodes += num_segments;
+                ++m_stats.area_simple_case;
+                m_stats.outer_rings = 1;
+                m_stats.inner_rings = 0;
 
                 return true;
             }
 
-#ifdef OSMIUM_WITH_TIMER
-            static bool print_header() {
-                std::cout << "nodes outer_rings inner_rings sort dupl intersection locations split simple_case complex_case roles_check\n";
-                return true;
+            /**
+             * Clear all data from an earlier call to the assembler. The
+             * memory allocated is kept for re-use.
+             */
+            void reset() {
+                m_segment_list.clear();
+                m_spare_rings.splice(m_spare_rings.end(), m_rings);
+                m_locations.clear();
+                m_split_locations.clear();
+                m_stats = area_stats{};
+                m_num_members = 0;
+            }
+
+            uint64_t scratch_memory() const noexcept {
+                uint64_t memory = m_segment_list.capacity() * sizeof(detail::NodeRefSegment) +
+                                  m_locations.capacity() * sizeof(slocation) +
+                                  m_split_locations.capacity() * sizeof(osmium::Location) +
+                                  m_ways.capacity() * sizeof(const osmium::Way*) +
+                                  m_way_rings.capacity() * sizeof(std::pair<const osmium::Way*, const detail::ProtoRing*>) +
+                                  m_tags.capacity() * sizeof(std::pair<const char*, const char*>) +
+                                  m_closed_rings.capacity() * sizeof(detail::ProtoRing*) +
+                                  m_ways_that_should_be_areas.capacity() * sizeof(const osmium::Way*) +
+                                  m_outer_rings.capacity() * sizeof(rings_stack_element);
+
+                for (const auto& ring : m_rings) {
+                    memory += ring.used_memory();
+                }
+                for (const auto& ring : m_spare_rings) {
+                    memory += ring.used_memory();
+                }
+
+                return memory;
             }
 
-            static bool init_header() {
-                static bool printed_print_header = print_header();
-                return printed_print_header;
+            void update_scratch_memory_stats() {
+                m_max_scratch_memory = std::max(m_max_scratch_memory, scratch_memory());
+                m_stats.max_scratch_memory = m_max_scratch_memory;
             }
-#endif
 
             bool create_area(osmium::memory::Buffer& out_buffer, const osmium::Way& way) {
                 osmium::builder::AreaBuilder builder{out_buffer};
@@ -1409,9 +1591,6 @@ namespace osmium {
             explicit Assembler(const config_type& config) :
                 m_config(config),
                 m_segment_list(config.debug_level > 1) {
-#ifdef OSMIUM_WITH_TIMER
-                init_header();
-#endif
             }
 
             ~Assembler() noexcept = default;
@@ -1421,6 +1600,8 @@ namespace osmium {
              * The resulting area is put into the out_buffer.
              */
             void operator()(const osmium::Way& way, osmium::memory::Buffer& out_buffer) {
+                reset();
+
                 if (!m_config.create_way_polygons) {
                     return;
                 }
@@ -1448,7 +1629,23 @@ namespace osmium {
                 }
 
                 ++m_stats.from_ways;
+
+                if (m_config.debug_level == 0) {
+                    osmium::Timer timer_simple_way;
+                    const bool simple_way = create_area_from_simple_way(out_buffer, way);
+                    timer_simple_way.stop();
+                    m_stats.time_simple_way += timer_simple_way.elapsed_nanoseconds();
+                    if (simple_way) {
+                        out_buffer.commit();
+                        update_scratch_memory_stats();
+                        return;
+                    }
+                }
+
+                osmium::Timer timer_extract;
                 m_stats.duplicate_nodes += m_segment_list.extract_segments_from_way(m_config.problem_reporter, way);
+                timer_extract.stop();
+                m_stats.time_extract_segments += timer_extract.elapsed_nanoseconds();
 
                 if (m_config.debug_level > 0) {
                     std::cerr << "\nAssembling way " << way.id() << " containing " << m_segment_list.size() << " nodes\n";
@@ -1462,6 +1659,8 @@ namespace osmium {
                     out_buffer.rollback();
                 }
 
+                update_scratch_memory_stats();
+
                 if (debug()) {
                     std::cerr << "Done: " << m_stats << "\n";
                 }
@@ -1493,6 +1692,8 @@ namespace osmium {
             void operator()(const osmium::Relation& relation, const std::vector<const osmium::Way*>& members, osmium::memory::Buffer& out_buffer) {
                 assert(relation.members().size() >= members.size());
 
+                reset();
+
                 if (m_config.problem_reporter) {
                     m_config.problem_reporter->set_object(osmium::item_type::relation, relation.id());
                 }
@@ -1503,7 +1704,10 @@ namespace osmium {
                 }
 
                 ++m_stats.from_relations;
+                osmium::Timer timer_extract;
                 m_stats.duplicate_nodes += m_segment_list.extract_segments_from_ways(m_config.problem_reporter, relation, members);
+                timer_extract.stop();
+                m_stats.time_extract_segments += timer_extract.elapsed_nanoseconds();
                 m_stats.member_ways = members.size();
 
                 if (m_stats.member_ways == 1) {
@@ -1535,9 +1739,9 @@ namespace osmium {
                 // tags. If they are not the same as the tags of the area we
                 // just built, add them to a list and later build areas for
                 // them, too.
-                std::vector<const osmium::Way*> ways_that_should_be_areas;
+                m_ways_that_should_be_areas.clear();
                 if (m_stats.wrong_role == 0) {
-                    detail::for_each_member(relation, members, [this, &ways_that_should_be_areas, &area_tags](const osmium::RelationMember& member, const osmium::Way& way) {
+                    detail::for_each_member(relation, members, [this, &area_tags](const osmium::RelationMember& member, const osmium::Way& way) {
                         if (!std::strcmp(member.role(), "inner")) {
                             if (!way.nodes().empty() && way.is_closed() && way.tags().size() > 0) {
                                 const auto d = std::count_if(way.tags().cbegin(), way.tags().cend(), filter());
@@ -1548,7 +1752,7 @@ namespace osmium {
                                     osmium::tags::KeyFilter::iterator area_fi_end(filter(), area_tags.cend(), area_tags.cend());
 
                                     if (!std::equal(way_fi_begin, way_fi_end, area_fi_begin) || d != std::distance(area_fi_begin, area_fi_end)) {
-                                        ways_that_should_be_areas.push_back(&way);
+                                        m_ways_that_should_be_areas.push_back(&way);
                                     } else {
                                         ++m_stats.inner_with_same_tags;
                                         if (m_config.problem_reporter) {
@@ -1561,20 +1765,27 @@ namespace osmium {
                     });
                 }
 
+                update_scratch_memory_stats();
+
                 if (debug()) {
                     std::cerr << "Done: " << m_stats << "\n";
                 }
 
                 // Now build areas for all ways found in the last step.
-                for (const osmium::Way* way : ways_that_should_be_areas) {
-                    Assembler assembler(m_config);
-                    assembler(*way, out_buffer);
+                if (!m_ways_that_should_be_areas.empty() && !m_way_assembler) {
+                    m_way_assembler.reset(new Assembler{m_config});
+                }
+                for (const osmium::Way* way : m_ways_that_should_be_areas) {
+                    (*m_way_assembler)(*way, out_buffer);
                 }
             }
 
             /**
              * Get statistics from assembler. Call this after running the
-             * assembler to get statistics and data about errors.
+             * assembler to get statistics and data about errors. The
+             * statistics are for the last area assembled only, except for
+             * max_scratch_memory which is the high-water mark over all
+             * areas assembled by this Assembler object.
              */
             const osmium::area::area_stats& stats() const noexcept {
                 return m_stats;
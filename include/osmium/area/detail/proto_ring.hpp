@@ -35,9 +35,9 @@ DEALINGS IN THE SOFTWARE.
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
-#include <set>
 #include <vector>
 
 #include <osmium/osm/location.hpp>
@@ -90,6 +90,20 @@ namespace osmium {
                     add_segment_back(segment);
                 }
 
+                /**
+                 * Re-initialize this ring so that it only contains the
+                 * given segment. Used when re-using ProtoRing objects,
+                 * the memory allocated for the segments is kept.
+                 */
+                void reinitialize(NodeRefSegment* segment) {
+                    m_segments.clear();
+                    m_inner.clear();
+                    m_min_segment = segment;
+                    m_outer_ring = nullptr;
+                    m_sum = 0;
+                    add_segment_back(segment);
+                }
+
                 void add_segment_back(NodeRefSegment* segment) {
                     assert(segment);
                     if (*segment < *m_min_segment) {
@@ -180,12 +194,27 @@ namespace osmium {
                     });
                 }
 
-                void get_ways(std::set<const osmium::Way*>& ways) const {
+                /**
+                 * Add the ways of all segments in this ring to the vector.
+                 * Ways will be added once for each segment, so there can
+                 * be duplicates in the result.
+                 */
+                void get_ways(std::vector<const osmium::Way*>& ways) const {
                     for (const auto& segment : m_segments) {
-                        ways.insert(segment->way());
+                        ways.push_back(segment->way());
                     }
                 }
 
+                /**
+                 * The amount of memory (in bytes) used by this ring
+                 * including the memory allocated for the segment pointers.
+                 */
+                size_t used_memory() const noexcept {
+                    return sizeof(ProtoRing) +
+                           m_segments.capacity() * sizeof(NodeRefSegment*) +
+                           m_inner.capacity() * sizeof(ProtoRing*);
+                }
+
                 void join_forward(ProtoRing& other) {
                     for (NodeRefSegment* segment : other.m_segments) {
                         add_segment_back(segment);
@@ -156,6 +156,20 @@ namespace osmium {
                     return m_segments.empty();
                 }
 
+                /// The number of segments the list can hold without allocating.
+                size_t capacity() const noexcept {
+                    return m_segments.capacity();
+                }
+
+                /**
+                 * Remove all segments from the list. The memory allocated
+                 * for the segments is kept, so the list can be re-used
+                 * without allocating.
+                 */
+                void clear() noexcept {
+                    m_segments.clear();
+                }
+
                 using const_iterator = slist_type::const_iterator;
                 using iterator = slist_type::iterator;
 
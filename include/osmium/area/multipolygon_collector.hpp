@@ -34,8 +34,12 @@ DEALINGS IN THE SOFTWARE.
 */
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstring>
+#include <deque>
+#include <future>
+#include <utility>
 #include <vector>
 
 #include <osmium/area/stats.hpp>
@@ -47,6 +51,7 @@ DEALINGS IN THE SOFTWARE.
 #include <osmium/osm/tag.hpp>
 #include <osmium/osm/way.hpp>
 #include <osmium/relations/collector.hpp>
+#include <osmium/thread/pool.hpp>
 
 namespace osmium {
 
@@ -59,6 +64,49 @@ namespace osmium {
      */
     namespace area {
 
+        namespace detail {
+
+            /**
+             * Areas assembled from a batch of ways together with the
+             * statistics from assembling them.
+             */
+            struct assembled_way_batch {
+                osmium::memory::Buffer buffer;
+                osmium::area::area_stats stats;
+            };
+
+            /**
+             * Function object assembling areas from all ways in a buffer.
+             * Used by the MultipolygonCollector to assemble batches of
+             * closed ways on the thread pool.
+             */
+            template <typename TAssembler>
+            class WayBatchAssembler {
+
+                typename TAssembler::config_type m_config;
+                osmium::memory::Buffer m_ways;
+
+            public:
+
+                WayBatchAssembler(const typename TAssembler::config_type& config, osmium::memory::Buffer&& ways) :
+                    m_config(config),
+                    m_ways(std::move(ways)) {
+                }
+
+                assembled_way_batch operator()() {
+                    assembled_way_batch result{osmium::memory::Buffer{m_ways.committed() * 2, osmium::memory::Buffer::auto_grow::yes}, {}};
+                    TAssembler assembler(m_config);
+                    for (const auto& way : m_ways.select<osmium::Way>()) {
+                        assembler(way, result.buffer);
+                        result.stats += assembler.stats();
+                    }
+                    return result;
+                }
+
+            }; // class WayBatchAssembler
+
+        } // namespace detail
+
         /**
          * This class collects all data needed for creating areas from
          * relations tagged with type=multipolygon or type=boundary.
@@ -66,7 +114,16 @@ namespace osmium {
          * osmium::relations::Collector.
          *
          * The actual assembling of the areas is done by the assembler
-         * class given as template argument.
+         * class given as template argument. The same assembler object is
+         * used for all areas, so it must support being called repeatedly.
+         *
+         * Areas from closed ways that are not in any multipolygon relation
+         * are independent of each other. If enabled with
+         * set_parallel_way_assembly(), those ways are collected in batches
+         * and assembled on the thread pool. The areas created from those
+         * ways are then returned in the order of the ways in the input,
+         * but not necessarily in their original order relative to areas
+         * created from relations.
          *
          * @tparam TAssembler Multipolygon Assembler class.
          */
@@ -78,12 +135,70 @@ namespace osmium {
             using assembler_config_type = typename TAssembler::config_type;
             const assembler_config_type m_assembler_config;
 
+            TAssembler m_assembler;
+
+            // Member ways of the relation currently being assembled.
+            std::vector<const osmium::Way*> m_member_ways;
+
             osmium::memory::Buffer m_output_buffer;
 
             osmium::area::area_stats m_stats;
 
+            // Closed ways collected for assembly on the thread pool.
+            osmium::memory::Buffer m_way_batch;
+
+            // Results from the way batches in the order they were submitted.
+            std::deque<std::future<detail::assembled_way_batch>> m_way_batch_results;
+
+            bool m_parallel_way_assembly = false;
+
             static constexpr size_t initial_output_buffer_size = 1024 * 1024;
             static constexpr size_t max_buffer_size_for_flush = 100 * 1024;
+            static constexpr size_t max_way_batch_size = 256 * 1024;
+            static constexpr size_t max_way_batches_in_flight = 32;
+
+            void add_way_batch_result(detail::assembled_way_batch&& result) {
+                m_stats += result.stats;
+                if (result.buffer.committed() > 0) {
+                    m_output_buffer.add_buffer(result.buffer);
+                    m_output_buffer.commit();
+                    possibly_flush_output_buffer();
+                }
+            }
+
+            /**
+             * Move the results of all finished way batches (or of all way
+             * batches if wait is set) into the output buffer. Keeps the
+             * order in which the batches were submitted.
+             */
+            void collect_way_batch_results(bool wait) {
+                while (!m_way_batch_results.empty()) {
+                    auto& future = m_way_batch_results.front();
+                    if (!wait && future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                        return;
+                    }
+                    add_way_batch_result(future.get());
+                    m_way_batch_results.pop_front();
+                }
+            }
+
+            void submit_way_batch() {
+                if (m_way_batch.committed() == 0) {
+                    return;
+                }
+
+                osmium::memory::Buffer batch{initial_output_buffer_size, osmium::memory::Buffer::auto_grow::yes};
+                using std::swap;
+                swap(batch, m_way_batch);
+
+                m_way_batch_results.push_back(osmium::thread::Pool::instance().submit(detail::WayBatchAssembler<TAssembler>{m_assembler_config, std::move(batch)}));
+
+                if (m_way_batch_results.size() > max_way_batches_in_flight) {
+                    add_way_batch_result(m_way_batch_results.front().get());
+                    m_way_batch_results.pop_front();
+                }
+                collect_way_batch_results(false);
+            }
 
             void flush_output_buffer() {
                 if (this->callback()) {
@@ -105,13 +220,31 @@ namespace osmium {
             explicit MultipolygonCollector(const assembler_config_type& assembler_config) :
                 collector_type(),
                 m_assembler_config(assembler_config),
-                m_output_buffer(initial_output_buffer_size, osmium::memory::Buffer::auto_grow::yes) {
+                m_assembler(m_assembler_config),
+                m_member_ways(),
+                m_output_buffer(initial_output_buffer_size, osmium::memory::Buffer::auto_grow::yes),
+                m_way_batch(initial_output_buffer_size, osmium::memory::Buffer::auto_grow::yes),
+                m_way_batch_results() {
             }
 
             const osmium::area::area_stats& stats() const noexcept {
                 return m_stats;
             }
 
+            /**
+             * Enable or disable assembly of areas from closed ways on the
+             * thread pool. Disabled by default.
+             *
+             * The assembler configuration must not contain a problem
+             * reporter or enable debug output, because those are not
+             * thread safe. If it does, this setting is ignored.
+             */
+            void set_parallel_way_assembly(bool parallel = true) noexcept {
+                m_parallel_way_assembly = parallel &&
+                                          !m_assembler_config.problem_reporter &&
+                                          m_assembler_config.debug_level == 0;
+            }
+
             /**
              * We are interested in all relations tagged with type=multipolygon
              * or type=boundary.
@@ -158,9 +291,16 @@ namespace osmium {
                     }
                     if (way.ends_have_same_location()) {
                         // way is closed and has enough nodes, build simple multipolygon
-                        TAssembler assembler(m_assembler_config);
-                        assembler(way, m_output_buffer);
-                        m_stats += assembler.stats();
+                        if (m_parallel_way_assembly) {
+                            m_way_batch.add_item(way);
+                            m_way_batch.commit();
+                            if (m_way_batch.committed() > max_way_batch_size) {
+                                submit_way_batch();
+                            }
+                            return;
+                        }
+                        m_assembler(way, m_output_buffer);
+                        m_stats += m_assembler.stats();
                         possibly_flush_output_buffer();
                     }
                 } catch (const osmium::invalid_location&) {
@@ -172,18 +312,17 @@ namespace osmium {
                 const osmium::Relation& relation = this->get_relation(relation_meta);
                 const osmium::memory::Buffer& buffer = this->members_buffer();
 
-                std::vector<const osmium::Way*> ways;
+                m_member_ways.clear();
                 for (const auto& member : relation.members()) {
                     if (member.ref() != 0) {
                         const size_t offset = this->get_offset(member.type(), member.ref());
-                        ways.push_back(&buffer.get<const osmium::Way>(offset));
+                        m_member_ways.push_back(&buffer.get<const osmium::Way>(offset));
                     }
                 }
 
                 try {
-                    TAssembler assembler(m_assembler_config);
-                    assembler(relation, ways, m_output_buffer);
-                    m_stats += assembler.stats();
+                    m_assembler(relation, m_member_ways, m_output_buffer);
+                    m_stats += m_assembler.stats();
                     possibly_flush_output_buffer();
                 } catch (const osmium::invalid_location&) {
                     // XXX ignore
@@ -191,10 +330,15 @@ namespace osmium {
             }
 
             void flush() {
+                submit_way_batch();
+                collect_way_batch_results(true);
                 flush_output_buffer();
             }
 
             osmium::memory::Buffer read() {
+                submit_way_batch();
+                collect_way_batch_results(true);
+
                 osmium::memory::Buffer buffer(initial_output_buffer_size, osmium::memory::Buffer::auto_grow::yes);
 
                 using std::swap;
@@ -33,6 +33,7 @@ DEALINGS IN THE SOFTWARE.
 
 */
 
+#include <algorithm>
 #include <cstdint>
 #include <ostream>
 
@@ -45,6 +46,14 @@ namespace osmium {
          * tell the user of the assembler a lot about the objects this area
          * is made out of, what happened during the assembly, and what errors
          * there were.
+         *
+         * When adding up statistics, all counters are summed up, except
+         * for max_scratch_memory, where the maximum is kept.
+         *
+         * The time_* fields contain the time (in nanoseconds) spent in
+         * the different phases of the assembly. They are only filled in
+         * if libosmium was compiled with OSMIUM_WITH_TIMER defined,
+         * otherwise they are always 0.
          */
         struct area_stats {
             uint64_t area_really_complex_case = 0; ///< Most difficult case with rings touching in multiple points
@@ -57,6 +66,7 @@ namespace osmium {
             uint64_t inner_rings = 0; ///< Number of inner rings
             uint64_t inner_with_same_tags = 0; ///< Number of inner ways with same tags as area
             uint64_t intersections = 0; ///< Number of intersections between segments
+            uint64_t max_scratch_memory = 0; ///< High-water mark of memory (in bytes) used by the assembler for its working data
             uint64_t member_ways = 0; ///< Number of ways in the area
             uint64_t no_tags_on_relation = 0; ///< No tags on relation (old-style multipolygon with tags on outer ways)
             uint64_t no_way_in_mp_relation = 0; ///< Multipolygon relation with no way members
@@ -65,6 +75,11 @@ namespace osmium {
             uint64_t outer_rings = 0; ///< Number of outer rings in the area
             uint64_t short_ways = 0; ///< Number of ways with less than two nodes
             uint64_t single_way_in_mp_relation = 0; ///< Multipolygon relation containing a single way
+            uint64_t time_build_rings = 0; ///< Time spent building the rings (without time_inner_outer)
+            uint64_t time_extract_segments = 0; ///< Time spent extracting, sorting and de-duplicating segments
+            uint64_t time_find_intersections = 0; ///< Time spent looking for intersecting segments
+            uint64_t time_inner_outer = 0; ///< Time spent finding out which rings are inner or outer rings and checking roles
+            uint64_t time_simple_way = 0; ///< Time spent in the fast path for simple closed ways (which skips all other phases if successful)
             uint64_t touching_rings = 0; ///< Rings touching in a node
             uint64_t ways_in_multiple_rings = 0; ///< Different segments of a way ended up in different rings
             uint64_t wrong_role = 0; ///< Member has wrong role (not "outer", "inner", or empty)
@@ -80,6 +95,7 @@ namespace osmium {
                 inner_rings += other.inner_rings;
                 inner_with_same_tags += other.inner_with_same_tags;
                 intersections += other.intersections;
+                max_scratch_memory = std::max(max_scratch_memory, other.max_scratch_memory);
                 member_ways += other.member_ways;
                 no_tags_on_relation += other.no_tags_on_relation;
                 no_way_in_mp_relation += other.no_way_in_mp_relation;
@@ -88,6 +104,11 @@ namespace osmium {
                 outer_rings += other.outer_rings;
                 short_ways += other.short_ways;
                 single_way_in_mp_relation += other.single_way_in_mp_relation;
+                time_build_rings += other.time_build_rings;
+                time_extract_segments += other.time_extract_segments;
+                time_find_intersections += other.time_find_intersections;
+                time_inner_outer += other.time_inner_outer;
+                time_simple_way += other.time_simple_way;
                 touching_rings += other.touching_rings;
                 ways_in_multiple_rings += other.ways_in_multiple_rings;
                 wrong_role += other.wrong_role;
@@ -108,6 +129,7 @@ namespace osmium {
                        << " inner_rings=" << s.inner_rings
                        << " inner_with_same_tags=" << s.inner_with_same_tags
                        << " intersections=" << s.intersections
+                       << " max_scratch_memory=" << s.max_scratch_memory
                        << " member_ways=" << s.member_ways
                        << " no_tags_on_relation=" << s.no_tags_on_relation
                        << " no_way_in_mp_relation=" << s.no_way_in_mp_relation
@@ -116,6 +138,11 @@ namespace osmium {
                        << " outer_rings=" << s.outer_rings
                        << " short_ways=" << s.short_ways
                        << " single_way_in_mp_relation=" << s.single_way_in_mp_relation
+                       << " time_build_rings=" << s.time_build_rings
+                       << " time_extract_segments=" << s.time_extract_segments
+                       << " time_find_intersections=" << s.time_find_intersections
+                       << " time_inner_outer=" << s.time_inner_outer
+                       << " time_simple_way=" << s.time_simple_way
                        << " touching_rings=" << s.touching_rings
                        << " ways_in_multiple_rings=" << s.ways_in_multiple_rings
                        << " wrong_role=" << s.wrong_role;
@@ -0,0 +1,227 @@
+#ifndef OSMIUM_CHANGE_APPLIER_HPP
+#define OSMIUM_CHANGE_APPLIER_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <osmium/io/file.hpp>
+#include <osmium/io/reader.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/entity_bits.hpp>
+#include <osmium/osm/item_type.hpp>
+#include <osmium/osm/object.hpp>
+#include <osmium/osm/object_comparisons.hpp>
+#include <osmium/osm/types.hpp>
+
+namespace osmium {
+
+    /**
+     * Applies changes (usually from one or more OSM change files) to an
+     * OSM data file ("snapshot") creating a new snapshot. This is done
+     * in a single pass over the input snapshot, only the changes are kept
+     * in memory.
+     *
+     * The input snapshot must be sorted by type, id, and version as OSM
+     * files usually are and it must contain only one version of each
+     * object. The changes can be in any order, they are sorted before
+     * being applied. If there are several versions of an object in the
+     * changes, the one with the highest version is used. Deleted objects
+     * are removed from the output.
+     *
+     * @code
+     *   osmium::ChangeApplier applier;
+     *   applier.read_changes(osmium::io::File{"changes.osc.gz"});
+     *   osmium::io::Reader reader{"input.osm.pbf"};
+     *   osmium::io::Writer writer{"output.osm.pbf", reader.header()};
+     *   applier.apply(reader, writer);
+     *   writer.close();
+     *   reader.close();
+     * @endcode
+     */
+    class ChangeApplier {
+
+        // Buffers returned by apply() will be about this size.
+        static constexpr const size_t buffer_size = 1024 * 1024;
+
+        // The buffers containing the changes.
+        std::vector<osmium::memory::Buffer> m_buffers;
+
+        // Pointers to all changes. After prepare() they are sorted and
+        // only the newest version of each object is kept.
+        std::vector<const osmium::OSMObject*> m_changes;
+
+        bool m_prepared = false;
+
+        template <typename TOutput>
+        class output_buffer {
+
+            TOutput& m_output;
+            osmium::memory::Buffer m_buffer;
+
+            // Type and id of the last object handled. All older versions
+            // of the same object are ignored.
+            osmium::item_type m_last_type = osmium::item_type::undefined;
+            osmium::object_id_type m_last_id = 0;
+
+        public:
+
+            explicit output_buffer(TOutput& output) :
+                m_output(output),
+                m_buffer(buffer_size, osmium::memory::Buffer::auto_grow::yes) {
+            }
+
+            void add(const osmium::OSMObject& object) {
+                if (object.type() == m_last_type && object.id() == m_last_id) {
+                    return;
+                }
+                m_last_type = object.type();
+                m_last_id = object.id();
+
+                if (!object.visible()) {
+                    return;
+                }
+                m_buffer.add_item(object);
+                m_buffer.commit();
+                if (m_buffer.committed() >= buffer_size) {
+                    flush();
+                }
+            }
+
+            void flush() {
+                if (m_buffer.committed() > 0) {
+                    m_output(std::move(m_buffer));
+                    m_buffer = osmium::memory::Buffer{buffer_size, osmium::memory::Buffer::auto_grow::yes};
+                }
+            }
+
+        }; // class output_buffer
+
+    public:
+
+        ChangeApplier() = default;
+
+        /**
+         * Add all OSM objects in the buffer to the changes. The applier
+         * takes ownership of the buffer.
+         */
+        void add_changes(osmium::memory::Buffer&& buffer) {
+            m_buffers.push_back(std::move(buffer));
+            for (const auto& object : m_buffers.back().select<osmium::OSMObject>()) {
+                m_changes.push_back(&object);
+            }
+            m_prepared = false;
+        }
+
+        /**
+         * Read the changes from the given file. This is usually an OSM
+         * change file, but it can be any OSM file.
+         *
+         * @throws Some form of osmium::io_error if there is an error.
+         */
+        void read_changes(const osmium::io::File& file) {
+            osmium::io::Reader reader{file, osmium::osm_entity_bits::nwr};
+            while (osmium::memory::Buffer buffer = reader.read()) {
+                add_changes(std::move(buffer));
+            }
+            reader.close();
+        }
+
+        /**
+         * The number of changes. After prepare() this is the number of
+         * different objects changed.
+         */
+        size_t num_changes() const noexcept {
+            return m_changes.size();
+        }
+
+        /**
+         * Sort the changes and remove all but the newest version of each
+         * object. This is called automatically by apply() if needed.
+         */
+        void prepare() {
+            std::stable_sort(m_changes.begin(), m_changes.end(), osmium::object_order_type_id_reverse_version{});
+            const auto last = std::unique(m_changes.begin(), m_changes.end(), osmium::object_equal_type_id{});
+            m_changes.erase(last, m_changes.end());
+            m_prepared = true;
+        }
+
+        /**
+         * Apply the changes to the objects read from source and send the
+         * resulting objects to output.
+         *
+         * Objects in the changes replace objects in the source with the
+         * same type and id if their version is the same or larger. Objects
+         * which are deleted in the changes are not written out.
+         *
+         * @param source Anything with a read() function returning a
+         *               Buffer with an invalid buffer signalling the end
+         *               of the data (such as osmium::io::Reader).
+         * @param output Callable taking a Buffer&& (such as
+         *               osmium::io::Writer). It will be called with buffers
+         *               of about 1MB.
+         */
+        template <typename TSource, typename TOutput>
+        void apply(TSource& source, TOutput& output) {
+            if (!m_prepared) {
+                prepare();
+            }
+
+            const osmium::object_order_type_id_reverse_version order;
+            output_buffer<TOutput> out{output};
+
+            auto change = m_changes.cbegin();
+            while (osmium::memory::Buffer buffer = source.read()) {
+                for (const auto& object : buffer.select<osmium::OSMObject>()) {
+                    for (; change != m_changes.cend() && !order(object, **change); ++change) {
+                        out.add(**change);
+                    }
+                    out.add(object);
+                }
+            }
+
+            for (; change != m_changes.cend(); ++change) {
+                out.add(**change);
+            }
+
+            out.flush();
+        }
+
+    }; // class ChangeApplier
+
+} // namespace osmium
+
+#endif // OSMIUM_CHANGE_APPLIER_HPP
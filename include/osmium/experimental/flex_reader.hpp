@@ -54,6 +54,15 @@ namespace osmium {
      */
     namespace experimental {
 
+        /**
+         * Reader that can optionally assemble areas while reading. Nodes
+         * and ways are read from the main input file, the relations needed
+         * for multipolygon assembly are read in a separate first pass. By
+         * default that first pass reads the main input file again, but you
+         * can give the name of a (much smaller) file containing only the
+         * relations instead. In that case the main input file is only read
+         * once.
+         */
         template <typename TLocationHandler>
         class FlexReader {
 
@@ -68,7 +77,23 @@ namespace osmium {
 
         public:
 
-            explicit FlexReader(const osmium::io::File& file, TLocationHandler& location_handler, osmium::osm_entity_bits::type entities = osmium::osm_entity_bits::nwr) :
+            /**
+             * Create FlexReader reading the relations needed for area
+             * assembly from a separate file.
+             *
+             * @param file The main input file.
+             * @param relations_file File containing (at least) all the
+             *                       multipolygon relations in the main
+             *                       input file. Only relations are read
+             *                       from this file, so it can be a
+             *                       relations-only extract of the main
+             *                       file. It is not read at all if no
+             *                       areas are requested.
+             * @param location_handler Handler used to add locations to
+             *                         the way nodes.
+             * @param entities Which entities should be returned by read().
+             */
+            FlexReader(const osmium::io::File& file, const osmium::io::File& relations_file, TLocationHandler& location_handler, osmium::osm_entity_bits::type entities = osmium::osm_entity_bits::nwr) :
                 m_with_areas((entities & osmium::osm_entity_bits::area) != 0),
                 m_entities((entities & ~osmium::osm_entity_bits::area) | (m_with_areas ? osmium::osm_entity_bits::node | osmium::osm_entity_bits::way : osmium::osm_entity_bits::nothing)),
                 m_location_handler(location_handler),
@@ -78,12 +103,20 @@ namespace osmium {
             {
                 m_location_handler.ignore_errors();
                 if (m_with_areas) {
-                    osmium::io::Reader reader(file, osmium::osm_entity_bits::relation);
+                    osmium::io::Reader reader(relations_file, osmium::osm_entity_bits::relation);
                     m_collector.read_relations(reader);
                     reader.close();
                 }
             }
 
+            explicit FlexReader(const osmium::io::File& file, TLocationHandler& location_handler, osmium::osm_entity_bits::type entities = osmium::osm_entity_bits::nwr) :
+                FlexReader(file, file, location_handler, entities) {
+            }
+
+            FlexReader(const std::string& filename, const std::string& relations_filename, TLocationHandler& location_handler, osmium::osm_entity_bits::type entities = osmium::osm_entity_bits::nwr) :
+                FlexReader(osmium::io::File(filename), osmium::io::File(relations_filename), location_handler, entities) {
+            }
+
             explicit FlexReader(const std::string& filename, TLocationHandler& location_handler, osmium::osm_entity_bits::type entities = osmium::osm_entity_bits::nwr) :
                 FlexReader(osmium::io::File(filename), location_handler, entities) {
             }
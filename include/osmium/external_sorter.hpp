@@ -0,0 +1,378 @@
+#ifndef OSMIUM_EXTERNAL_SORTER_HPP
+#define OSMIUM_EXTERNAL_SORTER_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#ifndef _MSC_VER
+# include <unistd.h>
+#else
+# include <io.h>
+#endif
+
+#include <osmium/handler.hpp>
+#include <osmium/index/detail/tmpfile.hpp>
+#include <osmium/io/detail/read_write.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/object.hpp>
+#include <osmium/osm/object_comparisons.hpp>
+
+namespace osmium {
+
+    namespace detail {
+
+        /**
+         * A sorted run of OSM objects in a temporary file. The file is
+         * made up of chunks, each containing the data of a buffer. The
+         * chunks are read back one after the other.
+         */
+        class sorted_run {
+
+            int m_fd;
+            std::vector<size_t> m_chunk_sizes;
+            size_t m_next_chunk = 0;
+            osmium::memory::Buffer m_buffer;
+            osmium::memory::Buffer::t_const_iterator<osmium::OSMObject> m_it;
+            osmium::memory::Buffer::t_const_iterator<osmium::OSMObject> m_end;
+
+            bool read_next_chunk() {
+                while (m_next_chunk < m_chunk_sizes.size()) {
+                    const size_t size = m_chunk_sizes[m_next_chunk++];
+                    if (m_buffer.capacity() < size) {
+                        m_buffer = osmium::memory::Buffer{size, osmium::memory::Buffer::auto_grow::no};
+                    } else {
+                        m_buffer.clear();
+                    }
+                    osmium::io::detail::reliable_read(m_fd, m_buffer.reserve_space(size), size);
+                    m_buffer.commit();
+                    m_it = m_buffer.cbegin<osmium::OSMObject>();
+                    m_end = m_buffer.cend<osmium::OSMObject>();
+                    if (m_it != m_end) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+        public:
+
+            sorted_run() :
+                m_fd(osmium::detail::create_tmp_file()) {
+            }
+
+            sorted_run(const sorted_run&) = delete;
+            sorted_run& operator=(const sorted_run&) = delete;
+
+            sorted_run(sorted_run&& other) :
+                m_fd(other.m_fd),
+                m_chunk_sizes(std::move(other.m_chunk_sizes)),
+                m_next_chunk(other.m_next_chunk),
+                m_buffer(std::move(other.m_buffer)),
+                m_it(other.m_it),
+                m_end(other.m_end) {
+                other.m_fd = -1;
+            }
+
+            sorted_run& operator=(sorted_run&&) = delete;
+
+            ~sorted_run() noexcept {
+                if (m_fd >= 0) {
+                    ::close(m_fd);
+                }
+            }
+
+            void write_chunk(const osmium::memory::Buffer& buffer) {
+                if (buffer.committed() > 0) {
+                    osmium::io::detail::reliable_write(m_fd, buffer.data(), buffer.committed());
+                    m_chunk_sizes.push_back(buffer.committed());
+                }
+            }
+
+            /**
+             * Start reading the run from the beginning.
+             *
+             * @returns false if the run is empty.
+             */
+            bool start_reading() {
+#ifdef _MSC_VER
+                _lseeki64(m_fd, 0, SEEK_SET);
+#else
+                ::lseek(m_fd, 0, SEEK_SET);
+#endif
+                m_next_chunk = 0;
+                return read_next_chunk();
+            }
+
+            /// The current object. Only valid if the run is not exhausted.
+            const osmium::OSMObject& current() const {
+                assert(m_it != m_end);
+                return *m_it;
+            }
+
+            /**
+             * Go to the next object.
+             *
+             * @returns false if there are no more objects.
+             */
+            bool next() {
+                ++m_it;
+                return m_it != m_end || read_next_chunk();
+            }
+
+        }; // class sorted_run
+
+    } // namespace detail
+
+    /**
+     * Sorts OSM objects using a limited amount of memory. Objects are
+     * collected in memory until the given limit is reached, then they are
+     * sorted and written out to a temporary file ("run"). When all objects
+     * are added, the runs are merged while reading the objects back.
+     * If all objects fit into memory, no temporary file is used.
+     *
+     * This class implements the visitor pattern, so it can be filled
+     * using osmium::apply(). Objects are read back using read() just
+     * like from an osmium::io::Reader:
+     *
+     * @code
+     *   osmium::ExternalSorter<> sorter{4ul * 1024 * 1024 * 1024};
+     *   osmium::apply(reader, sorter);
+     *   while (osmium::memory::Buffer buffer = sorter.read()) {
+     *       writer(std::move(buffer));
+     *   }
+     * @endcode
+     *
+     * Objects which compare equal are returned in the order they were
+     * added.
+     *
+     * @tparam TCompare Comparison function object for OSM objects (see
+     *                  osm/object_comparisons.hpp). Default is to sort by
+     *                  type, id, and version (as in OSM files).
+     */
+    template <typename TCompare = osmium::object_order_type_id_version>
+    class ExternalSorter : public osmium::handler::Handler {
+
+        // Size of the buffers written to and read from temporary files
+        // and returned by read().
+        static constexpr const size_t chunk_size = 1024 * 1024;
+
+        struct merge_element {
+            const osmium::OSMObject* object;
+            size_t run;
+        };
+
+        struct merge_element_greater {
+
+            TCompare* compare;
+
+            bool operator()(const merge_element& lhs, const merge_element& rhs) const {
+                if ((*compare)(*rhs.object, *lhs.object)) {
+                    return true;
+                }
+                if ((*compare)(*lhs.object, *rhs.object)) {
+                    return false;
+                }
+                return lhs.run > rhs.run;
+            }
+
+        }; // struct merge_element_greater
+
+        size_t m_max_memory;
+        TCompare m_compare;
+
+        // Objects are collected in this buffer, it grows as needed. The
+        // objects are referenced by their offset into the buffer, because
+        // pointers would become invalid when the buffer grows.
+        osmium::memory::Buffer m_buffer;
+        std::vector<size_t> m_objects;
+        std::vector<detail::sorted_run> m_runs;
+
+        std::priority_queue<merge_element, std::vector<merge_element>, merge_element_greater> m_queue;
+
+        // Next object returned from memory if there are no runs.
+        size_t m_next_object = 0;
+
+        bool m_reading = false;
+
+        void sort_objects() {
+            std::stable_sort(m_objects.begin(), m_objects.end(), [this](size_t lhs, size_t rhs) {
+                return m_compare(m_buffer.get<osmium::OSMObject>(lhs), m_buffer.get<osmium::OSMObject>(rhs));
+            });
+        }
+
+        void write_run() {
+            sort_objects();
+
+            m_runs.emplace_back();
+            osmium::memory::Buffer chunk{chunk_size, osmium::memory::Buffer::auto_grow::yes};
+            for (const size_t offset : m_objects) {
+                chunk.add_item(m_buffer.get<osmium::OSMObject>(offset));
+                chunk.commit();
+                if (chunk.committed() >= chunk_size) {
+                    m_runs.back().write_chunk(chunk);
+                    chunk.clear();
+                }
+            }
+            m_runs.back().write_chunk(chunk);
+
+            m_objects.clear();
+            m_buffer.clear();
+        }
+
+        void start_reading() {
+            m_reading = true;
+
+            if (m_runs.empty()) {
+                sort_objects();
+                return;
+            }
+
+            if (!m_objects.empty()) {
+                write_run();
+            }
+            m_buffer = osmium::memory::Buffer{};
+            std::vector<size_t>{}.swap(m_objects);
+
+            for (size_t n = 0; n < m_runs.size(); ++n) {
+                if (m_runs[n].start_reading()) {
+                    m_queue.push(merge_element{&m_runs[n].current(), n});
+                }
+            }
+        }
+
+    public:
+
+        /**
+         * Create a sorter.
+         *
+         * @param max_memory Maximum number of bytes of object data kept in
+         *                   memory. The actual memory use will be somewhat
+         *                   larger.
+         * @param compare Comparison function object.
+         */
+        explicit ExternalSorter(size_t max_memory = 1024ul * 1024 * 1024, TCompare compare = TCompare{}) :
+            m_max_memory(max_memory),
+            m_compare(std::move(compare)),
+            m_buffer(std::min(max_memory, static_cast<size_t>(10 * chunk_size)), osmium::memory::Buffer::auto_grow::yes),
+            m_objects(),
+            m_runs(),
+            m_queue(merge_element_greater{&m_compare}) {
+        }
+
+        ExternalSorter(const ExternalSorter&) = delete;
+        ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+        ExternalSorter(ExternalSorter&&) = delete;
+        ExternalSorter& operator=(ExternalSorter&&) = delete;
+
+        ~ExternalSorter() noexcept = default;
+
+        /**
+         * Add a copy of an object to the sorter. Must not be called after
+         * read() was called.
+         */
+        void osm_object(const osmium::OSMObject& object) {
+            assert(!m_reading);
+            if (m_buffer.committed() + object.padded_size() > m_max_memory && !m_objects.empty()) {
+                write_run();
+            }
+            m_objects.push_back(m_buffer.committed());
+            m_buffer.add_item(object);
+            m_buffer.commit();
+        }
+
+        /**
+         * Add copies of all OSM objects in the buffer to the sorter. Must
+         * not be called after read() was called.
+         */
+        void add(const osmium::memory::Buffer& buffer) {
+            for (const auto& object : buffer.select<osmium::OSMObject>()) {
+                osm_object(object);
+            }
+        }
+
+        /// The number of runs written to temporary files so far.
+        size_t num_runs() const noexcept {
+            return m_runs.size();
+        }
+
+        /**
+         * Read the next buffer of sorted objects. After the first call
+         * no more objects can be added.
+         *
+         * @returns Buffer with objects. An invalid buffer is returned at
+         *          the end of the data.
+         * @throws std::system_error If reading from a temporary file
+         *         failed.
+         */
+        osmium::memory::Buffer read() {
+            if (!m_reading) {
+                start_reading();
+            }
+
+            osmium::memory::Buffer buffer{chunk_size, osmium::memory::Buffer::auto_grow::yes};
+
+            if (m_runs.empty()) {
+                while (m_next_object < m_objects.size() && buffer.committed() < chunk_size) {
+                    buffer.add_item(m_buffer.get<osmium::OSMObject>(m_objects[m_next_object++]));
+                    buffer.commit();
+                }
+            } else {
+                while (!m_queue.empty() && buffer.committed() < chunk_size) {
+                    const merge_element element = m_queue.top();
+                    m_queue.pop();
+                    buffer.add_item(*element.object);
+                    buffer.commit();
+                    if (m_runs[element.run].next()) {
+                        m_queue.push(merge_element{&m_runs[element.run].current(), element.run});
+                    }
+                }
+            }
+
+            if (buffer.committed() == 0) {
+                return osmium::memory::Buffer{};
+            }
+            return buffer;
+        }
+
+    }; // class ExternalSorter
+
+} // namespace osmium
+
+#endif // OSMIUM_EXTERNAL_SORTER_HPP
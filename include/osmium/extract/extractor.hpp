@@ -0,0 +1,335 @@
+#ifndef OSMIUM_EXTRACT_EXTRACTOR_HPP
+#define OSMIUM_EXTRACT_EXTRACTOR_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <osmium/extract/polygon.hpp>
+#include <osmium/index/id_set.hpp>
+#include <osmium/io/writer.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/item_type.hpp>
+#include <osmium/osm/node.hpp>
+#include <osmium/osm/relation.hpp>
+#include <osmium/osm/types.hpp>
+#include <osmium/osm/way.hpp>
+#include <osmium/thread/pool.hpp>
+
+namespace osmium {
+
+    namespace extract {
+
+        namespace detail {
+
+            /**
+             * The polygon, output, and the Ids of the objects in one
+             * extract.
+             */
+            template <typename TIdSet>
+            class extract_data {
+
+                // Output is sent in buffers of about this size.
+                static constexpr const size_t buffer_size = 1024 * 1024;
+
+                osmium::extract::Polygon m_polygon;
+                std::function<void(osmium::memory::Buffer&&)> m_output;
+                osmium::memory::Buffer m_buffer;
+
+                TIdSet m_node_ids;
+                TIdSet m_way_ids;
+                TIdSet m_relation_ids;
+
+                bool way_is_inside(const osmium::Way& way) const {
+                    for (const auto& node_ref : way.nodes()) {
+                        if (m_node_ids.get(node_ref.positive_ref())) {
+                            return true;
+                        }
+                    }
+                    return false;
+                }
+
+                bool relation_is_inside(const osmium::Relation& relation) const {
+                    for (const auto& member : relation.members()) {
+                        switch (member.type()) {
+                            case osmium::item_type::node:
+                                if (m_node_ids.get(member.positive_ref())) {
+                                    return true;
+                                }
+                                break;
+                            case osmium::item_type::way:
+                                if (m_way_ids.get(member.positive_ref())) {
+                                    return true;
+                                }
+                                break;
+                            case osmium::item_type::relation:
+                                if (m_relation_ids.get(member.positive_ref())) {
+                                    return true;
+                                }
+                                break;
+                            default:
+                                break;
+                        }
+                    }
+                    return false;
+                }
+
+                void add(const osmium::OSMObject& object) {
+                    m_buffer.add_item(object);
+                    m_buffer.commit();
+                }
+
+            public:
+
+                extract_data(osmium::extract::Polygon&& polygon, std::function<void(osmium::memory::Buffer&&)>&& output) :
+                    m_polygon(std::move(polygon)),
+                    m_output(std::move(output)),
+                    m_buffer(buffer_size, osmium::memory::Buffer::auto_grow::yes) {
+                }
+
+                void process(const osmium::memory::Buffer& buffer) {
+                    for (const auto& object : buffer.select<osmium::OSMObject>()) {
+                        switch (object.type()) {
+                            case osmium::item_type::node:
+                                if (m_polygon.contains(static_cast<const osmium::Node&>(object).location())) {
+                                    m_node_ids.set(object.positive_id());
+                                    add(object);
+                                }
+                                break;
+                            case osmium::item_type::way:
+                                if (way_is_inside(static_cast<const osmium::Way&>(object))) {
+                                    m_way_ids.set(object.positive_id());
+                                    add(object);
+                                }
+                                break;
+                            case osmium::item_type::relation:
+                                if (relation_is_inside(static_cast<const osmium::Relation&>(object))) {
+                                    m_relation_ids.set(object.positive_id());
+                                    add(object);
+                                }
+                                break;
+                            default:
+                                break;
+                        }
+                    }
+
+                }
+
+                /// Is there enough data in the buffer to send it to the output?
+                bool buffer_full() const noexcept {
+                    return m_buffer.committed() >= buffer_size;
+                }
+
+                void flush() {
+                    if (m_buffer.committed() > 0) {
+                        m_output(std::move(m_buffer));
+                        m_buffer = osmium::memory::Buffer{buffer_size, osmium::memory::Buffer::auto_grow::yes};
+                    }
+                }
+
+            }; // class extract_data
+
+        } // namespace detail
+
+        /**
+         * Creates any number of extracts from OSM data in a single pass.
+         * Each extract is defined by a Polygon and gets its own output
+         * (usually an osmium::io::Writer).
+         *
+         * The input must be sorted with nodes before ways before
+         * relations (as usual in OSM files). An extract contains
+         *
+         * * all nodes inside the polygon,
+         * * all ways with at least one node inside the polygon,
+         * * all relations with at least one member already in the extract.
+         *
+         * Ways are not completed with the nodes outside the polygon and
+         * relations referencing relations later in the input are only
+         * added if they have other members in the extract.
+         *
+         * Each input buffer is processed on the thread pool with one task
+         * per extract, so the point-in-polygon checks for all extracts run
+         * in parallel. The outputs are only called from the calling thread
+         * after all tasks for a buffer are done. The output for each
+         * extract is in the same order as the input.
+         *
+         * @code
+         *   osmium::io::Reader reader{"planet.osm.pbf"};
+         *   osmium::io::Header header = reader.header();
+         *   osmium::io::Writer writer1{"a.osm.pbf", header};
+         *   osmium::io::Writer writer2{"b.osm.pbf", header};
+         *
+         *   osmium::extract::Extractor<> extractor;
+         *   extractor.add_extract(osmium::extract::Polygon{box}, writer1);
+         *   extractor.add_extract(osmium::extract::Polygon{area}, writer2);
+         *   extractor.apply(reader);
+         *
+         *   writer1.close();
+         *   writer2.close();
+         *   reader.close();
+         * @endcode
+         *
+         * @tparam TIdSet Id set used for remembering which objects are in
+         *                each extract. With many extracts of a large input
+         *                osmium::index::IdSetCompressed needs much less
+         *                memory than the default.
+         */
+        template <typename TIdSet = osmium::index::IdSetDense<osmium::unsigned_object_id_type>>
+        class Extractor {
+
+            using extract_type = detail::extract_data<TIdSet>;
+
+            std::vector<std::unique_ptr<extract_type>> m_extracts;
+
+            void flush_full_buffers() {
+                for (auto& e : m_extracts) {
+                    if (e->buffer_full()) {
+                        e->flush();
+                    }
+                }
+            }
+
+        public:
+
+            Extractor() = default;
+
+            /**
+             * Add an extract. The output function is called with a
+             * buffer of objects in the extract whenever enough data
+             * is available. It is always called from the thread calling
+             * operator(), flush(), or apply(), never from a thread pool
+             * thread, so it can use the thread pool itself (like
+             * osmium::io::Writer does).
+             */
+            void add_extract(osmium::extract::Polygon&& polygon, std::function<void(osmium::memory::Buffer&&)> output) {
+                m_extracts.emplace_back(new extract_type{std::move(polygon), std::move(output)});
+            }
+
+            /**
+             * Add an extract written to the given writer. The writer must
+             * be kept alive until flush() or apply() returned.
+             */
+            void add_extract(osmium::extract::Polygon&& polygon, osmium::io::Writer& writer) {
+                add_extract(std::move(polygon), [&writer](osmium::memory::Buffer&& buffer) {
+                    writer(std::move(buffer));
+                });
+            }
+
+            /// The number of extracts.
+            size_t num_extracts() const noexcept {
+                return m_extracts.size();
+            }
+
+            /**
+             * Process all objects in the buffer. Returns after all
+             * extracts are done with this buffer.
+             *
+             * @throws Any exception thrown by an output.
+             */
+            void operator()(const osmium::memory::Buffer& buffer) {
+                if (m_extracts.size() == 1) {
+                    m_extracts.front()->process(buffer);
+                    flush_full_buffers();
+                    return;
+                }
+
+                std::vector<std::future<void>> results;
+                results.reserve(m_extracts.size());
+                try {
+                    for (auto& e : m_extracts) {
+                        extract_type* data = e.get();
+                        results.push_back(osmium::thread::Pool::instance().submit([data, &buffer]() {
+                            data->process(buffer);
+                        }));
+                    }
+                } catch (...) {
+                    for (auto& result : results) {
+                        result.wait();
+                    }
+                    throw;
+                }
+
+                // Wait for all tasks before throwing, they use the buffer.
+                for (auto& result : results) {
+                    result.wait();
+                }
+                for (auto& result : results) {
+                    result.get();
+                }
+
+                // The outputs are called from this thread only. Calling
+                // them from the pool tasks could deadlock if the outputs
+                // use the pool themselves.
+                flush_full_buffers();
+            }
+
+            /**
+             * Send all data still buffered to the outputs. Call this after
+             * the last buffer was processed (apply() does this).
+             *
+             * @throws Any exception thrown by an output.
+             */
+            void flush() {
+                for (auto& e : m_extracts) {
+                    e->flush();
+                }
+            }
+
+            /**
+             * Process all data from the source and flush the outputs.
+             *
+             * @param source Source of buffers, must have a read() function
+             *               returning an osmium::memory::Buffer which is
+             *               invalid at the end of data (such as
+             *               osmium::io::Reader).
+             */
+            template <typename TSource>
+            void apply(TSource& source) {
+                while (osmium::memory::Buffer buffer = source.read()) {
+                    (*this)(buffer);
+                }
+                flush();
+            }
+
+        }; // class Extractor
+
+    } // namespace extract
+
+} // namespace osmium
+
+#endif // OSMIUM_EXTRACT_EXTRACTOR_HPP
@@ -0,0 +1,131 @@
+#ifndef OSMIUM_EXTRACT_GEOJSON_HPP
+#define OSMIUM_EXTRACT_GEOJSON_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <osmium/extract/polygon.hpp>
+#include <osmium/geom/factory.hpp>
+#include <osmium/osm/location.hpp>
+
+namespace osmium {
+
+    namespace extract {
+
+        namespace detail {
+
+            template <typename TJsonValue>
+            inline void add_geojson_ring(std::vector<std::vector<osmium::Location>>& rings, const TJsonValue& ring) {
+                if (!ring.IsArray()) {
+                    throw osmium::geometry_error{"GeoJSON ring must be an array"};
+                }
+                rings.emplace_back();
+                for (const auto& point : ring.GetArray()) {
+                    if (!point.IsArray() || point.Size() < 2 || !point[0u].IsNumber() || !point[1u].IsNumber()) {
+                        throw osmium::geometry_error{"GeoJSON position must be an array of at least two numbers"};
+                    }
+                    const osmium::Location location{point[0u].GetDouble(), point[1u].GetDouble()};
+                    if (!location.valid()) {
+                        throw osmium::geometry_error{"GeoJSON position out of range"};
+                    }
+                    rings.back().push_back(location);
+                }
+            }
+
+            template <typename TJsonValue>
+            inline void add_geojson_polygon(std::vector<std::vector<osmium::Location>>& rings, const TJsonValue& polygon) {
+                if (!polygon.IsArray()) {
+                    throw osmium::geometry_error{"GeoJSON polygon coordinates must be an array"};
+                }
+                for (const auto& ring : polygon.GetArray()) {
+                    add_geojson_ring(rings, ring);
+                }
+            }
+
+        } // namespace detail
+
+        /**
+         * Create a Polygon from a GeoJSON Polygon or MultiPolygon
+         * geometry or from a Feature with such a geometry. The JSON
+         * must have been parsed with RapidJSON
+         * (https://github.com/miloyip/rapidjson) or a library with the
+         * same interface, the template parameter is usually
+         * rapidjson::Value. RapidJSON is not included by Osmium.
+         *
+         * @throws osmium::geometry_error if the GeoJSON is not a
+         *         (multi)polygon.
+         */
+        template <typename TJsonValue>
+        inline osmium::extract::Polygon polygon_from_geojson(const TJsonValue& value) {
+            if (!value.IsObject() || !value.HasMember("type") || !value["type"].IsString()) {
+                throw osmium::geometry_error{"GeoJSON object must have a type"};
+            }
+
+            const char* type = value["type"].GetString();
+            if (!std::strcmp(type, "Feature")) {
+                if (!value.HasMember("geometry")) {
+                    throw osmium::geometry_error{"GeoJSON Feature must have a geometry"};
+                }
+                return polygon_from_geojson(value["geometry"]);
+            }
+
+            if (!value.HasMember("coordinates")) {
+                throw osmium::geometry_error{"GeoJSON geometry must have coordinates"};
+            }
+            const auto& coordinates = value["coordinates"];
+
+            std::vector<std::vector<osmium::Location>> rings;
+            if (!std::strcmp(type, "Polygon")) {
+                detail::add_geojson_polygon(rings, coordinates);
+            } else if (!std::strcmp(type, "MultiPolygon")) {
+                if (!coordinates.IsArray()) {
+                    throw osmium::geometry_error{"GeoJSON MultiPolygon coordinates must be an array"};
+                }
+                for (const auto& polygon : coordinates.GetArray()) {
+                    detail::add_geojson_polygon(rings, polygon);
+                }
+            } else {
+                throw osmium::geometry_error{std::string{"GeoJSON geometry must be Polygon or MultiPolygon, not "} + type};
+            }
+
+            return osmium::extract::Polygon{rings};
+        }
+
+    } // namespace extract
+
+} // namespace osmium
+
+#endif // OSMIUM_EXTRACT_GEOJSON_HPP
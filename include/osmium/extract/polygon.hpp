@@ -0,0 +1,329 @@
+#ifndef OSMIUM_EXTRACT_POLYGON_HPP
+#define OSMIUM_EXTRACT_POLYGON_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <osmium/osm/area.hpp>
+#include <osmium/osm/box.hpp>
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/node_ref_list.hpp>
+
+namespace osmium {
+
+    /**
+     * @brief Creating extracts of OSM data
+     */
+    namespace extract {
+
+        namespace detail {
+
+            /**
+             * Segment of a polygon ring in internal integer coordinates.
+             * The points are ordered so that y1 <= y2.
+             */
+            struct polygon_segment {
+
+                int64_t x1;
+                int64_t y1;
+                int64_t x2;
+                int64_t y2;
+
+                polygon_segment(const osmium::Location& a, const osmium::Location& b) noexcept :
+                    x1(a.x()),
+                    y1(a.y()),
+                    x2(b.x()),
+                    y2(b.y()) {
+                    if (y1 > y2) {
+                        using std::swap;
+                        swap(x1, x2);
+                        swap(y1, y2);
+                    }
+                }
+
+                /**
+                 * Does a ray from the given point towards positive x
+                 * cross this segment? Horizontal segments are never
+                 * crossed. The check is done with exact integer
+                 * arithmetic.
+                 */
+                bool crossed_by_ray(int64_t x, int64_t y) const noexcept {
+                    if (y < y1 || y >= y2) {
+                        return false;
+                    }
+                    return (x2 - x1) * (y - y1) > (x - x1) * (y2 - y1);
+                }
+
+            }; // struct polygon_segment
+
+        } // namespace detail
+
+        /**
+         * A (multi)polygon for checking quickly whether locations are
+         * inside it. A location is inside if a ray from it crosses the
+         * rings of the polygon an odd number of times. So the direction
+         * of the rings and whether they are inner or outer rings doesn't
+         * matter. Locations exactly on the boundary may be reported as
+         * inside or outside.
+         *
+         * To make the check fast, the bounding box of the polygon is
+         * divided into a grid of cells. Cells not touched by any segment
+         * are completely inside or outside, so checking a location in
+         * those needs only a lookup. For the other cells only the segments
+         * in the same row of the grid are checked.
+         *
+         * After construction, the polygon is never changed, so it can be
+         * used from several threads at the same time.
+         */
+        class Polygon {
+
+            enum class cell_state : uint8_t {
+                outside = 0,
+                inside  = 1,
+                border  = 2
+            };
+
+            // Maximum number of cells in each direction.
+            enum {
+                max_grid_size = 256
+            };
+
+            std::vector<detail::polygon_segment> m_segments;
+
+            osmium::Box m_envelope;
+
+            int64_t m_min_x = 0;
+            int64_t m_min_y = 0;
+            int64_t m_cell_width = 1;
+            int64_t m_cell_height = 1;
+            int64_t m_columns = 0;
+            int64_t m_rows = 0;
+
+            // Grid cells row by row.
+            std::vector<cell_state> m_cells;
+
+            // Indexes of the segments in each row of the grid.
+            std::vector<std::vector<uint32_t>> m_rows_segments;
+
+            template <typename TIterator, typename TGetLocation>
+            void add_ring(TIterator begin, TIterator end, TGetLocation&& get_location) {
+                if (begin == end) {
+                    return;
+                }
+                const osmium::Location first = get_location(*begin);
+                osmium::Location previous = first;
+                m_envelope.extend(first);
+                for (auto it = std::next(begin); it != end; ++it) {
+                    const osmium::Location location = get_location(*it);
+                    m_envelope.extend(location);
+                    if (location != previous) {
+                        m_segments.emplace_back(previous, location);
+                    }
+                    previous = location;
+                }
+                if (previous != first) {
+                    m_segments.emplace_back(previous, first);
+                }
+            }
+
+            int64_t column(int64_t x) const noexcept {
+                return (x - m_min_x) / m_cell_width;
+            }
+
+            int64_t row(int64_t y) const noexcept {
+                return (y - m_min_y) / m_cell_height;
+            }
+
+            bool check_row(int64_t x, int64_t y, int64_t r) const noexcept {
+                bool inside = false;
+                for (const auto index : m_rows_segments[static_cast<size_t>(r)]) {
+                    if (m_segments[index].crossed_by_ray(x, y)) {
+                        inside = !inside;
+                    }
+                }
+                return inside;
+            }
+
+            // Mark all cells touched by the segment in the given row.
+            void mark_border_cells(const detail::polygon_segment& segment, int64_t r) {
+                const int64_t row_min_y = std::max(segment.y1, m_min_y + r * m_cell_height);
+                const int64_t row_max_y = std::min(segment.y2, m_min_y + (r + 1) * m_cell_height - 1);
+
+                int64_t min_x = std::min(segment.x1, segment.x2);
+                int64_t max_x = std::max(segment.x1, segment.x2);
+                if (segment.y2 != segment.y1) {
+                    const double dx = static_cast<double>(segment.x2 - segment.x1) / static_cast<double>(segment.y2 - segment.y1);
+                    const auto xa = static_cast<double>(segment.x1) + dx * static_cast<double>(row_min_y - segment.y1);
+                    const auto xb = static_cast<double>(segment.x1) + dx * static_cast<double>(row_max_y - segment.y1);
+                    // One unit of slack on each side for rounding errors.
+                    min_x = std::max(min_x, static_cast<int64_t>(std::floor(std::min(xa, xb))) - 1);
+                    max_x = std::min(max_x, static_cast<int64_t>(std::ceil(std::max(xa, xb))) + 1);
+                }
+
+                const int64_t first_column = std::max(static_cast<int64_t>(0), column(min_x));
+                const int64_t last_column = std::min(m_columns - 1, column(max_x));
+                for (int64_t c = first_column; c <= last_column; ++c) {
+                    m_cells[static_cast<size_t>(r * m_columns + c)] = cell_state::border;
+                }
+            }
+
+            void build_index() {
+                if (m_segments.empty()) {
+                    return;
+                }
+
+                m_min_x = m_envelope.bottom_left().x();
+                m_min_y = m_envelope.bottom_left().y();
+                const int64_t width = m_envelope.top_right().x() - m_min_x + 1;
+                const int64_t height = m_envelope.top_right().y() - m_min_y + 1;
+
+                const auto grid_size = static_cast<int64_t>(std::sqrt(static_cast<double>(m_segments.size())));
+                m_columns = std::max(static_cast<int64_t>(1), std::min(std::min(grid_size, static_cast<int64_t>(max_grid_size)), width));
+                m_rows = std::max(static_cast<int64_t>(1), std::min(std::min(grid_size, static_cast<int64_t>(max_grid_size)), height));
+                m_cell_width = (width + m_columns - 1) / m_columns;
+                m_cell_height = (height + m_rows - 1) / m_rows;
+
+                m_cells.assign(static_cast<size_t>(m_columns * m_rows), cell_state::outside);
+                m_rows_segments.resize(static_cast<size_t>(m_rows));
+
+                for (uint32_t index = 0; index < m_segments.size(); ++index) {
+                    const auto& segment = m_segments[index];
+                    const int64_t last_row = row(segment.y2);
+                    for (int64_t r = row(segment.y1); r <= last_row; ++r) {
+                        if (segment.y1 != segment.y2) {
+                            m_rows_segments[static_cast<size_t>(r)].push_back(index);
+                        }
+                        mark_border_cells(segment, r);
+                    }
+                }
+
+                for (int64_t r = 0; r < m_rows; ++r) {
+                    const int64_t center_y = m_min_y + r * m_cell_height + m_cell_height / 2;
+                    for (int64_t c = 0; c < m_columns; ++c) {
+                        auto& cell = m_cells[static_cast<size_t>(r * m_columns + c)];
+                        if (cell != cell_state::border) {
+                            const int64_t center_x = m_min_x + c * m_cell_width + m_cell_width / 2;
+                            cell = check_row(center_x, center_y, r) ? cell_state::inside : cell_state::outside;
+                        }
+                    }
+                }
+            }
+
+        public:
+
+            /**
+             * Create a polygon from the given rings. The rings don't need
+             * to be closed, the last location is always connected to the
+             * first one. All locations must be valid.
+             */
+            explicit Polygon(const std::vector<std::vector<osmium::Location>>& rings) {
+                for (const auto& ring : rings) {
+                    add_ring(ring.cbegin(), ring.cend(), [](const osmium::Location& location) {
+                        return location;
+                    });
+                }
+                build_index();
+            }
+
+            /**
+             * Create a polygon from a bounding box. The box must be
+             * valid.
+             */
+            explicit Polygon(const osmium::Box& box) :
+                Polygon(std::vector<std::vector<osmium::Location>>{{
+                    box.bottom_left(),
+                    osmium::Location{box.top_right().x(), box.bottom_left().y()},
+                    box.top_right(),
+                    osmium::Location{box.bottom_left().x(), box.top_right().y()}
+                }}) {
+            }
+
+            /**
+             * Create a polygon from all outer and inner rings of an area.
+             */
+            explicit Polygon(const osmium::Area& area) {
+                const auto get_location = [](const osmium::NodeRef& node_ref) {
+                    return node_ref.location();
+                };
+                for (const auto& outer : area.outer_rings()) {
+                    add_ring(outer.cbegin(), outer.cend(), get_location);
+                    for (const auto& inner : area.inner_rings(outer)) {
+                        add_ring(inner.cbegin(), inner.cend(), get_location);
+                    }
+                }
+                build_index();
+            }
+
+            /// The bounding box of the polygon.
+            const osmium::Box& envelope() const noexcept {
+                return m_envelope;
+            }
+
+            /// The number of segments in all rings of the polygon.
+            size_t num_segments() const noexcept {
+                return m_segments.size();
+            }
+
+            /**
+             * Is the location inside the polygon? Always returns false
+             * for invalid locations.
+             */
+            bool contains(const osmium::Location& location) const noexcept {
+                if (m_segments.empty() || !location.valid() || !m_envelope.contains(location)) {
+                    return false;
+                }
+
+                const int64_t x = location.x();
+                const int64_t y = location.y();
+                const int64_t r = row(y);
+                const cell_state cell = m_cells[static_cast<size_t>(r * m_columns + column(x))];
+                if (cell != cell_state::border) {
+                    return cell == cell_state::inside;
+                }
+
+                return check_row(x, y, r);
+            }
+
+        }; // class Polygon
+
+    } // namespace extract
+
+} // namespace osmium
+
+#endif // OSMIUM_EXTRACT_POLYGON_HPP
@@ -0,0 +1,167 @@
+#ifndef OSMIUM_GEOM_DETAIL_MATH_APPROX_HPP
+#define OSMIUM_GEOM_DETAIL_MATH_APPROX_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <osmium/geom/util.hpp>
+
+namespace osmium {
+
+    namespace geom {
+
+        namespace detail {
+
+            // Polynomial approximations of some math functions. They don't
+            // call any math library functions and don't branch, so the
+            // compiler can vectorize loops using them. They are only valid
+            // in the ranges given.
+
+            /**
+             * Sine of x calculated with a polynomial. The error is below
+             * 5e-14 for |x| <= PI/2.
+             */
+            inline double sin_approx(double x) noexcept {
+                const double x2 = x * x;
+                double r = 1.0 / 355687428096000.0; // 1/17!
+                r = r * x2 - 1.0 / 1307674368000.0;
+                r = r * x2 + 1.0 / 6227020800.0;
+                r = r * x2 - 1.0 / 39916800.0;
+                r = r * x2 + 1.0 / 362880.0;
+                r = r * x2 - 1.0 / 5040.0;
+                r = r * x2 + 1.0 / 120.0;
+                r = r * x2 - 1.0 / 6.0;
+                r = r * x2 + 1.0;
+                return x * r;
+            }
+
+            /**
+             * Natural logarithm of x calculated from the exponent and a
+             * series for the mantissa. Only works for positive normal
+             * numbers. This function uses bit operations instead of
+             * branches or calls to math library functions, so the compiler
+             * can vectorize loops using it.
+             */
+            inline double log_approx(double x) noexcept {
+                uint64_t bits;
+                std::memcpy(&bits, &x, sizeof(bits));
+
+                // Split into exponent k (biased) and mantissa m with
+                // sqrt(0.5) <= m < sqrt(2).
+                const uint64_t k = (bits + 0x00095f619980c433ULL) >> 52;
+                bits = bits - (k << 52) + 0x3ff0000000000000ULL;
+                double m;
+                std::memcpy(&m, &bits, sizeof(m));
+
+                // Convert biased exponent to double (k < 2^52).
+                const uint64_t k_bits = k | 0x4330000000000000ULL;
+                double e;
+                std::memcpy(&e, &k_bits, sizeof(e));
+                e -= 4503599627370496.0 + 1023.0;
+
+                // log(m) = 2 * atanh(t) with |t| < 0.172
+                const double t = (m - 1.0) / (m + 1.0);
+                const double t2 = t * t;
+                double r = 1.0 / 15;
+                r = r * t2 + 1.0 / 13;
+                r = r * t2 + 1.0 / 11;
+                r = r * t2 + 1.0 / 9;
+                r = r * t2 + 1.0 / 7;
+                r = r * t2 + 1.0 / 5;
+                r = r * t2 + 1.0 / 3;
+                r = r * t2 + 1.0;
+
+                return 2.0 * t * r + e * 0.6931471805599453;
+            }
+
+            /**
+             * Cosine of x calculated with a polynomial. The error is below
+             * 5e-14 for |x| <= PI/2.
+             */
+            inline double cos_approx(double x) noexcept {
+                return sin_approx(osmium::geom::PI / 2 - std::abs(x));
+            }
+
+            /**
+             * Square root of x calculated with Newton iterations starting
+             * from an estimate taken from the bits of x. The relative error
+             * is below 1e-15 for all positive normal numbers, the result
+             * for 0 is 0. Unlike std::sqrt() this never has to set errno,
+             * so the compiler can vectorize loops using it.
+             */
+            inline double sqrt_approx(double x) noexcept {
+                uint64_t bits;
+                std::memcpy(&bits, &x, sizeof(bits));
+                bits = 0x5fe6eb50c7b537a9ULL - (bits >> 1);
+                double y;
+                std::memcpy(&y, &bits, sizeof(y));
+
+                // Newton iterations for 1/sqrt(x)
+                const double half_x = 0.5 * x;
+                y = y * (1.5 - half_x * y * y);
+                y = y * (1.5 - half_x * y * y);
+                y = y * (1.5 - half_x * y * y);
+                y = y * (1.5 - half_x * y * y);
+
+                return x * y;
+            }
+
+            /**
+             * Arc sine of x calculated with a polynomial. The relative
+             * error is below 3e-15 for |x| <= 0.2. Do not use for larger
+             * values.
+             */
+            inline double asin_approx(double x) noexcept {
+                const double x2 = x * x;
+                double r = 6435.0 / 557056.0;
+                r = r * x2 + 143.0 / 10240.0;
+                r = r * x2 + 231.0 / 13312.0;
+                r = r * x2 + 63.0 / 2816.0;
+                r = r * x2 + 35.0 / 1152.0;
+                r = r * x2 + 5.0 / 112.0;
+                r = r * x2 + 3.0 / 40.0;
+                r = r * x2 + 1.0 / 6.0;
+                r = r * x2 + 1.0;
+                return x * r;
+            }
+
+        } // namespace detail
+
+    } // namespace geom
+
+} // namespace osmium
+
+#endif // OSMIUM_GEOM_DETAIL_MATH_APPROX_HPP
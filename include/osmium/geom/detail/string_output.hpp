@@ -0,0 +1,143 @@
+#ifndef OSMIUM_GEOM_DETAIL_STRING_OUTPUT_HPP
+#define OSMIUM_GEOM_DETAIL_STRING_OUTPUT_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include <string>
+#include <utility>
+
+namespace osmium {
+
+    namespace geom {
+
+        namespace detail {
+
+            /**
+             * Output policy for the string based geometry factories (WKB,
+             * WKT, GeoJSON). Each geometry is returned as a new std::string.
+             */
+            class string_output {
+
+                std::string m_str;
+
+            public:
+
+                using result_type = std::string;
+
+                string_output() = default;
+
+                /// Start a new geometry. Returns the string to write it to.
+                std::string& start() {
+                    m_str.clear();
+                    return m_str;
+                }
+
+                /// The string the current geometry is written to.
+                std::string& buffer() noexcept {
+                    return m_str;
+                }
+
+                /// Finish the current geometry and return it.
+                result_type finish() {
+                    std::string str;
+
+                    using std::swap;
+                    swap(str, m_str);
+
+                    return str;
+                }
+
+                /**
+                 * Write a geometry that is created in one step (ie a point)
+                 * by calling func with the string to write it to.
+                 */
+                template <typename TFunc>
+                result_type single(TFunc&& func) const {
+                    std::string str;
+                    std::forward<TFunc>(func)(str);
+                    return str;
+                }
+
+            }; // class string_output
+
+            /**
+             * Output policy for the string based geometry factories (WKB,
+             * WKT, GeoJSON). All geometries are appended to a string owned
+             * by the caller and nothing is returned. If the caller re-uses
+             * this string (calling clear() instead of creating a new one),
+             * no memory has to be allocated once the string has grown large
+             * enough.
+             *
+             * If the factory throws an exception, part of the geometry might
+             * already have been written to the string. Callers that want to
+             * go on after an error have to remember the size of the string
+             * before creating the geometry and resize it back.
+             */
+            class append_output {
+
+                std::string* m_out;
+
+            public:
+
+                using result_type = void;
+
+                explicit append_output(std::string& out) noexcept :
+                    m_out(&out) {
+                }
+
+                std::string& start() noexcept {
+                    return *m_out;
+                }
+
+                std::string& buffer() noexcept {
+                    return *m_out;
+                }
+
+                void finish() const noexcept {
+                }
+
+                template <typename TFunc>
+                void single(TFunc&& func) const {
+                    std::forward<TFunc>(func)(*m_out);
+                }
+
+            }; // class append_output
+
+        } // namespace detail
+
+    } // namespace geom
+
+} // namespace osmium
+
+#endif // OSMIUM_GEOM_DETAIL_STRING_OUTPUT_HPP
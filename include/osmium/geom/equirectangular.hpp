@@ -0,0 +1,152 @@
+#ifndef OSMIUM_GEOM_EQUIRECTANGULAR_HPP
+#define OSMIUM_GEOM_EQUIRECTANGULAR_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include <osmium/geom/coordinates.hpp>
+#include <osmium/geom/detail/math_approx.hpp>
+#include <osmium/geom/haversine.hpp>
+#include <osmium/geom/util.hpp>
+#include <osmium/osm/node_ref.hpp>
+#include <osmium/osm/way.hpp>
+
+namespace osmium {
+
+    namespace geom {
+
+        /**
+         * @brief Functions to calculate approximate distances on Earth
+         *        using the equirectangular projection.
+         *
+         * This is cheaper than the haversine formula, but only works well
+         * for short distances away from the poles. The relative difference
+         * to the result of the haversine functions (with the same Earth
+         * radius) is below 1e-8 for distances up to 1 km, below 4e-6 for
+         * distances up to 10 km, and below 4e-4 for distances up to 100 km,
+         * as long as the latitudes are between -80 and 80 degrees. It grows
+         * with the square of the distance and gets much larger near the
+         * poles.
+         *
+         * See https://www.movable-type.co.uk/scripts/latlong.html
+         */
+        namespace equirectangular {
+
+            namespace detail {
+
+                /**
+                 * Calculate the approximate distances between the n+1
+                 * locations in lon/lat (n <= segment_chunk_size). The
+                 * compiler can vectorize this.
+                 */
+                struct distance_kernel {
+
+                    void operator()(const double* lon, const double* lat, std::size_t n, double* d) const {
+                        for (std::size_t i = 0; i < n; ++i) {
+                            double dlon = std::abs(lon[i + 1] - lon[i]);
+                            // take the short way around if crossing the antimeridian
+                            dlon = std::min(dlon, 2 * PI - dlon);
+                            const double x = dlon * osmium::geom::detail::cos_approx((lat[i] + lat[i + 1]) * 0.5);
+                            const double y = lat[i + 1] - lat[i];
+                            d[i] = haversine::EARTH_RADIUS_IN_METERS * osmium::geom::detail::sqrt_approx(x * x + y * y);
+                        }
+                    }
+
+                }; // struct distance_kernel
+
+            } // namespace detail
+
+            /**
+             * Calculate approximate distance in meters between two sets of
+             * coordinates.
+             */
+            inline double distance(const osmium::geom::Coordinates& c1, const osmium::geom::Coordinates& c2) {
+                double dlon = std::abs(deg_to_rad(c2.x - c1.x));
+                dlon = std::min(dlon, 2 * PI - dlon);
+                const double x = dlon * std::cos(deg_to_rad(c1.y + c2.y) * 0.5);
+                const double y = deg_to_rad(c2.y - c1.y);
+                return haversine::EARTH_RADIUS_IN_METERS * std::sqrt(x * x + y * y);
+            }
+
+            /**
+             * Calculate the approximate lengths of all segments between the
+             * node refs in [first, last) and write them to out, which must
+             * have space for (last - first - 1) values.
+             *
+             * @throws osmium::invalid_location if any of the locations is
+             *         invalid.
+             */
+            inline void distances(const osmium::NodeRef* first, const osmium::NodeRef* last, double* out) {
+                haversine::detail::segment_batch(first, last, detail::distance_kernel{}, [&out](const double* d, std::size_t n) {
+                    out = std::copy_n(d, n, out);
+                });
+            }
+
+            /**
+             * Calculate the approximate lengths of all segments of the way
+             * and write them to out, which must have space for
+             * (wnl.size() - 1) values.
+             */
+            inline void distances(const osmium::WayNodeList& wnl, double* out) {
+                distances(wnl.cbegin(), wnl.cend(), out);
+            }
+
+            /**
+             * Calculate approximate length of way.
+             *
+             * @throws osmium::invalid_location if any of the locations is
+             *         invalid.
+             */
+            inline double distance(const osmium::WayNodeList& wnl) {
+                double sum_length = 0;
+
+                haversine::detail::segment_batch(wnl.cbegin(), wnl.cend(), detail::distance_kernel{}, [&sum_length](const double* d, std::size_t n) {
+                    for (std::size_t i = 0; i < n; ++i) {
+                        sum_length += d[i];
+                    }
+                });
+
+                return sum_length;
+            }
+
+        } // namespace equirectangular
+
+    } // namespace geom
+
+} // namespace osmium
+
+#endif // OSMIUM_GEOM_EQUIRECTANGULAR_HPP
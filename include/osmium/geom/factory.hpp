@@ -36,9 +36,12 @@ DEALINGS IN THE SOFTWARE.
 #include <cstddef>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <osmium/geom/coordinates.hpp>
+#include <osmium/geom/mercator_projection.hpp>
 #include <osmium/memory/collection.hpp>
 #include <osmium/memory/item.hpp>
 #include <osmium/osm/area.hpp>
@@ -141,16 +144,120 @@ namespace osmium {
 
         }; // class IdentityProjection
 
+        namespace detail {
+
+            /**
+             * Projections that can project all node refs in a list at once
+             * have a specialization of this with value true. They must
+             * have a member function
+             * project(const NodeRef* first, const NodeRef* last, Coordinates* out)
+             * which leaves the output for invalid locations unchanged.
+             */
+            template <typename TProjection>
+            struct projects_node_ref_lists : public std::false_type {
+            };
+
+            template <>
+            struct projects_node_ref_lists<FastMercatorProjection> : public std::true_type {
+            };
+
+        } // namespace detail
+
         /**
          * Geometry factory.
          */
         template <typename TGeomImpl, typename TProjection = IdentityProjection>
         class GeometryFactory {
 
+            using batch_projection = detail::projects_node_ref_lists<TProjection>;
+
+            /**
+             * Project all nodes in the list at once and call func with the
+             * coordinates of the nodes in the order and with the nodes
+             * selected by un and dir. Invalid locations are handed to the
+             * normal projection which will throw an exception for them
+             * exactly like the code projecting one location at a time.
+             */
+            template <typename TFunc>
+            size_t add_projected_nodes(const osmium::NodeRefList& nodes, use_nodes un, direction dir, TFunc&& func) {
+                const size_t size = nodes.size();
+                m_coordinates.resize(size, Coordinates{0.0, 0.0});
+                m_projection.project(nodes.cbegin(), nodes.cend(), m_coordinates.data());
+
+                size_t num_points = 0;
+                osmium::Location last_location;
+                for (size_t i = 0; i < size; ++i) {
+                    const size_t n = (dir == direction::forward) ? i : size - 1 - i;
+                    const osmium::Location location = nodes[n].location();
+                    if (un == use_nodes::all || last_location != location) {
+                        last_location = location;
+                        func(location.valid() ? m_coordinates[n] : m_projection(location));
+                        ++num_points;
+                    }
+                }
+                return num_points;
+            }
+
+            size_t add_linestring_nodes(const osmium::WayNodeList& wnl, use_nodes un, direction dir, std::true_type) {
+                return add_projected_nodes(wnl, un, dir, [this](const Coordinates& c) {
+                    m_impl.linestring_add_location(c);
+                });
+            }
+
+            size_t add_linestring_nodes(const osmium::WayNodeList& wnl, use_nodes un, direction dir, std::false_type) {
+                if (un == use_nodes::unique) {
+                    switch (dir) {
+                        case direction::forward:
+                            return fill_linestring_unique(wnl.cbegin(), wnl.cend());
+                        case direction::backward:
+                            return fill_linestring_unique(wnl.crbegin(), wnl.crend());
+                    }
+                } else {
+                    switch (dir) {
+                        case direction::forward:
+                            return fill_linestring(wnl.cbegin(), wnl.cend());
+                        case direction::backward:
+                            return fill_linestring(wnl.crbegin(), wnl.crend());
+                    }
+                }
+                return 0;
+            }
+
+            size_t add_polygon_nodes(const osmium::WayNodeList& wnl, use_nodes un, direction dir, std::true_type) {
+                return add_projected_nodes(wnl, un, dir, [this](const Coordinates& c) {
+                    m_impl.polygon_add_location(c);
+                });
+            }
+
+            size_t add_polygon_nodes(const osmium::WayNodeList& wnl, use_nodes un, direction dir, std::false_type) {
+                if (un == use_nodes::unique) {
+                    switch (dir) {
+                        case direction::forward:
+                            return fill_polygon_unique(wnl.cbegin(), wnl.cend());
+                        case direction::backward:
+                            return fill_polygon_unique(wnl.crbegin(), wnl.crend());
+                    }
+                } else {
+                    switch (dir) {
+                        case direction::forward:
+                            return fill_polygon(wnl.cbegin(), wnl.cend());
+                        case direction::backward:
+                            return fill_polygon(wnl.crbegin(), wnl.crend());
+                    }
+                }
+                return 0;
+            }
+
             /**
              * Add all points of an outer or inner ring to a multipolygon.
              */
-            void add_points(const osmium::NodeRefList& nodes) {
+            void add_points(const osmium::NodeRefList& nodes, std::true_type) {
+                add_projected_nodes(nodes, use_nodes::unique, direction::forward, [this](const Coordinates& c) {
+                    m_impl.multipolygon_add_location(c);
+                });
+            }
+
+            void add_points(const osmium::NodeRefList& nodes, std::false_type) {
                 osmium::Location last_location;
                 for (const osmium::NodeRef& node_ref : nodes) {
                     if (last_location != node_ref.location()) {
@@ -163,6 +270,10 @@ namespace osmium {
             TProjection m_projection;
             TGeomImpl m_impl;
 
+            // Scratch space for the coordinates if the projection can
+            // project whole node lists at once.
+            std::vector<Coordinates> m_coordinates;
+
         public:
 
             /**
@@ -171,7 +282,8 @@ namespace osmium {
             template <typename... TArgs>
             explicit GeometryFactory<TGeomImpl, TProjection>(TArgs&&... args) :
                 m_projection(),
-                m_impl(m_projection.epsg(), std::forward<TArgs>(args)...) {
+                m_impl(m_projection.epsg(), std::forward<TArgs>(args)...),
+                m_coordinates() {
             }
 
             /**
@@ -181,7 +293,8 @@ namespace osmium {
             template <typename... TArgs>
             explicit GeometryFactory<TGeomImpl, TProjection>(TProjection&& projection, TArgs&&... args) :
                 m_projection(std::move(projection)),
-                m_impl(m_projection.epsg(), std::forward<TArgs>(args)...) {
+                m_impl(m_projection.epsg(), std::forward<TArgs>(args)...),
+                m_coordinates() {
             }
 
             using projection_type   = TProjection;
@@ -259,28 +372,7 @@ namespace osmium {
 
             linestring_type create_linestring(const osmium::WayNodeList& wnl, use_nodes un = use_nodes::unique, direction dir = direction::forward) {
                 linestring_start();
-                size_t num_points = 0;
-
-                if (un == use_nodes::unique) {
-                    osmium::Location last_location;
-                    switch (dir) {
-                        case direction::forward:
-                            num_points = fill_linestring_unique(wnl.cbegin(), wnl.cend());
-                            break;
-                        case direction::backward:
-                            num_points = fill_linestring_unique(wnl.crbegin(), wnl.crend());
-                            break;
-                    }
-                } else {
-                    switch (dir) {
-                        case direction::forward:
-                            num_points = fill_linestring(wnl.cbegin(), wnl.cend());
-                            break;
-                        case direction::backward:
-                            num_points = fill_linestring(wnl.crbegin(), wnl.crend());
-                            break;
-                    }
-                }
+                const size_t num_points = add_linestring_nodes(wnl, un, dir, batch_projection{});
 
                 if (num_points < 2) {
                     throw osmium::geometry_error{"need at least two points for linestring"};
@@ -333,28 +425,7 @@ namespace osmium {
 
             polygon_type create_polygon(const osmium::WayNodeList& wnl, use_nodes un = use_nodes::unique, direction dir = direction::forward) {
                 polygon_start();
-                size_t num_points = 0;
-
-                if (un == use_nodes::unique) {
-                    osmium::Location last_location;
-                    switch (dir) {
-                        case direction::forward:
-                            num_points = fill_polygon_unique(wnl.cbegin(), wnl.cend());
-                            break;
-                        case direction::backward:
-                            num_points = fill_polygon_unique(wnl.crbegin(), wnl.crend());
-                            break;
-                    }
-                } else {
-                    switch (dir) {
-                        case direction::forward:
-                            num_points = fill_polygon(wnl.cbegin(), wnl.cend());
-                            break;
-                        case direction::backward:
-                            num_points = fill_polygon(wnl.crbegin(), wnl.crend());
-                            break;
-                    }
-                }
+                const size_t num_points = add_polygon_nodes(wnl, un, dir, batch_projection{});
 
                 if (num_points < 4) {
                     throw osmium::geometry_error{"need at least four points for polygon"};
@@ -388,14 +459,14 @@ namespace osmium {
                             }
                             m_impl.multipolygon_polygon_start();
                             m_impl.multipolygon_outer_ring_start();
-                            add_points(ring);
+                            add_points(ring, batch_projection{});
                             m_impl.multipolygon_outer_ring_finish();
                             ++num_rings;
                             ++num_polygons;
                         } else if (it->type() == osmium::item_type::inner_ring) {
                             auto& ring = static_cast<const osmium::InnerRing&>(*it);
                             m_impl.multipolygon_inner_ring_start();
-                            add_points(ring);
+                            add_points(ring, batch_projection{});
                             m_impl.multipolygon_inner_ring_finish();
                             ++num_rings;
                         }
@@ -39,6 +39,7 @@ DEALINGS IN THE SOFTWARE.
 #include <utility>
 
 #include <osmium/geom/coordinates.hpp>
+#include <osmium/geom/detail/string_output.hpp>
 #include <osmium/geom/factory.hpp>
 
 namespace osmium {
@@ -47,20 +48,33 @@ namespace osmium {
 
         namespace detail {
 
-            class GeoJSONFactoryImpl {
+            /**
+             * GeoJSON geometry factory implementation. The TOutput policy
+             * decides whether each geometry is returned as a new std::string
+             * (string_output) or appended to a string owned by the caller
+             * (append_output).
+             */
+            template <typename TOutput>
+            class BasicGeoJSONFactoryImpl {
 
-                std::string m_str;
+                TOutput m_output;
                 int m_precision;
 
             public:
 
-                using point_type        = std::string;
-                using linestring_type   = std::string;
-                using polygon_type      = std::string;
-                using multipolygon_type = std::string;
-                using ring_type         = std::string;
+                using point_type        = typename TOutput::result_type;
+                using linestring_type   = typename TOutput::result_type;
+                using polygon_type      = typename TOutput::result_type;
+                using multipolygon_type = typename TOutput::result_type;
+                using ring_type         = typename TOutput::result_type;
 
-                GeoJSONFactoryImpl(int /* srid */, int precision = 7) :
+                BasicGeoJSONFactoryImpl(int /* srid */, int precision = 7) :
+                    m_output(),
+                    m_precision(precision) {
+                }
+
+                BasicGeoJSONFactoryImpl(int /* srid */, std::string& out, int precision = 7) :
+                    m_output(out),
                     m_precision(precision) {
                 }
 
@@ -68,92 +82,100 @@ namespace osmium {
 
                 // { "type": "Point", "coordinates": [100.0, 0.0] }
                 point_type make_point(const osmium::geom::Coordinates& xy) const {
-                    std::string str {"{\"type\":\"Point\",\"coordinates\":"};
-                    xy.append_to_string(str, '[', ',', ']', m_precision);
-                    str += "}";
-                    return str;
+                    return m_output.single([this, &xy](std::string& str) {
+                        str += "{\"type\":\"Point\",\"coordinates\":";
+                        xy.append_to_string(str, '[', ',', ']', m_precision);
+                        str += '}';
+                    });
                 }
 
                 /* LineString */
 
                 // { "type": "LineString", "coordinates": [ [100.0, 0.0], [101.0, 1.0] ] }
                 void linestring_start() {
-                    m_str = "{\"type\":\"LineString\",\"coordinates\":[";
+                    m_output.start() += "{\"type\":\"LineString\",\"coordinates\":[";
                 }
 
                 void linestring_add_location(const osmium::geom::Coordinates& xy) {
-                    xy.append_to_string(m_str, '[', ',', ']', m_precision);
-                    m_str += ',';
+                    xy.append_to_string(m_output.buffer(), '[', ',', ']', m_precision);
+                    m_output.buffer() += ',';
                 }
 
                 linestring_type linestring_finish(size_t /* num_points */) {
-                    assert(!m_str.empty());
-                    std::string str;
-
-                    using std::swap;
-                    swap(str, m_str);
-
+                    std::string& str = m_output.buffer();
+                    assert(!str.empty());
                     str.back() = ']';
-                    str += "}";
-                    return str;
+                    str += '}';
+                    return m_output.finish();
                 }
 
                 /* MultiPolygon */
 
                 void multipolygon_start() {
-                    m_str = "{\"type\":\"MultiPolygon\",\"coordinates\":[";
+                    m_output.start() += "{\"type\":\"MultiPolygon\",\"coordinates\":[";
                 }
 
                 void multipolygon_polygon_start() {
-                    m_str += '[';
+                    m_output.buffer() += '[';
                 }
 
                 void multipolygon_polygon_finish() {
-                    m_str += "],";
+                    m_output.buffer() += "],";
                 }
 
                 void multipolygon_outer_ring_start() {
-                    m_str += '[';
+                    m_output.buffer() += '[';
                 }
 
                 void multipolygon_outer_ring_finish() {
-                    assert(!m_str.empty());
-                    m_str.back() = ']';
+                    assert(!m_output.buffer().empty());
+                    m_output.buffer().back() = ']';
                 }
 
                 void multipolygon_inner_ring_start() {
-                    m_str += ",[";
+                    m_output.buffer() += ",[";
                 }
 
                 void multipolygon_inner_ring_finish() {
-                    assert(!m_str.empty());
-                    m_str.back() = ']';
+                    assert(!m_output.buffer().empty());
+                    m_output.buffer().back() = ']';
                 }
 
                 void multipolygon_add_location(const osmium::geom::Coordinates& xy) {
-                    xy.append_to_string(m_str, '[', ',', ']', m_precision);
-                    m_str += ',';
+                    xy.append_to_string(m_output.buffer(), '[', ',', ']', m_precision);
+                    m_output.buffer() += ',';
                 }
 
                 multipolygon_type multipolygon_finish() {
-                    assert(!m_str.empty());
-                    std::string str;
-
-                    using std::swap;
-                    swap(str, m_str);
-
+                    std::string& str = m_output.buffer();
+                    assert(!str.empty());
                     str.back() = ']';
-                    str += "}";
-                    return str;
+                    str += '}';
+                    return m_output.finish();
                 }
 
-            }; // class GeoJSONFactoryImpl
+            }; // class BasicGeoJSONFactoryImpl
+
+            using GeoJSONFactoryImpl = BasicGeoJSONFactoryImpl<string_output>;
 
         } // namespace detail
 
+        /**
+         * Factory for GeoJSON geometries. Each geometry is returned as a
+         * std::string.
+         */
         template <typename TProjection = IdentityProjection>
         using GeoJSONFactory = GeometryFactory<osmium::geom::detail::GeoJSONFactoryImpl, TProjection>;
 
+        /**
+         * Factory for GeoJSON geometries that appends all geometries to a
+         * std::string given to the constructor (before the other
+         * parameters) instead of returning them. See
+         * detail::append_output for details.
+         */
+        template <typename TProjection = IdentityProjection>
+        using GeoJSONAppendFactory = GeometryFactory<osmium::geom::detail::BasicGeoJSONFactoryImpl<osmium::geom::detail::append_output>, TProjection>;
+
     } // namespace geom
 
 } // namespace osmium
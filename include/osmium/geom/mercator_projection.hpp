@@ -34,11 +34,14 @@ DEALINGS IN THE SOFTWARE.
 */
 
 #include <cmath>
+#include <cstddef>
 #include <string>
 
 #include <osmium/geom/coordinates.hpp>
+#include <osmium/geom/detail/math_approx.hpp>
 #include <osmium/geom/util.hpp>
 #include <osmium/osm/location.hpp>
+#include <osmium/osm/node_ref.hpp>
 
 namespace osmium {
 
@@ -65,6 +68,17 @@ namespace osmium {
                 return rad_to_deg(2 * std::atan(std::exp(y / earth_radius_for_epsg3857)) - osmium::geom::PI/2);
             }
 
+            /**
+             * Approximation of lat_to_y() using y = R/2 * log((1+sin(lat)) /
+             * (1-sin(lat))) with the functions above. Only valid for
+             * latitudes between -MERCATOR_MAX_LAT and MERCATOR_MAX_LAT. In
+             * that range the difference to lat_to_y() is less than 0.02mm.
+             */
+            inline double lat_to_y_approx(double lat) noexcept {
+                const double s = sin_approx(deg_to_rad(lat));
+                return earth_radius_for_epsg3857 / 2 * log_approx((1.0 + s) / (1.0 - s));
+            }
+
         } // namespace detail
 
         /**
@@ -81,6 +95,83 @@ namespace osmium {
             return Coordinates(detail::x_to_lon(c.x), detail::y_to_lat(c.y));
         }
 
+        namespace detail {
+
+            inline osmium::Location get_location(const osmium::Location& location) noexcept {
+                return location;
+            }
+
+            inline osmium::Location get_location(const osmium::NodeRef& node_ref) noexcept {
+                return node_ref.location();
+            }
+
+            /**
+             * Like lat_to_y_approx(), but falls back to the exact formula
+             * outside the range of latitudes the approximation is valid
+             * for.
+             */
+            inline double lat_to_y_fast(double lat) {
+                return std::abs(lat) <= MERCATOR_MAX_LAT ? lat_to_y_approx(lat) : lat_to_y(lat);
+            }
+
+            template <typename T>
+            inline void lonlat_to_mercator_batch(const T* first, const T* last, Coordinates* out) {
+                constexpr const std::size_t chunk_size = 256;
+                double lat[chunk_size];
+                double y[chunk_size];
+
+                while (first != last) {
+                    const T* chunk = first;
+                    std::size_t n = 0;
+                    for (; first != last && n < chunk_size; ++first, ++n) {
+                        const osmium::Location location = get_location(*first);
+                        lat[n] = location.valid() ? location.lat_without_check() : 0.0;
+                    }
+
+                    // This is the loop the compiler can vectorize.
+                    for (std::size_t i = 0; i < n; ++i) {
+                        y[i] = lat_to_y_approx(lat[i]);
+                    }
+
+                    for (std::size_t i = 0; i < n; ++i, ++out) {
+                        const osmium::Location location = get_location(chunk[i]);
+                        if (location.valid()) {
+                            out->x = lon_to_x(location.lon_without_check());
+                            out->y = std::abs(lat[i]) <= MERCATOR_MAX_LAT ? y[i] : lat_to_y(lat[i]);
+                        }
+                    }
+                }
+            }
+
+        } // namespace detail
+
+        /**
+         * Project all locations in the range [first, last) from WGS84
+         * to Web Mercator and write the results to out which must have
+         * space for (last - first) coordinates. Invalid locations are not
+         * projected, the corresponding coordinates in out are left
+         * unchanged.
+         *
+         * This is much faster than projecting one location after the
+         * other, because it uses an approximation that the compiler can
+         * vectorize (see detail::lat_to_y_approx()). The results differ
+         * by less than 0.02mm from those of lonlat_to_mercator(). Outside
+         * the range of latitudes that can be projected the exact formula
+         * is used.
+         */
+        inline void lonlat_to_mercator(const osmium::Location* first, const osmium::Location* last, Coordinates* out) {
+            detail::lonlat_to_mercator_batch(first, last, out);
+        }
+
+        /**
+         * Project the locations of all node refs in the range [first, last)
+         * from WGS84 to Web Mercator. See the version of this function
+         * taking Locations for details.
+         */
+        inline void lonlat_to_mercator(const osmium::NodeRef* first, const osmium::NodeRef* last, Coordinates* out) {
+            detail::lonlat_to_mercator_batch(first, last, out);
+        }
+
         /**
          * Functor that does projection from WGS84 (EPSG:4326) to "Web
          * Mercator" (EPSG:3857)
@@ -103,6 +194,37 @@ namespace osmium {
 
         }; // class MercatorProjection
 
+        /**
+         * Like MercatorProjection, but uses the approximation described
+         * in lonlat_to_mercator() for projecting arrays of locations. The
+         * results differ by less than 0.02mm from MercatorProjection.
+         * Single locations are projected with the same approximation, so
+         * points and the vertices of linestrings and polygons created
+         * by a GeometryFactory using this projection are consistent.
+         *
+         * The GeometryFactory projects all nodes of linestrings and
+         * polygons at once when used with this projection, which is
+         * much faster.
+         */
+        class FastMercatorProjection : public MercatorProjection {
+
+        public:
+
+            Coordinates operator()(osmium::Location location) const {
+                return Coordinates {detail::lon_to_x(location.lon()), detail::lat_to_y_fast(location.lat())};
+            }
+
+            /**
+             * Project the locations of all node refs in the range
+             * [first, last) at once. Invalid locations are not projected.
+             * See lonlat_to_mercator() for details.
+             */
+            void project(const osmium::NodeRef* first, const osmium::NodeRef* last, Coordinates* out) const {
+                lonlat_to_mercator(first, last, out);
+            }
+
+        }; // class FastMercatorProjection
+
     } // namespace geom
 
 } // namespace osmium
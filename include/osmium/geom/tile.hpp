@@ -33,12 +33,22 @@ DEALINGS IN THE SOFTWARE.
 
 */
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 #include <osmium/geom/coordinates.hpp>
 #include <osmium/geom/mercator_projection.hpp>
+#include <osmium/osm/area.hpp>
 #include <osmium/osm/location.hpp>
+#include <osmium/osm/node_ref.hpp>
+#include <osmium/osm/node_ref_list.hpp>
+#include <osmium/osm/way.hpp>
 
 namespace osmium {
 
@@ -137,6 +147,261 @@ namespace osmium {
             return lhs.y < rhs.y;
         }
 
+        namespace detail {
+
+            /**
+             * Tile covers are calculated on an integer grid with 2^31
+             * units across the Mercator world. Even at zoom level 30 a
+             * tile is two units wide and all products of coordinate
+             * differences fit into 64 bit integers.
+             */
+            constexpr const int tile_grid_bits = 31;
+
+            struct tile_grid_point {
+                int64_t x;
+                int64_t y;
+            };
+
+            inline tile_grid_point to_tile_grid(double x, double y) noexcept {
+                const double size = static_cast<double>(int64_t(1) << tile_grid_bits);
+                const double scale = size / (max_coordinate_epsg3857 * 2);
+                const double max = size - 1;
+                return tile_grid_point{
+                    int64_t(restrict_to_range<double>((x + max_coordinate_epsg3857) * scale, 0, max)),
+                    int64_t(restrict_to_range<double>((max_coordinate_epsg3857 - y) * scale, 0, max))
+                };
+            }
+
+            /**
+             * Project the locations of the node refs in [first, last) onto
+             * the tile grid and call func with each point. The locations
+             * are projected in chunks using lat_to_y_approx() like the
+             * batch version of lonlat_to_mercator() does.
+             *
+             * @throws osmium::invalid_location if any location is invalid.
+             */
+            template <typename TFunc>
+            inline void for_each_tile_grid_point(const osmium::NodeRef* first, const osmium::NodeRef* last, TFunc&& func) {
+                constexpr const std::size_t chunk_size = 256;
+                double lat[chunk_size];
+                double y[chunk_size];
+
+                while (first != last) {
+                    const std::size_t n = std::min(chunk_size, static_cast<std::size_t>(last - first));
+                    for (std::size_t i = 0; i < n; ++i) {
+                        lat[i] = first[i].location().lat();
+                    }
+
+                    // This is the loop the compiler can vectorize.
+                    for (std::size_t i = 0; i < n; ++i) {
+                        y[i] = lat_to_y_approx(lat[i]);
+                    }
+
+                    for (std::size_t i = 0; i < n; ++i) {
+                        func(to_tile_grid(lon_to_x(first[i].location().lon_without_check()),
+                                          std::abs(lat[i]) <= MERCATOR_MAX_LAT ? y[i] : lat_to_y(lat[i])));
+                    }
+                    first += n;
+                }
+            }
+
+            /**
+             * Add all tiles touched by the segment from p0 to p1 to the
+             * vector (supercover). This walks from tile to tile along
+             * the segment deciding at each step by comparing integer
+             * cross products whether the segment leaves the current tile
+             * through a vertical or a horizontal tile border. If the
+             * segment goes exactly through a tile corner, both tiles
+             * next to the corner are added.
+             */
+            inline void add_segment_tiles(uint32_t zoom, const tile_grid_point& p0, const tile_grid_point& p1, std::vector<Tile>& tiles) {
+                const int shift = tile_grid_bits - int(zoom);
+                const int64_t size = int64_t(1) << shift;
+
+                int64_t tx = p0.x >> shift;
+                int64_t ty = p0.y >> shift;
+                const int64_t tx_end = p1.x >> shift;
+                const int64_t ty_end = p1.y >> shift;
+
+                const int64_t step_x = p1.x > p0.x ? 1 : -1;
+                const int64_t step_y = p1.y > p0.y ? 1 : -1;
+                const int64_t dx = std::abs(p1.x - p0.x);
+                const int64_t dy = std::abs(p1.y - p0.y);
+
+                tiles.emplace_back(zoom, uint32_t(tx), uint32_t(ty));
+                while (tx != tx_end || ty != ty_end) {
+                    bool move_x = ty == ty_end;
+                    bool move_y = tx == tx_end;
+                    if (!move_x && !move_y) {
+                        // Distances to the next tile border in x and y
+                        // direction. The segment crosses the border
+                        // reached at the smaller parameter first.
+                        const int64_t bx = std::abs((step_x > 0 ? (tx + 1) * size : tx * size) - p0.x);
+                        const int64_t by = std::abs((step_y > 0 ? (ty + 1) * size : ty * size) - p0.y);
+                        const int64_t cx = bx * dy;
+                        const int64_t cy = by * dx;
+                        move_x = cx <= cy;
+                        move_y = cy <= cx;
+                        if (move_x && move_y) {
+                            tiles.emplace_back(zoom, uint32_t(tx + step_x), uint32_t(ty));
+                            tiles.emplace_back(zoom, uint32_t(tx), uint32_t(ty + step_y));
+                        }
+                    }
+                    if (move_x) {
+                        tx += step_x;
+                    }
+                    if (move_y) {
+                        ty += step_y;
+                    }
+                    tiles.emplace_back(zoom, uint32_t(tx), uint32_t(ty));
+                }
+            }
+
+            inline void add_linestring_tiles(uint32_t zoom, const osmium::NodeRefList& nodes, std::vector<Tile>& tiles) {
+                const int shift = tile_grid_bits - int(zoom);
+                bool first = true;
+                tile_grid_point previous{0, 0};
+                for_each_tile_grid_point(nodes.cbegin(), nodes.cend(), [&](const tile_grid_point& p) {
+                    if (first) {
+                        tiles.emplace_back(zoom, uint32_t(p.x >> shift), uint32_t(p.y >> shift));
+                        first = false;
+                    } else {
+                        add_segment_tiles(zoom, previous, p, tiles);
+                    }
+                    previous = p;
+                });
+            }
+
+            /**
+             * Add the x coordinates where the segments of the ring cross
+             * the horizontal lines through the centers of the tile rows
+             * to the vector. Each crossing is stored as pair of tile row
+             * and x coordinate. Ranges are half-open in y direction so
+             * that vertices on a center line are only counted once.
+             */
+            inline void add_ring_crossings(uint32_t zoom, const osmium::NodeRefList& ring, std::vector<std::pair<int64_t, int64_t>>& crossings) {
+                const int shift = tile_grid_bits - int(zoom);
+                const int64_t size = int64_t(1) << shift;
+                const int64_t half = size / 2;
+
+                bool first = true;
+                tile_grid_point p0{0, 0};
+                for_each_tile_grid_point(ring.cbegin(), ring.cend(), [&](const tile_grid_point& p1) {
+                    if (!first && p0.y != p1.y) {
+                        const tile_grid_point& a = p0.y < p1.y ? p0 : p1;
+                        const tile_grid_point& b = p0.y < p1.y ? p1 : p0;
+                        // start with the first row whose center is >= a.y
+                        for (int64_t row = (a.y - half + size - 1) >> shift; row * size + half < b.y; ++row) {
+                            const int64_t cy = row * size + half;
+                            const int64_t x = a.x + (cy - a.y) * (b.x - a.x) / (b.y - a.y);
+                            crossings.emplace_back(row, x);
+                        }
+                    }
+                    first = false;
+                    p0 = p1;
+                });
+            }
+
+            inline void sort_and_unique(std::vector<Tile>& tiles) {
+                std::sort(tiles.begin(), tiles.end());
+                tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+            }
+
+        } // namespace detail
+
+        /**
+         * Get all tiles on the given zoom level touched by the segments
+         * of the way. Tiles are found by walking along each segment on
+         * an integer grid, so this also finds tiles crossed by a segment
+         * which don't contain any node of the way.
+         *
+         * The tiles vector is cleared first, so it can be re-used for
+         * many ways without allocating. On return it contains each tile
+         * once sorted by x and then y coordinate.
+         *
+         * Segments are not wrapped around at the antimeridian.
+         *
+         * @pre @code zoom <= 30 @endcode
+         * @throws osmium::invalid_location if any node has an invalid
+         *         location.
+         */
+        inline void tiles_for(const osmium::Way& way, uint32_t zoom, std::vector<Tile>& tiles) {
+            assert(zoom <= 30u);
+            tiles.clear();
+            detail::add_linestring_tiles(zoom, way.nodes(), tiles);
+            detail::sort_and_unique(tiles);
+        }
+
+        /**
+         * Scratch space used by tiles_for(const osmium::Area&, uint32_t,
+         * std::vector<Tile>&, tile_crossings_type&) for the crossings of
+         * the area rings with the tile row center lines.
+         */
+        using tile_crossings_type = std::vector<std::pair<int64_t, int64_t>>;
+
+        /**
+         * Get all tiles on the given zoom level touched by the area. These
+         * are the tiles touched by the segments of any of its rings (see
+         * tiles_for(const osmium::Way&, uint32_t, std::vector<Tile>&))
+         * plus all tiles completely inside the area which are found by
+         * a scanline fill through the centers of the tile rows.
+         *
+         * Note that for large areas on high zoom levels the number of
+         * tiles can get very large.
+         *
+         * The tiles and crossings vectors are cleared first, so they can
+         * be re-used for many areas without allocating. On return the
+         * tiles vector contains each tile once sorted by x and then y
+         * coordinate.
+         *
+         * @pre @code zoom <= 30 @endcode
+         * @throws osmium::invalid_location if any node has an invalid
+         *         location.
+         */
+        inline void tiles_for(const osmium::Area& area, uint32_t zoom, std::vector<Tile>& tiles, tile_crossings_type& crossings) {
+            assert(zoom <= 30u);
+            tiles.clear();
+            crossings.clear();
+
+            for (const auto& outer : area.outer_rings()) {
+                detail::add_linestring_tiles(zoom, outer, tiles);
+                detail::add_ring_crossings(zoom, outer, crossings);
+                for (const auto& inner : area.inner_rings(outer)) {
+                    detail::add_linestring_tiles(zoom, inner, tiles);
+                    detail::add_ring_crossings(zoom, inner, crossings);
+                }
+            }
+
+            // Each pair of crossings in a tile row (even-odd rule) encloses
+            // a part of the row center line inside the area.
+            std::sort(crossings.begin(), crossings.end());
+            const int shift = detail::tile_grid_bits - int(zoom);
+            for (auto it = crossings.cbegin(); it != crossings.cend() && std::next(it) != crossings.cend(); it += 2) {
+                const auto next = std::next(it);
+                assert(it->first == next->first);
+                const uint32_t row = uint32_t(it->first);
+                for (int64_t tx = it->second >> shift; tx <= (next->second >> shift); ++tx) {
+                    tiles.emplace_back(zoom, uint32_t(tx), row);
+                }
+            }
+
+            detail::sort_and_unique(tiles);
+        }
+
+        /**
+         * Get all tiles on the given zoom level touched by the area. Same
+         * as the version of this function with the crossings parameter,
+         * but allocates the scratch space on each call.
+         *
+         * @pre @code zoom <= 30 @endcode
+         * @throws osmium::invalid_location if any node has an invalid
+         *         location.
+         */
+        inline void tiles_for(const osmium::Area& area, uint32_t zoom, std::vector<Tile>& tiles) {
+            tile_crossings_type crossings;
+            tiles_for(area, zoom, tiles, crossings);
+        }
+
     } // namespace geom
 
 } // namespace osmium
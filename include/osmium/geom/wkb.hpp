@@ -39,6 +39,7 @@ DEALINGS IN THE SOFTWARE.
 #include <string>
 
 #include <osmium/geom/coordinates.hpp>
+#include <osmium/geom/detail/string_output.hpp>
 #include <osmium/geom/factory.hpp>
 #include <osmium/util/cast.hpp>
 #include <osmium/util/endian.hpp>
@@ -64,20 +65,75 @@ namespace osmium {
                 str.append(reinterpret_cast<const char*>(&data), sizeof(T));
             }
 
-            inline std::string convert_to_hex(const std::string& str) {
-                static const char* lookup_hex = "0123456789ABCDEF";
-                std::string out;
-                out.reserve(str.size() * 2);
+            /**
+             * Lookup table with the two hex digits for each byte value.
+             */
+            inline const char* hex_byte_table() noexcept {
+                static const char* table =
+                    "000102030405060708090A0B0C0D0E0F"
+                    "101112131415161718191A1B1C1D1E1F"
+                    "202122232425262728292A2B2C2D2E2F"
+                    "303132333435363738393A3B3C3D3E3F"
+                    "404142434445464748494A4B4C4D4E4F"
+                    "505152535455565758595A5B5C5D5E5F"
+                    "606162636465666768696A6B6C6D6E6F"
+                    "707172737475767778797A7B7C7D7E7F"
+                    "808182838485868788898A8B8C8D8E8F"
+                    "909192939495969798999A9B9C9D9E9F"
+                    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAF"
+                    "B0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+                    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF"
+                    "D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+                    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEF"
+                    "F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+                return table;
+            }
 
-                for (char c : str) {
-                    out += lookup_hex[(c >> 4) & 0xf];
-                    out += lookup_hex[c & 0xf];
+            /**
+             * Write the hex representation of size bytes starting at data
+             * to out (which must have space for 2 * size chars).
+             */
+            inline void write_hex(char* out, const char* data, size_t size) noexcept {
+                const char* table = hex_byte_table();
+                for (size_t i = 0; i < size; ++i) {
+                    const char* hex = table + 2 * static_cast<unsigned char>(data[i]);
+                    *out++ = hex[0];
+                    *out++ = hex[1];
                 }
+            }
+
+            /**
+             * Append the hex representation of size bytes starting at data
+             * to the string.
+             */
+            inline void append_hex(std::string& str, const char* data, size_t size) {
+                const size_t pos = str.size();
+                str.resize(pos + 2 * size);
+                write_hex(&str[pos], data, size);
+            }
 
+            template <typename T>
+            inline void str_push_hex(std::string& str, T data) {
+                append_hex(str, reinterpret_cast<const char*>(&data), sizeof(T));
+            }
+
+            inline std::string convert_to_hex(const std::string& str) {
+                std::string out;
+                append_hex(out, str.data(), str.size());
                 return out;
             }
 
-            class WKBFactoryImpl {
+            /**
+             * WKB geometry factory implementation. The TOutput policy decides
+             * whether each geometry is returned as a new std::string
+             * (string_output) or appended to a string owned by the caller
+             * (append_output).
+             *
+             * In hex mode the hex representation is written directly, there
+             * is no intermediate binary string.
+             */
+            template <typename TOutput>
+            class BasicWKBFactoryImpl {
 
                 /**
                 * Type of WKB geometry.
@@ -107,7 +163,7 @@ namespace osmium {
                     NDR = 1          // Little Endian
                 }; // enum class wkb_byte_order_type
 
-                std::string m_data;
+                TOutput m_output;
                 uint32_t m_points {0};
                 int m_srid;
                 wkb_type m_wkb_type;
@@ -120,39 +176,61 @@ namespace osmium {
                 size_t m_polygon_size_offset = 0;
                 size_t m_ring_size_offset = 0;
 
+                template <typename T>
+                void push(std::string& str, T data) const {
+                    if (m_out_type == out_type::hex) {
+                        str_push_hex(str, data);
+                    } else {
+                        str_push(str, data);
+                    }
+                }
+
                 size_t header(std::string& str, wkbGeometryType type, bool add_length) const {
 #if __BYTE_ORDER == __LITTLE_ENDIAN
-                    str_push(str, wkb_byte_order_type::NDR);
+                    push(str, wkb_byte_order_type::NDR);
 #else
-                    str_push(str, wkb_byte_order_type::XDR);
+                    push(str, wkb_byte_order_type::XDR);
 #endif
                     if (m_wkb_type == wkb_type::ewkb) {
-                        str_push(str, type | wkbSRID);
-                        str_push(str, m_srid);
+                        push(str, type | wkbSRID);
+                        push(str, m_srid);
                     } else {
-                        str_push(str, type);
+                        push(str, type);
                     }
                     const size_t offset = str.size();
                     if (add_length) {
-                        str_push(str, static_cast<uint32_t>(0));
+                        push(str, static_cast<uint32_t>(0));
                     }
                     return offset;
                 }
 
                 void set_size(const size_t offset, const size_t size) {
                     uint32_t s = static_cast_with_assert<uint32_t>(size);
-                    std::copy_n(reinterpret_cast<char*>(&s), sizeof(uint32_t), &m_data[offset]);
+                    std::string& str = m_output.buffer();
+                    if (m_out_type == out_type::hex) {
+                        write_hex(&str[offset], reinterpret_cast<const char*>(&s), sizeof(uint32_t));
+                    } else {
+                        std::copy_n(reinterpret_cast<char*>(&s), sizeof(uint32_t), &str[offset]);
+                    }
                 }
 
             public:
 
-                using point_type        = std::string;
-                using linestring_type   = std::string;
-                using polygon_type      = std::string;
-                using multipolygon_type = std::string;
-                using ring_type         = std::string;
+                using point_type        = typename TOutput::result_type;
+                using linestring_type   = typename TOutput::result_type;
+                using polygon_type      = typename TOutput::result_type;
+                using multipolygon_type = typename TOutput::result_type;
+                using ring_type         = typename TOutput::result_type;
 
-                explicit WKBFactoryImpl(int srid, wkb_type wtype = wkb_type::wkb, out_type otype = out_type::binary) :
+                explicit BasicWKBFactoryImpl(int srid, wkb_type wtype = wkb_type::wkb, out_type otype = out_type::binary) :
+                    m_output(),
+                    m_srid(srid),
+                    m_wkb_type(wtype),
+                    m_out_type(otype) {
+                }
+
+                BasicWKBFactoryImpl(int srid, std::string& out, wkb_type wtype = wkb_type::wkb, out_type otype = out_type::binary) :
+                    m_output(out),
                     m_srid(srid),
                     m_wkb_type(wtype),
                     m_out_type(otype) {
@@ -161,56 +239,40 @@ namespace osmium {
                 /* Point */
 
                 point_type make_point(const osmium::geom::Coordinates& xy) const {
-                    std::string data;
-                    header(data, wkbPoint, false);
-                    str_push(data, xy.x);
-                    str_push(data, xy.y);
-
-                    if (m_out_type == out_type::hex) {
-                        return convert_to_hex(data);
-                    } else {
-                        return data;
-                    }
+                    return m_output.single([this, &xy](std::string& str) {
+                        header(str, wkbPoint, false);
+                        push(str, xy.x);
+                        push(str, xy.y);
+                    });
                 }
 
                 /* LineString */
 
                 void linestring_start() {
-                    m_data.clear();
-                    m_linestring_size_offset = header(m_data, wkbLineString, true);
+                    m_linestring_size_offset = header(m_output.start(), wkbLineString, true);
                 }
 
                 void linestring_add_location(const osmium::geom::Coordinates& xy) {
-                    str_push(m_data, xy.x);
-                    str_push(m_data, xy.y);
+                    push(m_output.buffer(), xy.x);
+                    push(m_output.buffer(), xy.y);
                 }
 
                 linestring_type linestring_finish(size_t num_points) {
                     set_size(m_linestring_size_offset, num_points);
-                    std::string data;
-
-                    using std::swap;
-                    swap(data, m_data);
-
-                    if (m_out_type == out_type::hex) {
-                        return convert_to_hex(data);
-                    } else {
-                        return data;
-                    }
+                    return m_output.finish();
                 }
 
                 /* MultiPolygon */
 
                 void multipolygon_start() {
-                    m_data.clear();
                     m_polygons = 0;
-                    m_multipolygon_size_offset = header(m_data, wkbMultiPolygon, true);
+                    m_multipolygon_size_offset = header(m_output.start(), wkbMultiPolygon, true);
                 }
 
                 void multipolygon_polygon_start() {
                     ++m_polygons;
                     m_rings = 0;
-                    m_polygon_size_offset = header(m_data, wkbPolygon, true);
+                    m_polygon_size_offset = header(m_output.buffer(), wkbPolygon, true);
                 }
 
                 void multipolygon_polygon_finish() {
@@ -220,8 +282,8 @@ namespace osmium {
                 void multipolygon_outer_ring_start() {
                     ++m_rings;
                     m_points = 0;
-                    m_ring_size_offset = m_data.size();
-                    str_push(m_data, static_cast<uint32_t>(0));
+                    m_ring_size_offset = m_output.buffer().size();
+                    push(m_output.buffer(), static_cast<uint32_t>(0));
                 }
 
                 void multipolygon_outer_ring_finish() {
@@ -231,8 +293,8 @@ namespace osmium {
                 void multipolygon_inner_ring_start() {
                     ++m_rings;
                     m_points = 0;
-                    m_ring_size_offset = m_data.size();
-                    str_push(m_data, static_cast<uint32_t>(0));
+                    m_ring_size_offset = m_output.buffer().size();
+                    push(m_output.buffer(), static_cast<uint32_t>(0));
                 }
 
                 void multipolygon_inner_ring_finish() {
@@ -240,32 +302,38 @@ namespace osmium {
                 }
 
                 void multipolygon_add_location(const osmium::geom::Coordinates& xy) {
-                    str_push(m_data, xy.x);
-                    str_push(m_data, xy.y);
+                    push(m_output.buffer(), xy.x);
+                    push(m_output.buffer(), xy.y);
                     ++m_points;
                 }
 
                 multipolygon_type multipolygon_finish() {
                     set_size(m_multipolygon_size_offset, m_polygons);
-                    std::string data;
-
-                    using std::swap;
-                    swap(data, m_data);
-
-                    if (m_out_type == out_type::hex) {
-                        return convert_to_hex(data);
-                    } else {
-                        return data;
-                    }
+                    return m_output.finish();
                 }
 
-            }; // class WKBFactoryImpl
+            }; // class BasicWKBFactoryImpl
+
+            using WKBFactoryImpl = BasicWKBFactoryImpl<string_output>;
 
         } // namespace detail
 
+        /**
+         * Factory for WKB geometries. Each geometry is returned as a
+         * std::string.
+         */
         template <typename TProjection = IdentityProjection>
         using WKBFactory = GeometryFactory<osmium::geom::detail::WKBFactoryImpl, TProjection>;
 
+        /**
+         * Factory for WKB geometries that appends all geometries to a
+         * std::string given to the constructor (before the other
+         * parameters) instead of returning them. See
+         * detail::append_output for details.
+         */
+        template <typename TProjection = IdentityProjection>
+        using WKBAppendFactory = GeometryFactory<osmium::geom::detail::BasicWKBFactoryImpl<osmium::geom::detail::append_output>, TProjection>;
+
     } // namespace geom
 
 } // namespace osmium
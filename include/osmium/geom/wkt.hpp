@@ -39,6 +39,7 @@ DEALINGS IN THE SOFTWARE.
 #include <utility>
 
 #include <osmium/geom/coordinates.hpp>
+#include <osmium/geom/detail/string_output.hpp>
 #include <osmium/geom/factory.hpp>
 
 namespace osmium {
@@ -52,120 +53,150 @@ namespace osmium {
 
         namespace detail {
 
-            class WKTFactoryImpl {
+            /**
+             * WKT geometry factory implementation. The TOutput policy decides
+             * whether each geometry is returned as a new std::string
+             * (string_output) or appended to a string owned by the caller
+             * (append_output).
+             */
+            template <typename TOutput>
+            class BasicWKTFactoryImpl {
 
+                TOutput m_output;
                 std::string m_srid_prefix;
-                std::string m_str;
                 int m_precision;
                 wkt_type m_wkt_type;
 
+                void set_srid_prefix(int srid) {
+                    if (m_wkt_type == wkt_type::ewkt) {
+                        m_srid_prefix = "SRID=";
+                        m_srid_prefix += std::to_string(srid);
+                        m_srid_prefix += ';';
+                    }
+                }
+
             public:
 
-                using point_type        = std::string;
-                using linestring_type   = std::string;
-                using polygon_type      = std::string;
-                using multipolygon_type = std::string;
-                using ring_type         = std::string;
+                using point_type        = typename TOutput::result_type;
+                using linestring_type   = typename TOutput::result_type;
+                using polygon_type      = typename TOutput::result_type;
+                using multipolygon_type = typename TOutput::result_type;
+                using ring_type         = typename TOutput::result_type;
 
-                WKTFactoryImpl(int srid, int precision = 7, wkt_type wtype = wkt_type::wkt) :
+                BasicWKTFactoryImpl(int srid, int precision = 7, wkt_type wtype = wkt_type::wkt) :
+                    m_output(),
                     m_srid_prefix(),
                     m_precision(precision),
                     m_wkt_type(wtype) {
-                    if (m_wkt_type == wkt_type::ewkt) {
-                        m_srid_prefix = "SRID=";
-                        m_srid_prefix += std::to_string(srid);
-                        m_srid_prefix += ';';
-                    }
+                    set_srid_prefix(srid);
+                }
+
+                BasicWKTFactoryImpl(int srid, std::string& out, int precision = 7, wkt_type wtype = wkt_type::wkt) :
+                    m_output(out),
+                    m_srid_prefix(),
+                    m_precision(precision),
+                    m_wkt_type(wtype) {
+                    set_srid_prefix(srid);
                 }
 
                 /* Point */
 
                 point_type make_point(const osmium::geom::Coordinates& xy) const {
-                    std::string str {m_srid_prefix};
-                    str += "POINT";
-                    xy.append_to_string(str, '(', ' ', ')', m_precision);
-                    return str;
+                    return m_output.single([this, &xy](std::string& str) {
+                        str += m_srid_prefix;
+                        str += "POINT";
+                        xy.append_to_string(str, '(', ' ', ')', m_precision);
+                    });
                 }
 
                 /* LineString */
 
                 void linestring_start() {
-                    m_str = m_srid_prefix;
-                    m_str += "LINESTRING(";
+                    std::string& str = m_output.start();
+                    str += m_srid_prefix;
+                    str += "LINESTRING(";
                 }
 
                 void linestring_add_location(const osmium::geom::Coordinates& xy) {
-                    xy.append_to_string(m_str, ' ', m_precision);
-                    m_str += ',';
+                    xy.append_to_string(m_output.buffer(), ' ', m_precision);
+                    m_output.buffer() += ',';
                 }
 
                 linestring_type linestring_finish(size_t /* num_points */) {
-                    assert(!m_str.empty());
-                    std::string str;
-
-                    using std::swap;
-                    swap(str, m_str);
-
+                    std::string& str = m_output.buffer();
+                    assert(!str.empty());
                     str.back() = ')';
-                    return str;
+                    return m_output.finish();
                 }
 
                 /* MultiPolygon */
 
                 void multipolygon_start() {
-                    m_str = m_srid_prefix;
-                    m_str += "MULTIPOLYGON(";
+                    std::string& str = m_output.start();
+                    str += m_srid_prefix;
+                    str += "MULTIPOLYGON(";
                 }
 
                 void multipolygon_polygon_start() {
-                    m_str += '(';
+                    m_output.buffer() += '(';
                 }
 
                 void multipolygon_polygon_finish() {
-                    m_str += "),";
+                    m_output.buffer() += "),";
                 }
 
                 void multipolygon_outer_ring_start() {
-                    m_str += '(';
+                    m_output.buffer() += '(';
                 }
 
                 void multipolygon_outer_ring_finish() {
-                    assert(!m_str.empty());
-                    m_str.back() = ')';
+                    assert(!m_output.buffer().empty());
+                    m_output.buffer().back() = ')';
                 }
 
                 void multipolygon_inner_ring_start() {
-                    m_str += ",(";
+                    m_output.buffer() += ",(";
                 }
 
                 void multipolygon_inner_ring_finish() {
-                    assert(!m_str.empty());
-                    m_str.back() = ')';
+                    assert(!m_output.buffer().empty());
+                    m_output.buffer().back() = ')';
                 }
 
                 void multipolygon_add_location(const osmium::geom::Coordinates& xy) {
-                    xy.append_to_string(m_str, ' ', m_precision);
-                    m_str += ',';
+                    xy.append_to_string(m_output.buffer(), ' ', m_precision);
+                    m_output.buffer() += ',';
                 }
 
                 multipolygon_type multipolygon_finish() {
-                    assert(!m_str.empty());
-                    std::string str;
-
-                    using std::swap;
-                    swap(str, m_str);
-
+                    std::string& str = m_output.buffer();
+                    assert(!str.empty());
                     str.back() = ')';
-                    return str;
+                    return m_output.finish();
                 }
 
-            }; // class WKTFactoryImpl
+            }; // class BasicWKTFactoryImpl
+
+            using WKTFactoryImpl = BasicWKTFactoryImpl<string_output>;
 
         } // namespace detail
 
+        /**
+         * Factory for WKT geometries. Each geometry is returned as a
+         * std::string.
+         */
         template <typename TProjection = IdentityProjection>
         using WKTFactory = GeometryFactory<osmium::geom::detail::WKTFactoryImpl, TProjection>;
 
+        /**
+         * Factory for WKT geometries that appends all geometries to a
+         * std::string given to the constructor (before the other
+         * parameters) instead of returning them. See
+         * detail::append_output for details.
+         */
+        template <typename TProjection = IdentityProjection>
+        using WKTAppendFactory = GeometryFactory<osmium::geom::detail::BasicWKTFactoryImpl<osmium::geom::detail::append_output>, TProjection>;
+
     } // namespace geom
 
 } // namespace osmium
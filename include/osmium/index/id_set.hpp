@@ -34,11 +34,17 @@ DEALINGS IN THE SOFTWARE.
 */
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
 #include <type_traits>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <osmium/osm/item_type.hpp>
@@ -310,6 +316,309 @@ namespace osmium {
 
         }; // class IdSetDense
 
+        namespace detail {
+
+            inline int id_set_count_trailing_zeros(uint64_t word) noexcept {
+                assert(word != 0);
+#if defined(__GNUC__) || defined(__clang__)
+                return __builtin_ctzll(word);
+#else
+                int n = 0;
+                while ((word & 1u) == 0) {
+                    word >>= 1u;
+                    ++n;
+                }
+                return n;
+#endif
+            }
+
+            inline uint32_t id_set_popcount(uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+                return static_cast<uint32_t>(__builtin_popcountll(word));
+#else
+                uint32_t n = 0;
+                for (; word; word &= word - 1) {
+                    ++n;
+                }
+                return n;
+#endif
+            }
+
+        } // namespace detail
+
+        template <typename T>
+        class IdSetDenseConcurrent;
+
+        /**
+         * Const_iterator for iterating over a IdSetDenseConcurrent.
+         */
+        template <typename T>
+        class IdSetDenseConcurrentIterator {
+
+            const IdSetDenseConcurrent<T>* m_set;
+
+            // Wider than T, because the end of the set can be one past
+            // the largest value of T.
+            uint64_t m_value;
+
+        public:
+
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = T;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = value_type*;
+            using reference         = value_type&;
+
+            IdSetDenseConcurrentIterator(const IdSetDenseConcurrent<T>* set, uint64_t value) noexcept :
+                m_set(set),
+                m_value(set->next_set(value)) {
+            }
+
+            IdSetDenseConcurrentIterator<T>& operator++() noexcept {
+                if (m_value != m_set->last()) {
+                    m_value = m_set->next_set(m_value + 1);
+                }
+                return *this;
+            }
+
+            IdSetDenseConcurrentIterator<T> operator++(int) noexcept {
+                IdSetDenseConcurrentIterator<T> tmp(*this);
+                operator++();
+                return tmp;
+            }
+
+            bool operator==(const IdSetDenseConcurrentIterator<T>& rhs) const noexcept {
+                return m_set == rhs.m_set && m_value == rhs.m_value;
+            }
+
+            bool operator!=(const IdSetDenseConcurrentIterator<T>& rhs) const noexcept {
+                return ! (*this == rhs);
+            }
+
+            T operator*() const noexcept {
+                assert(m_value < m_set->last());
+                return static_cast<T>(m_value);
+            }
+
+        }; // class IdSetDenseConcurrentIterator
+
+        /**
+         * A set of Ids of the given type like IdSetDense, but the
+         * functions check_and_set(), set(), unset(), get(), empty(), and
+         * size() can be called from several threads at the same time
+         * without any locking. Bits are changed with atomic operations,
+         * and chunks are allocated lock-free as needed. If two threads
+         * allocate the same chunk, one of them wins and the other one
+         * releases its allocation again.
+         *
+         * The largest Id that can be stored must be given in the
+         * constructor, because the table of chunks can not grow
+         * concurrently. Only the table (8 bytes per 32M Ids) is allocated
+         * up front, chunks are still allocated only when needed.
+         *
+         * Iterating and clear() must not be used while other threads
+         * change the set.
+         */
+        template <typename T>
+        class IdSetDenseConcurrent : public IdSet<T> {
+
+            static_assert(std::is_unsigned<T>::value, "Needs unsigned type");
+            static_assert(sizeof(T) >= 4, "Needs at least 32bit type");
+
+            friend class IdSetDenseConcurrentIterator<T>;
+
+            using word_type = std::atomic<uint64_t>;
+
+            // Each chunk contains bits for 2^chunk_bits Ids (4 MByte).
+            constexpr static const size_t chunk_bits = 25;
+            constexpr static const size_t words_per_chunk = (1ull << chunk_bits) / 64;
+
+            std::unique_ptr<std::atomic<word_type*>[]> m_chunks;
+            size_t m_num_chunks;
+            std::atomic<T> m_size;
+
+            static uint64_t bitmask(T id) noexcept {
+                return 1ull << (id & 63u);
+            }
+
+            static size_t word_offset(T id) noexcept {
+                return static_cast<size_t>(id >> 6u) & (words_per_chunk - 1);
+            }
+
+            // One past the largest Id that can be stored. This doesn't
+            // always fit into T, so it is returned as uint64_t.
+            uint64_t last() const noexcept {
+                return static_cast<uint64_t>(m_num_chunks) << chunk_bits;
+            }
+
+            word_type* find_chunk(T id) const noexcept {
+                const auto cid = static_cast<size_t>(id >> chunk_bits);
+                if (cid >= m_num_chunks) {
+                    return nullptr;
+                }
+                return m_chunks[cid].load(std::memory_order_acquire);
+            }
+
+            word_type& get_word(T id) {
+                const auto cid = static_cast<size_t>(id >> chunk_bits);
+                if (cid >= m_num_chunks) {
+                    throw std::out_of_range{"Id too large for IdSetDenseConcurrent"};
+                }
+
+                auto& slot = m_chunks[cid];
+                word_type* chunk = slot.load(std::memory_order_acquire);
+                if (!chunk) {
+                    // value-initialization sets all words to 0
+                    std::unique_ptr<word_type[]> new_chunk{new word_type[words_per_chunk]()};
+                    if (slot.compare_exchange_strong(chunk, new_chunk.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        chunk = new_chunk.release();
+                    }
+                }
+
+                return chunk[word_offset(id)];
+            }
+
+            // Get the smallest Id in the set not smaller than the given
+            // Id or last() if there is none.
+            uint64_t next_set(uint64_t id) const noexcept {
+                while (id < last()) {
+                    const word_type* chunk = find_chunk(static_cast<T>(id));
+                    if (!chunk) {
+                        id = ((id >> chunk_bits) + 1) << chunk_bits;
+                        continue;
+                    }
+                    const uint64_t word = chunk[word_offset(static_cast<T>(id))].load(std::memory_order_relaxed) & (~0ull << (id & 63u));
+                    if (word) {
+                        return (id & ~63ull) + detail::id_set_count_trailing_zeros(word);
+                    }
+                    id = (id | 63u) + 1;
+                }
+                return last();
+            }
+
+        public:
+
+            using const_iterator = IdSetDenseConcurrentIterator<T>;
+
+            /**
+             * Create a set.
+             *
+             * @param max_id The largest Id that can be stored in the set.
+             *               The default is enough for about 34 billion
+             *               Ids.
+             */
+            explicit IdSetDenseConcurrent(T max_id = static_cast<T>((1ull << 35u) - 1)) :
+                m_chunks(),
+                m_num_chunks(static_cast<size_t>(max_id >> chunk_bits) + 1),
+                m_size(0) {
+                m_chunks.reset(new std::atomic<word_type*>[m_num_chunks]);
+                for (size_t n = 0; n < m_num_chunks; ++n) {
+                    m_chunks[n].store(nullptr, std::memory_order_relaxed);
+                }
+            }
+
+            IdSetDenseConcurrent(const IdSetDenseConcurrent&) = delete;
+            IdSetDenseConcurrent& operator=(const IdSetDenseConcurrent&) = delete;
+
+            IdSetDenseConcurrent(IdSetDenseConcurrent&&) = delete;
+            IdSetDenseConcurrent& operator=(IdSetDenseConcurrent&&) = delete;
+
+            ~IdSetDenseConcurrent() noexcept {
+                clear();
+            }
+
+            /**
+             * Add the Id to the set if it is not already in there.
+             *
+             * @param id The Id to set.
+             * @returns true if the Id was added, false if it was already set.
+             * @throws std::out_of_range if the Id is larger than the
+             *         max_id given in the constructor.
+             */
+            bool check_and_set(T id) {
+                const uint64_t old = get_word(id).fetch_or(bitmask(id), std::memory_order_relaxed);
+                if ((old & bitmask(id)) != 0) {
+                    return false;
+                }
+                m_size.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            /**
+             * Add the given Id to the set.
+             *
+             * @param id The Id to set.
+             * @throws std::out_of_range if the Id is larger than the
+             *         max_id given in the constructor.
+             */
+            void set(T id) override final {
+                (void)check_and_set(id);
+            }
+
+            /**
+             * Remove the given Id from the set.
+             *
+             * @param id The Id to set.
+             */
+            void unset(T id) {
+                word_type* chunk = find_chunk(id);
+                if (!chunk) {
+                    return;
+                }
+                const uint64_t old = chunk[word_offset(id)].fetch_and(~bitmask(id), std::memory_order_relaxed);
+                if ((old & bitmask(id)) != 0) {
+                    m_size.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+
+            /**
+             * Is the Id in the set?
+             *
+             * @param id The Id to check.
+             */
+            bool get(T id) const noexcept override final {
+                const word_type* chunk = find_chunk(id);
+                if (!chunk) {
+                    return false;
+                }
+                return (chunk[word_offset(id)].load(std::memory_order_relaxed) & bitmask(id)) != 0;
+            }
+
+            /**
+             * Is the set empty?
+             */
+            bool empty() const noexcept override final {
+                return size() == 0;
+            }
+
+            /**
+             * The number of Ids stored in the set.
+             */
+            T size() const noexcept {
+                return m_size.load(std::memory_order_relaxed);
+            }
+
+            /**
+             * Clear the set. Must not be called while other threads are
+             * using the set.
+             */
+            void clear() override final {
+                for (size_t n = 0; n < m_num_chunks; ++n) {
+                    delete[] m_chunks[n].exchange(nullptr, std::memory_order_acq_rel);
+                }
+                m_size.store(0, std::memory_order_relaxed);
+            }
+
+            IdSetDenseConcurrentIterator<T> begin() const {
+                return IdSetDenseConcurrentIterator<T>{this, 0};
+            }
+
+            IdSetDenseConcurrentIterator<T> end() const {
+                return IdSetDenseConcurrentIterator<T>{this, last()};
+            }
+
+        }; // class IdSetDenseConcurrent
+
         /**
          * IdSet implementation for small Id sets. It writes the Ids
          * into a vector and uses linear search.
@@ -408,6 +717,717 @@ namespace osmium {
 
         }; // class IdSetSmall
 
+        namespace detail {
+
+            /**
+             * Container for the lower 16 bits of all Ids in an
+             * IdSetCompressed sharing the same upper bits. Depending on
+             * the number and distribution of the values, one of three
+             * representations is used:
+             *
+             * * array: Sorted vector of the values. Used for up to 4096
+             *          values.
+             * * bitmap: 65536 bits (8 kByte). Used for more values.
+             * * run: Sorted vector of (start, length - 1) pairs. Only
+             *        created by optimize() if that is smaller than the
+             *        other representations. Changing a run container
+             *        converts it into one of the other representations.
+             */
+            class id_set_container {
+
+            public:
+
+                enum class container_type : uint8_t {
+                    array  = 0,
+                    bitmap = 1,
+                    run    = 2
+                };
+
+                enum : uint32_t {
+                    // One more than the largest value in a container.
+                    max_value = 1u << 16u,
+                    max_array_size = 4096,
+                    bitmap_words = max_value / 64
+                };
+
+            private:
+
+                container_type m_type = container_type::array;
+                uint32_t m_cardinality = 0;
+
+                // Values for array container or pairs of (start,
+                // length - 1) for run container.
+                std::vector<uint16_t> m_values;
+
+                // Bits for bitmap container.
+                std::vector<uint64_t> m_bits;
+
+                static uint64_t bit(uint32_t value) noexcept {
+                    return 1ull << (value & 63u);
+                }
+
+                // Index of the first run not ending before value.
+                size_t find_run(uint32_t value) const noexcept {
+                    size_t lo = 0;
+                    size_t hi = m_values.size() / 2;
+                    while (lo < hi) {
+                        const size_t mid = (lo + hi) / 2;
+                        if (static_cast<uint32_t>(m_values[mid * 2]) + m_values[mid * 2 + 1] < value) {
+                            lo = mid + 1;
+                        } else {
+                            hi = mid;
+                        }
+                    }
+                    return lo;
+                }
+
+                void to_bitmap() {
+                    std::vector<uint64_t> bits(bitmap_words, 0);
+                    for_each([&bits](uint32_t value) {
+                        bits[value >> 6u] |= bit(value);
+                    });
+                    m_bits.swap(bits);
+                    std::vector<uint16_t>{}.swap(m_values);
+                    m_type = container_type::bitmap;
+                }
+
+                void to_array() {
+                    std::vector<uint16_t> values;
+                    values.reserve(m_cardinality);
+                    for_each([&values](uint32_t value) {
+                        values.push_back(static_cast<uint16_t>(value));
+                    });
+                    m_values.swap(values);
+                    std::vector<uint64_t>{}.swap(m_bits);
+                    m_type = container_type::array;
+                }
+
+                // Convert run container into array or bitmap container
+                // depending on the expected number of values.
+                void expand_run(uint32_t expected_cardinality) {
+                    assert(m_type == container_type::run);
+                    if (expected_cardinality > max_array_size) {
+                        to_bitmap();
+                    } else {
+                        to_array();
+                    }
+                }
+
+                void count_bits() noexcept {
+                    m_cardinality = 0;
+                    for (const auto word : m_bits) {
+                        m_cardinality += id_set_popcount(word);
+                    }
+                }
+
+            public:
+
+                container_type type() const noexcept {
+                    return m_type;
+                }
+
+                uint32_t cardinality() const noexcept {
+                    return m_cardinality;
+                }
+
+                bool empty() const noexcept {
+                    return m_cardinality == 0;
+                }
+
+                bool get(uint32_t value) const noexcept {
+                    switch (m_type) {
+                        case container_type::array:
+                            return std::binary_search(m_values.cbegin(), m_values.cend(), static_cast<uint16_t>(value));
+                        case container_type::bitmap:
+                            return (m_bits[value >> 6u] & bit(value)) != 0;
+                        case container_type::run:
+                            break;
+                    }
+                    const size_t run = find_run(value);
+                    return run < m_values.size() / 2 && m_values[run * 2] <= value;
+                }
+
+                bool check_and_set(uint32_t value) {
+                    switch (m_type) {
+                        case container_type::array: {
+                                const auto it = std::lower_bound(m_values.begin(), m_values.end(), static_cast<uint16_t>(value));
+                                if (it != m_values.end() && *it == value) {
+                                    return false;
+                                }
+                                if (m_cardinality < max_array_size) {
+                                    m_values.insert(it, static_cast<uint16_t>(value));
+                                    ++m_cardinality;
+                                    return true;
+                                }
+                                to_bitmap();
+                            }
+                            break;
+                        case container_type::bitmap:
+                            break;
+                        case container_type::run:
+                            if (get(value)) {
+                                return false;
+                            }
+                            expand_run(m_cardinality + 1);
+                            return check_and_set(value);
+                    }
+
+                    auto& word = m_bits[value >> 6u];
+                    if ((word & bit(value)) != 0) {
+                        return false;
+                    }
+                    word |= bit(value);
+                    ++m_cardinality;
+                    return true;
+                }
+
+                bool unset(uint32_t value) {
+                    switch (m_type) {
+                        case container_type::array: {
+                                const auto it = std::lower_bound(m_values.begin(), m_values.end(), static_cast<uint16_t>(value));
+                                if (it == m_values.end() || *it != value) {
+                                    return false;
+                                }
+                                m_values.erase(it);
+                                --m_cardinality;
+                                return true;
+                            }
+                        case container_type::bitmap:
+                            break;
+                        case container_type::run:
+                            if (!get(value)) {
+                                return false;
+                            }
+                            expand_run(m_cardinality);
+                            return unset(value);
+                    }
+
+                    auto& word = m_bits[value >> 6u];
+                    if ((word & bit(value)) == 0) {
+                        return false;
+                    }
+                    word &= ~bit(value);
+                    --m_cardinality;
+                    // Convert only when well below the limit, so that
+                    // alternating set() and unset() calls don't convert
+                    // back and forth all the time.
+                    if (m_cardinality <= max_array_size / 2) {
+                        to_array();
+                    }
+                    return true;
+                }
+
+                /**
+                 * Get the smallest value in the container which is not
+                 * smaller than the given value. Returns max_value if there
+                 * is none.
+                 */
+                uint32_t next_value(uint32_t value) const noexcept {
+                    if (value >= max_value) {
+                        return max_value;
+                    }
+                    switch (m_type) {
+                        case container_type::array: {
+                                const auto it = std::lower_bound(m_values.cbegin(), m_values.cend(), static_cast<uint16_t>(value));
+                                return it == m_values.cend() ? static_cast<uint32_t>(max_value) : *it;
+                            }
+                        case container_type::bitmap: {
+                                uint32_t w = value >> 6u;
+                                uint64_t word = m_bits[w] & (~0ull << (value & 63u));
+                                while (word == 0) {
+                                    if (++w == bitmap_words) {
+                                        return max_value;
+                                    }
+                                    word = m_bits[w];
+                                }
+                                return w * 64 + static_cast<uint32_t>(id_set_count_trailing_zeros(word));
+                            }
+                        case container_type::run:
+                            break;
+                    }
+                    const size_t run = find_run(value);
+                    if (run == m_values.size() / 2) {
+                        return max_value;
+                    }
+                    return std::max(value, static_cast<uint32_t>(m_values[run * 2]));
+                }
+
+                /**
+                 * Call func with each value in the container in order.
+                 */
+                template <typename TFunc>
+                void for_each(TFunc&& func) const {
+                    switch (m_type) {
+                        case container_type::array:
+                            for (const auto value : m_values) {
+                                func(static_cast<uint32_t>(value));
+                            }
+                            break;
+                        case container_type::bitmap:
+                            for (uint32_t w = 0; w < bitmap_words; ++w) {
+                                for (uint64_t word = m_bits[w]; word; word &= word - 1) {
+                                    func(w * 64 + static_cast<uint32_t>(id_set_count_trailing_zeros(word)));
+                                }
+                            }
+                            break;
+                        case container_type::run:
+                            for (size_t n = 0; n < m_values.size(); n += 2) {
+                                const uint32_t end = static_cast<uint32_t>(m_values[n]) + m_values[n + 1];
+                                for (uint32_t value = m_values[n]; value <= end; ++value) {
+                                    func(value);
+                                }
+                            }
+                            break;
+                    }
+                }
+
+                /**
+                 * Add all values from the other container to this one.
+                 */
+                void unite(const id_set_container& other) {
+                    if (other.empty()) {
+                        return;
+                    }
+                    if (m_type == container_type::run) {
+                        expand_run(m_cardinality + other.m_cardinality);
+                    }
+
+                    if (m_type == container_type::array && other.m_type == container_type::array) {
+                        std::vector<uint16_t> values;
+                        values.reserve(m_values.size() + other.m_values.size());
+                        std::set_union(m_values.cbegin(), m_values.cend(),
+                                       other.m_values.cbegin(), other.m_values.cend(),
+                                       std::back_inserter(values));
+                        m_values.swap(values);
+                        m_cardinality = static_cast<uint32_t>(m_values.size());
+                        if (m_cardinality > max_array_size) {
+                            to_bitmap();
+                        }
+                        return;
+                    }
+
+                    if (m_type != container_type::bitmap) {
+                        to_bitmap();
+                    }
+                    if (other.m_type == container_type::bitmap) {
+                        for (uint32_t w = 0; w < bitmap_words; ++w) {
+                            m_bits[w] |= other.m_bits[w];
+                        }
+                    } else {
+                        other.for_each([this](uint32_t value) {
+                            m_bits[value >> 6u] |= bit(value);
+                        });
+                    }
+                    count_bits();
+                }
+
+                /**
+                 * Remove all values from this container which are not in
+                 * the other container.
+                 */
+                void intersect(const id_set_container& other) {
+                    if (m_type == container_type::run) {
+                        expand_run(std::min(m_cardinality, other.m_cardinality));
+                    }
+
+                    if (m_type == container_type::array) {
+                        const auto last = std::remove_if(m_values.begin(), m_values.end(), [&other](uint16_t value) {
+                            return !other.get(value);
+                        });
+                        m_values.erase(last, m_values.end());
+                        m_cardinality = static_cast<uint32_t>(m_values.size());
+                        return;
+                    }
+
+                    if (other.m_type == container_type::bitmap) {
+                        for (uint32_t w = 0; w < bitmap_words; ++w) {
+                            m_bits[w] &= other.m_bits[w];
+                        }
+                    } else {
+                        std::vector<uint64_t> bits(bitmap_words, 0);
+                        other.for_each([this, &bits](uint32_t value) {
+                            bits[value >> 6u] |= m_bits[value >> 6u] & bit(value);
+                        });
+                        m_bits.swap(bits);
+                    }
+                    count_bits();
+                    if (m_cardinality <= max_array_size) {
+                        to_array();
+                    }
+                }
+
+                /**
+                 * Convert the container into a run container if that
+                 * needs less memory. Also releases unused memory.
+                 */
+                void optimize() {
+                    if (m_type == container_type::run) {
+                        m_values.shrink_to_fit();
+                        return;
+                    }
+
+                    size_t runs = 0;
+                    uint32_t previous = max_value;
+                    for_each([&runs, &previous](uint32_t value) {
+                        if (value != previous + 1) {
+                            ++runs;
+                        }
+                        previous = value;
+                    });
+
+                    const size_t current_size = m_type == container_type::array ? m_cardinality * sizeof(uint16_t)
+                                                                                 : bitmap_words * sizeof(uint64_t);
+                    if (runs * 2 * sizeof(uint16_t) >= current_size) {
+                        m_values.shrink_to_fit();
+                        return;
+                    }
+
+                    std::vector<uint16_t> values;
+                    values.reserve(runs * 2);
+                    for_each([&values](uint32_t value) {
+                        if (!values.empty() && static_cast<uint32_t>(values[values.size() - 2]) + values.back() + 1 == value) {
+                            ++values.back();
+                        } else {
+                            values.push_back(static_cast<uint16_t>(value));
+                            values.push_back(0);
+                        }
+                    });
+                    m_values.swap(values);
+                    std::vector<uint64_t>{}.swap(m_bits);
+                    m_type = container_type::run;
+                }
+
+                /// The memory used by this container in bytes.
+                size_t used_memory() const noexcept {
+                    return sizeof(id_set_container) +
+                           m_values.capacity() * sizeof(uint16_t) +
+                           m_bits.capacity() * sizeof(uint64_t);
+                }
+
+            }; // class id_set_container
+
+        } // namespace detail
+
+        template <typename T>
+        class IdSetCompressed;
+
+        /**
+         * Const_iterator for iterating over a IdSetCompressed.
+         */
+        template <typename T>
+        class IdSetCompressedIterator {
+
+            const IdSetCompressed<T>* m_set;
+            size_t m_container;
+            uint32_t m_value;
+
+            // Skip to the next container if the current one is done.
+            void next_container() noexcept {
+                while (m_container < m_set->m_containers.size() &&
+                       m_value == detail::id_set_container::max_value) {
+                    ++m_container;
+                    m_value = m_container < m_set->m_containers.size() ? m_set->m_containers[m_container].next_value(0) : 0;
+                }
+            }
+
+        public:
+
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = T;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = value_type*;
+            using reference         = value_type&;
+
+            IdSetCompressedIterator(const IdSetCompressed<T>* set, size_t container) noexcept :
+                m_set(set),
+                m_container(container),
+                m_value(container < set->m_containers.size() ? set->m_containers[container].next_value(0) : 0) {
+                next_container();
+            }
+
+            IdSetCompressedIterator<T>& operator++() noexcept {
+                if (m_container < m_set->m_containers.size()) {
+                    m_value = m_set->m_containers[m_container].next_value(m_value + 1);
+                    next_container();
+                }
+                return *this;
+            }
+
+            IdSetCompressedIterator<T> operator++(int) noexcept {
+                IdSetCompressedIterator<T> tmp(*this);
+                operator++();
+                return tmp;
+            }
+
+            bool operator==(const IdSetCompressedIterator<T>& rhs) const noexcept {
+                return m_set == rhs.m_set && m_container == rhs.m_container && m_value == rhs.m_value;
+            }
+
+            bool operator!=(const IdSetCompressedIterator<T>& rhs) const noexcept {
+                return ! (*this == rhs);
+            }
+
+            T operator*() const noexcept {
+                assert(m_container < m_set->m_containers.size());
+                return (m_set->m_keys[m_container] << 16u) | m_value;
+            }
+
+        }; // class IdSetCompressedIterator
+
+        /**
+         * A set of Ids of the given type. The Ids are split into the
+         * upper bits and the lower 16 bits. For each value of the upper
+         * bits a container stores the lower bits as sorted array (for
+         * sparse Ids), as bitmap (for dense Ids) or as list of runs (for
+         * Ids in consecutive ranges, see optimize()). This is similar to
+         * "Roaring Bitmaps". Depending on the distribution of the Ids this
+         * needs much less memory than IdSetDense while still being fast.
+         * Adding Ids in order is faster than adding them in random order.
+         */
+        template <typename T>
+        class IdSetCompressed : public IdSet<T> {
+
+            static_assert(std::is_unsigned<T>::value, "Needs unsigned type");
+            static_assert(sizeof(T) >= 4, "Needs at least 32bit type");
+
+            friend class IdSetCompressedIterator<T>;
+
+            // Upper bits of the Ids in the containers, sorted.
+            std::vector<T> m_keys;
+            std::vector<detail::id_set_container> m_containers;
+            T m_size = 0;
+
+            static T key(T id) noexcept {
+                return id >> 16u;
+            }
+
+            static uint32_t low(T id) noexcept {
+                return static_cast<uint32_t>(id & 0xffffu);
+            }
+
+            size_t find_index(T k) const noexcept {
+                if (!m_keys.empty() && m_keys.back() == k) {
+                    return m_keys.size() - 1;
+                }
+                return static_cast<size_t>(std::lower_bound(m_keys.cbegin(), m_keys.cend(), k) - m_keys.cbegin());
+            }
+
+            void remove_container(size_t index) {
+                m_keys.erase(m_keys.begin() + static_cast<std::ptrdiff_t>(index));
+                m_containers.erase(m_containers.begin() + static_cast<std::ptrdiff_t>(index));
+            }
+
+            void count() noexcept {
+                m_size = 0;
+                for (const auto& container : m_containers) {
+                    m_size += container.cardinality();
+                }
+            }
+
+        public:
+
+            using const_iterator = IdSetCompressedIterator<T>;
+
+            IdSetCompressed() = default;
+
+            /**
+             * Add the Id to the set if it is not already in there.
+             *
+             * @param id The Id to set.
+             * @returns true if the Id was added, false if it was already set.
+             */
+            bool check_and_set(T id) {
+                const T k = key(id);
+                const size_t index = find_index(k);
+                if (index == m_keys.size() || m_keys[index] != k) {
+                    m_keys.insert(m_keys.begin() + static_cast<std::ptrdiff_t>(index), k);
+                    m_containers.insert(m_containers.begin() + static_cast<std::ptrdiff_t>(index), detail::id_set_container{});
+                }
+
+                if (m_containers[index].check_and_set(low(id))) {
+                    ++m_size;
+                    return true;
+                }
+
+                return false;
+            }
+
+            /**
+             * Add the given Id to the set.
+             *
+             * @param id The Id to set.
+             */
+            void set(T id) override final {
+                (void)check_and_set(id);
+            }
+
+            /**
+             * Remove the given Id from the set.
+             *
+             * @param id The Id to set.
+             */
+            void unset(T id) {
+                const size_t index = find_index(key(id));
+                if (index == m_keys.size() || m_keys[index] != key(id)) {
+                    return;
+                }
+
+                auto& container = m_containers[index];
+                if (container.unset(low(id))) {
+                    --m_size;
+                    if (container.empty()) {
+                        remove_container(index);
+                    }
+                }
+            }
+
+            /**
+             * Is the Id in the set?
+             *
+             * @param id The Id to check.
+             */
+            bool get(T id) const noexcept override final {
+                const size_t index = find_index(key(id));
+                if (index == m_keys.size() || m_keys[index] != key(id)) {
+                    return false;
+                }
+                return m_containers[index].get(low(id));
+            }
+
+            /**
+             * Is the set empty?
+             */
+            bool empty() const noexcept override final {
+                return m_size == 0;
+            }
+
+            /**
+             * The number of Ids stored in the set.
+             */
+            T size() const noexcept {
+                return m_size;
+            }
+
+            /**
+             * Clear the set.
+             */
+            void clear() override final {
+                m_keys.clear();
+                m_containers.clear();
+                m_size = 0;
+            }
+
+            /**
+             * Add all Ids from the other set to this set.
+             */
+            IdSetCompressed<T>& operator|=(const IdSetCompressed<T>& other) {
+                if (&other == this) {
+                    return *this;
+                }
+
+                std::vector<T> keys;
+                std::vector<detail::id_set_container> containers;
+                keys.reserve(m_keys.size() + other.m_keys.size());
+                containers.reserve(m_keys.size() + other.m_keys.size());
+
+                size_t i = 0;
+                size_t j = 0;
+                while (i < m_keys.size() || j < other.m_keys.size()) {
+                    if (j == other.m_keys.size() || (i < m_keys.size() && m_keys[i] < other.m_keys[j])) {
+                        keys.push_back(m_keys[i]);
+                        containers.push_back(std::move(m_containers[i]));
+                        ++i;
+                    } else if (i == m_keys.size() || other.m_keys[j] < m_keys[i]) {
+                        keys.push_back(other.m_keys[j]);
+                        containers.push_back(other.m_containers[j]);
+                        ++j;
+                    } else {
+                        keys.push_back(m_keys[i]);
+                        containers.push_back(std::move(m_containers[i]));
+                        containers.back().unite(other.m_containers[j]);
+                        ++i;
+                        ++j;
+                    }
+                }
+
+                m_keys.swap(keys);
+                m_containers.swap(containers);
+                count();
+                return *this;
+            }
+
+            /**
+             * Remove all Ids from this set that are not in the other set.
+             */
+            IdSetCompressed<T>& operator&=(const IdSetCompressed<T>& other) {
+                if (&other == this) {
+                    return *this;
+                }
+
+                size_t out = 0;
+                size_t j = 0;
+                for (size_t i = 0; i < m_keys.size(); ++i) {
+                    while (j < other.m_keys.size() && other.m_keys[j] < m_keys[i]) {
+                        ++j;
+                    }
+                    if (j == other.m_keys.size()) {
+                        break;
+                    }
+                    if (other.m_keys[j] != m_keys[i]) {
+                        continue;
+                    }
+                    m_containers[i].intersect(other.m_containers[j]);
+                    if (!m_containers[i].empty()) {
+                        if (out != i) {
+                            m_keys[out] = m_keys[i];
+                            m_containers[out] = std::move(m_containers[i]);
+                        }
+                        ++out;
+                    }
+                }
+
+                m_keys.resize(out);
+                m_containers.erase(m_containers.begin() + static_cast<std::ptrdiff_t>(out), m_containers.end());
+                count();
+                return *this;
+            }
+
+            /**
+             * Convert containers with Ids in consecutive ranges into a
+             * more compact representation and release unused memory.
+             * Call this after adding all Ids if the set is kept around.
+             */
+            void optimize() {
+                for (auto& container : m_containers) {
+                    container.optimize();
+                }
+                m_keys.shrink_to_fit();
+                m_containers.shrink_to_fit();
+            }
+
+            /**
+             * The memory used by this set in bytes (not counting the
+             * size of the set object itself).
+             */
+            size_t used_memory() const noexcept {
+                size_t memory = m_keys.capacity() * sizeof(T) +
+                                (m_containers.capacity() - m_containers.size()) * sizeof(detail::id_set_container);
+                for (const auto& container : m_containers) {
+                    memory += container.used_memory();
+                }
+                return memory;
+            }
+
+            IdSetCompressedIterator<T> begin() const {
+                return IdSetCompressedIterator<T>{this, 0};
+            }
+
+            IdSetCompressedIterator<T> end() const {
+                return IdSetCompressedIterator<T>{this, m_containers.size()};
+            }
+
+        }; // class IdSetCompressed
+
         template <template<typename> class IdSetType>
         class NWRIdSet {
 
@@ -206,7 +206,7 @@ namespace osmium {
 
                 void write_timestamp(const osmium::Timestamp& timestamp) {
                     if (timestamp.valid()) {
-                        *m_out += timestamp.to_iso();
+                        timestamp.to_iso_str(*m_out);
                         *m_out += " (";
                         output_int(timestamp.seconds_since_epoch());
                         *m_out += ')';
@@ -98,7 +98,7 @@ namespace osmium {
 
                 void write_field_timestamp(char c, const osmium::Timestamp& timestamp) {
                     *m_out += c;
-                    *m_out += timestamp.to_iso();
+                    timestamp.to_iso_str(*m_out);
                 }
 
                 void write_tags(const osmium::TagList& tags) {
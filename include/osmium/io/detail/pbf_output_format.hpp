@@ -42,8 +42,10 @@ DEALINGS IN THE SOFTWARE.
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <protozero/pbf_builder.hpp>
+#include <protozero/pbf_reader.hpp>
 #include <protozero/pbf_writer.hpp>
 #include <protozero/types.hpp>
 
@@ -108,6 +110,14 @@ namespace osmium {
                 /// Should node locations be added to ways?
                 bool locations_on_ways;
 
+                /**
+                 * Should the string table of each block be sorted so that
+                 * the most often used strings get the smallest indexes?
+                 * This makes the blocks a bit smaller but needs some more
+                 * CPU time when writing.
+                 */
+                bool sort_stringtable;
+
             };
 
             /**
@@ -230,7 +240,6 @@ namespace osmium {
                 osmium::util::DeltaEncode<uint32_t, int64_t> m_delta_timestamp;
                 osmium::util::DeltaEncode<changeset_id_type, int64_t> m_delta_changeset;
                 osmium::util::DeltaEncode<user_id_type, int32_t> m_delta_uid;
-                osmium::util::DeltaEncode<uint32_t, int32_t> m_delta_user_sid;
 
                 osmium::util::DeltaEncode<int64_t, int64_t> m_delta_lat;
                 osmium::util::DeltaEncode<int64_t, int64_t> m_delta_lon;
@@ -264,7 +273,6 @@ namespace osmium {
                     m_delta_timestamp.clear();
                     m_delta_changeset.clear();
                     m_delta_uid.clear();
-                    m_delta_user_sid.clear();
 
                     m_delta_lat.clear();
                     m_delta_lon.clear();
@@ -282,7 +290,7 @@ namespace osmium {
                         m_timestamps.push_back(m_delta_timestamp.update(uint32_t(node.timestamp())));
                         m_changesets.push_back(m_delta_changeset.update(node.changeset()));
                         m_uids.push_back(m_delta_uid.update(node.uid()));
-                        m_user_sids.push_back(m_delta_user_sid.update(m_stringtable.add(node.user())));
+                        m_user_sids.push_back(static_cast_with_assert<int32_t>(m_stringtable.add(node.user())));
                         if (m_options.add_visible_flag) {
                             m_visibles.push_back(node.visible());
                         }
@@ -298,6 +306,19 @@ namespace osmium {
                     m_tags.push_back(0);
                 }
 
+                /**
+                 * Change all string table indexes using the given map
+                 * from old to new indexes.
+                 */
+                void remap_strings(const std::vector<uint32_t>& old_to_new) {
+                    for (auto& sid : m_user_sids) {
+                        sid = static_cast<int32_t>(old_to_new[sid]);
+                    }
+                    for (auto& sid : m_tags) {
+                        sid = static_cast<int32_t>(old_to_new[sid]);
+                    }
+                }
+
                 std::string serialize() const {
                     std::string data;
                     protozero::pbf_builder<OSMFormat::DenseNodes> pbf_dense_nodes(data);
@@ -310,7 +331,13 @@ namespace osmium {
                         pbf_dense_info.add_packed_sint64(OSMFormat::DenseInfo::packed_sint64_timestamp, m_timestamps.cbegin(), m_timestamps.cend());
                         pbf_dense_info.add_packed_sint64(OSMFormat::DenseInfo::packed_sint64_changeset, m_changesets.cbegin(), m_changesets.cend());
                         pbf_dense_info.add_packed_sint32(OSMFormat::DenseInfo::packed_sint32_uid, m_uids.cbegin(), m_uids.cend());
-                        pbf_dense_info.add_packed_sint32(OSMFormat::DenseInfo::packed_sint32_user_sid, m_user_sids.cbegin(), m_user_sids.cend());
+                        {
+                            osmium::util::DeltaEncode<int32_t, int32_t> delta_user_sid;
+                            protozero::packed_field_sint32 field{pbf_dense_info, protozero::pbf_tag_type(OSMFormat::DenseInfo::packed_sint32_user_sid)};
+                            for (const auto sid : m_user_sids) {
+                                field.add_element(delta_user_sid.update(sid));
+                            }
+                        }
 
                         if (m_options.add_visible_flag) {
                             pbf_dense_info.add_packed_bool(OSMFormat::DenseInfo::packed_bool_visible, m_visibles.cbegin(), m_visibles.cend());
@@ -327,6 +354,76 @@ namespace osmium {
 
             }; // class DenseNodes
 
+            /**
+             * Copy the field the reader is currently at unchanged to the
+             * writer.
+             */
+            inline void copy_pbf_field(protozero::pbf_reader& reader, protozero::pbf_writer& writer) {
+                const auto tag = reader.tag();
+                switch (reader.wire_type()) {
+                    case protozero::pbf_wire_type::varint:
+                        writer.add_uint64(tag, reader.get_uint64());
+                        break;
+                    case protozero::pbf_wire_type::fixed64:
+                        writer.add_fixed64(tag, reader.get_fixed64());
+                        break;
+                    case protozero::pbf_wire_type::length_delimited:
+                        writer.add_bytes(tag, reader.get_view());
+                        break;
+                    case protozero::pbf_wire_type::fixed32:
+                        writer.add_fixed32(tag, reader.get_fixed32());
+                        break;
+                    default:
+                        throw osmium::pbf_error("unknown pbf field type");
+                }
+            }
+
+            /**
+             * Copy a Node, Way, or Relation message replacing all string
+             * table indexes using the given map from old to new indexes.
+             * Keys, values, and info are at the same field numbers in all
+             * three messages, roles only exist in relations.
+             */
+            inline void remap_pbf_object(protozero::pbf_reader object, protozero::pbf_writer& writer, const std::vector<uint32_t>& old_to_new, bool is_relation) {
+                while (object.next()) {
+                    const auto tag = object.tag();
+                    switch (tag) {
+                        case protozero::pbf_tag_type(OSMFormat::Way::packed_uint32_keys):
+                        case protozero::pbf_tag_type(OSMFormat::Way::packed_uint32_vals): {
+                                protozero::packed_field_uint32 field{writer, tag};
+                                for (const auto sid : object.get_packed_uint32()) {
+                                    field.add_element(old_to_new[sid]);
+                                }
+                            }
+                            break;
+                        case protozero::pbf_tag_type(OSMFormat::Way::optional_Info_info): {
+                                protozero::pbf_writer pbf_info{writer, tag};
+                                protozero::pbf_reader info = object.get_message();
+                                while (info.next()) {
+                                    if (info.tag() == protozero::pbf_tag_type(OSMFormat::Info::optional_uint32_user_sid)) {
+                                        pbf_info.add_uint32(protozero::pbf_tag_type(OSMFormat::Info::optional_uint32_user_sid), old_to_new[info.get_uint32()]);
+                                    } else {
+                                        copy_pbf_field(info, pbf_info);
+                                    }
+                                }
+                            }
+                            break;
+                        case protozero::pbf_tag_type(OSMFormat::Relation::packed_int32_roles_sid):
+                            if (is_relation) {
+                                protozero::packed_field_int32 field{writer, tag};
+                                for (const auto sid : object.get_packed_int32()) {
+                                    field.add_element(static_cast<int32_t>(old_to_new[sid]));
+                                }
+                                break;
+                            }
+                            copy_pbf_field(object, writer);
+                            break;
+                        default:
+                            copy_pbf_field(object, writer);
+                    }
+                }
+            }
+
             class PrimitiveBlock {
 
                 std::string m_pbf_primitive_group_data;
@@ -354,6 +451,32 @@ namespace osmium {
                     return m_pbf_primitive_group_data;
                 }
 
+                /**
+                 * Sort the string table by frequency and change all string
+                 * table indexes in the data written so far accordingly.
+                 * Call this after the last object was added.
+                 */
+                void sort_stringtable() {
+                    const std::vector<uint32_t> old_to_new = m_stringtable.sort_by_frequency();
+
+                    if (type() == OSMFormat::PrimitiveGroup::optional_DenseNodes_dense) {
+                        m_dense_nodes.remap_strings(old_to_new);
+                        return;
+                    }
+
+                    std::string data;
+                    data.reserve(m_pbf_primitive_group_data.size());
+                    protozero::pbf_writer writer{data};
+                    protozero::pbf_reader group{m_pbf_primitive_group_data};
+                    while (group.next()) {
+                        const auto tag = group.tag();
+                        protozero::pbf_writer pbf_object{writer, tag};
+                        remap_pbf_object(group.get_message(), pbf_object, old_to_new,
+                                         tag == protozero::pbf_tag_type(OSMFormat::PrimitiveGroup::repeated_Relation_relations));
+                    }
+                    m_pbf_primitive_group_data.swap(data);
+                }
+
                 void reset(OSMFormat::PrimitiveGroup type) {
                     m_pbf_primitive_group_data.clear();
                     m_stringtable.clear();
@@ -363,8 +486,8 @@ namespace osmium {
                 }
 
                 void write_stringtable(protozero::pbf_builder<OSMFormat::StringTable>& pbf_string_table) {
-                    for (const char* s : m_stringtable) {
-                        pbf_string_table.add_bytes(OSMFormat::StringTable::repeated_bytes_s, s);
+                    for (auto it = m_stringtable.begin(); it != m_stringtable.end(); ++it) {
+                        pbf_string_table.add_bytes(OSMFormat::StringTable::repeated_bytes_s, *it, it.size());
                     }
                 }
 
@@ -425,6 +548,10 @@ namespace osmium {
                         return;
                     }
 
+                    if (m_options.sort_stringtable) {
+                        m_primitive_block.sort_stringtable();
+                    }
+
                     std::string primitive_block_data;
                     protozero::pbf_builder<OSMFormat::PrimitiveBlock> primitive_block(primitive_block_data);
 
@@ -491,6 +618,7 @@ namespace osmium {
                     m_options.add_historical_information_flag = file.has_multiple_object_versions();
                     m_options.add_visible_flag = file.has_multiple_object_versions();
                     m_options.locations_on_ways = file.is_true("locations_on_ways");
+                    m_options.sort_stringtable = file.is_true("pbf_sort_stringtable");
                 }
 
                 PBFOutputFormat(const PBFOutputFormat&) = delete;
@@ -0,0 +1,411 @@
+#ifndef OSMIUM_IO_DETAIL_PG_OUTPUT_FORMAT_HPP
+#define OSMIUM_IO_DETAIL_PG_OUTPUT_FORMAT_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <osmium/geom/factory.hpp>
+#include <osmium/geom/wkb.hpp>
+#include <osmium/io/detail/output_format.hpp>
+#include <osmium/io/detail/queue_util.hpp>
+#include <osmium/io/detail/string_util.hpp>
+#include <osmium/io/file.hpp>
+#include <osmium/io/file_format.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/area.hpp>
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/node.hpp>
+#include <osmium/osm/object.hpp>
+#include <osmium/osm/tag.hpp>
+#include <osmium/osm/timestamp.hpp>
+#include <osmium/osm/types.hpp>
+#include <osmium/osm/way.hpp>
+#include <osmium/thread/pool.hpp>
+#include <osmium/visitor.hpp>
+
+namespace osmium {
+
+    namespace io {
+
+        namespace detail {
+
+            enum class pg_tags_type {
+                json   = 0,
+                jsonb  = 1,
+                hstore = 2
+            };
+
+            struct pg_output_options {
+
+                /// Should metadata of objects be added?
+                bool add_metadata;
+
+                /// Use the binary COPY format instead of the text format?
+                bool use_binary;
+
+                /// Type of the tags column.
+                pg_tags_type tags_type;
+
+            };
+
+            /**
+             * Writes out one buffer with OSM data as rows for the PostgreSQL
+             * COPY command.
+             *
+             * Each node with a valid location, each way with node locations
+             * and each valid area results in one row with the columns:
+             *
+             * - geometry as EWKB (hex encoded in the text format) in
+             *   WGS84 (SRID 4326): a point, linestring, or multipolygon
+             * - object type ('n', 'w', or 'r', for areas the type of the
+             *   object the area was created from)
+             * - object id (for areas the id of the way or relation)
+             * - (only if metadata is enabled) version, changeset,
+             *   timestamp, uid, and user
+             * - tags as JSON or hstore
+             *
+             * All other objects (and objects for which no geometry can be
+             * created) are silently ignored.
+             */
+            class PgOutputBlock : public OutputBlock {
+
+                pg_output_options m_options;
+
+                osmium::geom::WKBAppendFactory<> m_factory;
+
+                // Used for building the tags column in text mode.
+                std::string m_tags;
+
+                template <typename T>
+                void append_binary_int(T value) {
+                    using utype = typename std::make_unsigned<T>::type;
+                    const auto v = static_cast<utype>(value);
+                    for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8) {
+                        *m_out += static_cast<char>((v >> shift) & 0xffu);
+                    }
+                }
+
+                // Start a field in binary mode by adding a placeholder for
+                // the length. Returns the position of the length.
+                size_t start_binary_field() {
+                    const size_t pos = m_out->size();
+                    append_binary_int<int32_t>(0);
+                    return pos;
+                }
+
+                void finish_binary_field(size_t pos) {
+                    const auto length = static_cast<uint32_t>(m_out->size() - pos - sizeof(int32_t));
+                    for (size_t i = 0; i < sizeof(int32_t); ++i) {
+                        (*m_out)[pos + i] = static_cast<char>((length >> (8 * (3 - i))) & 0xffu);
+                    }
+                }
+
+                void write_text_field(const char* data) {
+                    if (m_options.use_binary) {
+                        const size_t pos = start_binary_field();
+                        *m_out += data;
+                        finish_binary_field(pos);
+                    } else {
+                        *m_out += '\t';
+                        append_pg_copy_encoded_string(*m_out, data);
+                    }
+                }
+
+                template <typename T>
+                void write_int_field(T value) {
+                    if (m_options.use_binary) {
+                        append_binary_int<int32_t>(sizeof(T));
+                        append_binary_int<T>(value);
+                    } else {
+                        *m_out += '\t';
+                        output_int(value);
+                    }
+                }
+
+                void write_timestamp_field(const osmium::Timestamp& timestamp) {
+                    if (m_options.use_binary) {
+                        if (timestamp.valid()) {
+                            // microseconds since 2000-01-01T00:00:00Z
+                            append_binary_int<int32_t>(sizeof(int64_t));
+                            append_binary_int<int64_t>((static_cast<int64_t>(timestamp.seconds_since_epoch()) - 946684800) * 1000000);
+                        } else {
+                            append_binary_int<int32_t>(-1);
+                        }
+                    } else {
+                        *m_out += '\t';
+                        if (timestamp.valid()) {
+                            timestamp.to_iso_str(*m_out);
+                        } else {
+                            *m_out += "\\N";
+                        }
+                    }
+                }
+
+                static void append_hstore_encoded_string(std::string& out, const char* data) {
+                    out += '"';
+                    for (; *data != '\0'; ++data) {
+                        if (*data == '"' || *data == '\\') {
+                            out += '\\';
+                        }
+                        out += *data;
+                    }
+                    out += '"';
+                }
+
+                static void append_json_tags(std::string& out, const osmium::TagList& tags) {
+                    out += '{';
+                    for (const auto& tag : tags) {
+                        if (out.back() != '{') {
+                            out += ',';
+                        }
+                        out += '"';
+                        append_json_encoded_string(out, tag.key());
+                        out += "\":\"";
+                        append_json_encoded_string(out, tag.value());
+                        out += '"';
+                    }
+                    out += '}';
+                }
+
+                static void append_hstore_tags(std::string& out, const osmium::TagList& tags) {
+                    bool first = true;
+                    for (const auto& tag : tags) {
+                        if (first) {
+                            first = false;
+                        } else {
+                            out += ',';
+                        }
+                        append_hstore_encoded_string(out, tag.key());
+                        out += "=>";
+                        append_hstore_encoded_string(out, tag.value());
+                    }
+                }
+
+                void append_binary_hstore_tags(const osmium::TagList& tags) {
+                    append_binary_int<int32_t>(static_cast<int32_t>(tags.size()));
+                    for (const auto& tag : tags) {
+                        const size_t key_pos = start_binary_field();
+                        *m_out += tag.key();
+                        finish_binary_field(key_pos);
+                        const size_t value_pos = start_binary_field();
+                        *m_out += tag.value();
+                        finish_binary_field(value_pos);
+                    }
+                }
+
+                void write_tags_field(const osmium::TagList& tags) {
+                    if (m_options.use_binary) {
+                        const size_t pos = start_binary_field();
+                        if (m_options.tags_type == pg_tags_type::hstore) {
+                            append_binary_hstore_tags(tags);
+                        } else {
+                            if (m_options.tags_type == pg_tags_type::jsonb) {
+                                *m_out += '\x01'; // jsonb binary format version
+                            }
+                            append_json_tags(*m_out, tags);
+                        }
+                        finish_binary_field(pos);
+                        return;
+                    }
+
+                    m_tags.clear();
+                    if (m_options.tags_type == pg_tags_type::hstore) {
+                        append_hstore_tags(m_tags, tags);
+                    } else {
+                        append_json_tags(m_tags, tags);
+                    }
+                    *m_out += '\t';
+                    append_pg_copy_encoded_string(*m_out, m_tags.data(), m_tags.size());
+                }
+
+                /**
+                 * Write out a row for the object. The create_geometry
+                 * function is called to append the geometry to the output.
+                 * If it throws, the row is removed again.
+                 */
+                template <typename TFunc>
+                void write_row(const osmium::OSMObject& object, const char* type, osmium::object_id_type id, TFunc&& create_geometry) {
+                    const size_t row_start = m_out->size();
+
+                    try {
+                        if (m_options.use_binary) {
+                            append_binary_int<int16_t>(m_options.add_metadata ? 9 : 4);
+                            const size_t pos = start_binary_field();
+                            std::forward<TFunc>(create_geometry)();
+                            finish_binary_field(pos);
+                        } else {
+                            std::forward<TFunc>(create_geometry)();
+                        }
+                    } catch (const osmium::geometry_error&) {
+                        m_out->resize(row_start);
+                        return;
+                    } catch (const osmium::invalid_location&) {
+                        m_out->resize(row_start);
+                        return;
+                    }
+
+                    write_text_field(type);
+                    write_int_field<int64_t>(id);
+
+                    if (m_options.add_metadata) {
+                        write_int_field<int32_t>(static_cast<int32_t>(object.version()));
+                        write_int_field<int64_t>(object.changeset());
+                        write_timestamp_field(object.timestamp());
+                        write_int_field<int32_t>(static_cast<int32_t>(object.uid()));
+                        write_text_field(object.user());
+                    }
+
+                    write_tags_field(object.tags());
+
+                    if (!m_options.use_binary) {
+                        *m_out += '\n';
+                    }
+                }
+
+            public:
+
+                PgOutputBlock(osmium::memory::Buffer&& buffer, const pg_output_options& options) :
+                    OutputBlock(std::move(buffer)),
+                    m_options(options),
+                    m_factory(*m_out, osmium::geom::wkb_type::ewkb, options.use_binary ? osmium::geom::out_type::binary : osmium::geom::out_type::hex),
+                    m_tags() {
+                }
+
+                PgOutputBlock(const PgOutputBlock&) = default;
+                PgOutputBlock& operator=(const PgOutputBlock&) = default;
+
+                PgOutputBlock(PgOutputBlock&&) = default;
+                PgOutputBlock& operator=(PgOutputBlock&&) = default;
+
+                ~PgOutputBlock() noexcept = default;
+
+                std::string operator()() {
+                    osmium::apply(m_input_buffer->cbegin(), m_input_buffer->cend(), *this);
+
+                    std::string out;
+                    using std::swap;
+                    swap(out, *m_out);
+
+                    return out;
+                }
+
+                void node(const osmium::Node& node) {
+                    write_row(node, "n", node.id(), [this, &node]() {
+                        m_factory.create_point(node);
+                    });
+                }
+
+                void way(const osmium::Way& way) {
+                    write_row(way, "w", way.id(), [this, &way]() {
+                        m_factory.create_linestring(way);
+                    });
+                }
+
+                void area(const osmium::Area& area) {
+                    write_row(area, area.from_way() ? "w" : "r", area.orig_id(), [this, &area]() {
+                        m_factory.create_multipolygon(area);
+                    });
+                }
+
+            }; // class PgOutputBlock
+
+            class PgOutputFormat : public osmium::io::detail::OutputFormat {
+
+                pg_output_options m_options;
+
+            public:
+
+                PgOutputFormat(const osmium::io::File& file, future_string_queue_type& output_queue) :
+                    OutputFormat(output_queue),
+                    m_options() {
+                    m_options.add_metadata = file.is_true("add_metadata");
+                    m_options.use_binary   = file.is_true("pg_binary");
+                    const std::string tags_type = file.get("pg_tags");
+                    if (tags_type == "hstore") {
+                        m_options.tags_type = pg_tags_type::hstore;
+                    } else if (tags_type == "jsonb") {
+                        m_options.tags_type = pg_tags_type::jsonb;
+                    } else {
+                        m_options.tags_type = pg_tags_type::json;
+                    }
+                }
+
+                PgOutputFormat(const PgOutputFormat&) = delete;
+                PgOutputFormat& operator=(const PgOutputFormat&) = delete;
+
+                ~PgOutputFormat() noexcept final = default;
+
+                void write_header(const osmium::io::Header&) final {
+                    if (m_options.use_binary) {
+                        // signature, flags, and header extension length
+                        send_to_output_queue(std::string("PGCOPY\n\377\r\n\0\0\0\0\0\0\0\0\0", 19));
+                    }
+                }
+
+                void write_buffer(osmium::memory::Buffer&& buffer) final {
+                    m_output_queue.push(osmium::thread::Pool::instance().submit(PgOutputBlock{std::move(buffer), m_options}));
+                }
+
+                void write_end() final {
+                    if (m_options.use_binary) {
+                        send_to_output_queue(std::string("\377\377", 2));
+                    }
+                }
+
+            }; // class PgOutputFormat
+
+            // we want the register_output_format() function to run, setting
+            // the variable is only a side-effect, it will never be used
+            const bool registered_pg_output = osmium::io::detail::OutputFormatFactory::instance().register_output_format(osmium::io::file_format::pg,
+                [](const osmium::io::File& file, future_string_queue_type& output_queue) {
+                    return new osmium::io::detail::PgOutputFormat(file, output_queue);
+            });
+
+            // dummy function to silence the unused variable warning from above
+            inline bool get_registered_pg_output() noexcept {
+                return registered_pg_output;
+            }
+
+        } // namespace detail
+
+    } // namespace io
+
+} // namespace osmium
+
+#endif // OSMIUM_IO_DETAIL_PG_OUTPUT_FORMAT_HPP
@@ -36,6 +36,7 @@ DEALINGS IN THE SOFTWARE.
 #include <cerrno>
 #include <cstddef>
 #include <fcntl.h>
+#include <stdexcept>
 #include <string>
 #include <system_error>
 
@@ -154,6 +155,36 @@ namespace osmium {
                 reliable_write(fd, reinterpret_cast<const unsigned char*>(output_buffer), size);
             }
 
+            /**
+             * Reads the given number of bytes from the file descriptor into
+             * the input_buffer. This is just a wrapper around read(2),
+             * because read(2) can read less than the given number of bytes.
+             *
+             * @param fd File descriptor.
+             * @param input_buffer Buffer for the data. Must be at least size bytes long.
+             * @param size Number of bytes to read.
+             * @throws std::system_error On error.
+             * @throws std::runtime_error If the file ends before size bytes were read.
+             */
+            inline void reliable_read(const int fd, unsigned char* input_buffer, const size_t size) {
+                constexpr size_t max_read = 100L * 1024L * 1024L; // Max 100 MByte per read
+                size_t offset = 0;
+                while (offset < size) {
+                    auto read_count = size - offset;
+                    if (read_count > max_read) {
+                        read_count = max_read;
+                    }
+                    const auto length = ::read(fd, input_buffer + offset, static_cast<unsigned int>(read_count));
+                    if (length < 0) {
+                        throw std::system_error(errno, std::system_category(), "Read failed");
+                    }
+                    if (length == 0) {
+                        throw std::runtime_error("Unexpected end of file");
+                    }
+                    offset += static_cast<size_t>(length);
+                }
+            }
+
             inline void reliable_fsync(const int fd) {
 #ifdef _WIN32
                 if (_commit(fd) != 0) {
@@ -33,15 +33,17 @@ DEALINGS IN THE SOFTWARE.
 
 */
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <iterator>
 #include <list>
+#include <numeric>
 #include <string>
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <osmium/io/detail/pbf.hpp>
 
@@ -55,19 +57,25 @@ namespace osmium {
              * class StringStore
              *
              * Storage of lots of strings (const char *). Memory is allocated in chunks.
-             * If a string is added and there is no space in the current chunk, a new
-             * chunk will be allocated. Strings added to the store must not be larger
-             * than the chunk size.
+             * If a string is added and there is no space in the current chunk, the
+             * next chunk is used or, if there is none, a new chunk will be allocated.
+             * Strings added to the store must not be larger than the chunk size.
              *
-             * All memory is released when the destructor is called. There is no other way
-             * to release all or part of the memory.
+             * Calling clear() keeps all chunks so they can be re-used. All memory is
+             * released when the destructor is called.
              *
              */
             class StringStore {
 
+                using chunk_list = std::list<std::string>;
+
                 size_t m_chunk_size;
 
-                std::list<std::string> m_chunks;
+                chunk_list m_chunks;
+
+                // The chunk strings are currently added to. All chunks
+                // after this one are empty.
+                chunk_list::iterator m_current;
 
                 void add_chunk() {
                     m_chunks.emplace_back();
@@ -80,40 +88,64 @@ namespace osmium {
                     m_chunk_size(chunk_size),
                     m_chunks() {
                     add_chunk();
+                    m_current = m_chunks.begin();
                 }
 
+                StringStore(const StringStore&) = delete;
+                StringStore& operator=(const StringStore&) = delete;
+
+                /**
+                 * Remove all strings from the store. The memory is kept
+                 * for re-use.
+                 */
                 void clear() noexcept {
                     assert(!m_chunks.empty());
-                    m_chunks.erase(std::next(m_chunks.begin()), m_chunks.end());
-                    m_chunks.front().clear();
+                    for (auto it = m_chunks.begin(); it != std::next(m_current); ++it) {
+                        it->clear();
+                    }
+                    m_current = m_chunks.begin();
                 }
 
                 /**
-                 * Add a null terminated string to the store. This will
+                 * Add a string with the given size to the store. This will
                  * automatically get more memory if we are out.
-                 * Returns a pointer to the copy of the string we have
-                 * allocated.
+                 * Returns a pointer to the null terminated copy of the
+                 * string we have allocated.
                  */
-                const char* add(const char* string) {
-                    const size_t len = std::strlen(string) + 1;
+                const char* add(const char* string, size_t size) {
+                    const size_t len = size + 1;
 
                     assert(len <= m_chunk_size);
 
-                    size_t chunk_len = m_chunks.back().size();
-                    if (chunk_len + len > m_chunks.back().capacity()) {
-                        add_chunk();
+                    size_t chunk_len = m_current->size();
+                    if (chunk_len + len > m_current->capacity()) {
+                        ++m_current;
+                        if (m_current == m_chunks.end()) {
+                            add_chunk();
+                            m_current = std::prev(m_chunks.end());
+                        }
                         chunk_len = 0;
                     }
 
-                    m_chunks.back().append(string);
-                    m_chunks.back().append(1, '\0');
+                    m_current->append(string, size);
+                    m_current->append(1, '\0');
+
+                    return m_current->c_str() + chunk_len;
+                }
 
-                    return m_chunks.back().c_str() + chunk_len;
+                /**
+                 * Add a null terminated string to the store. This will
+                 * automatically get more memory if we are out.
+                 * Returns a pointer to the copy of the string we have
+                 * allocated.
+                 */
+                const char* add(const char* string) {
+                    return add(string, std::strlen(string));
                 }
 
                 class const_iterator {
 
-                    using it_type = std::list<std::string>::const_iterator;
+                    using it_type = chunk_list::const_iterator;
 
                     it_type m_it;
                     const it_type m_last;
@@ -175,11 +207,12 @@ namespace osmium {
                     if (m_chunks.front().empty()) {
                         return end();
                     }
-                    return const_iterator(m_chunks.begin(), m_chunks.end());
+                    return const_iterator(m_chunks.begin(), std::next(chunk_list::const_iterator(m_current)));
                 }
 
                 const_iterator end() const {
-                    return const_iterator(m_chunks.end(), m_chunks.end());
+                    const auto last = std::next(chunk_list::const_iterator(m_current));
+                    return const_iterator(last, last);
                 }
 
                 // These functions get you some idea how much memory was
@@ -188,38 +221,48 @@ namespace osmium {
                     return m_chunk_size;
                 }
 
+                /// The number of chunks currently in use.
                 size_t get_chunk_count() const noexcept {
+                    return static_cast<size_t>(std::distance(m_chunks.begin(), chunk_list::const_iterator(std::next(m_current))));
+                }
+
+                /// The number of chunks allocated (in use or not).
+                size_t get_allocated_chunk_count() const noexcept {
                     return m_chunks.size();
                 }
 
                 size_t get_used_bytes_in_last_chunk() const noexcept {
-                    return m_chunks.back().size();
+                    return m_current->size();
                 }
 
             }; // class StringStore
 
-            struct str_equal {
-
-                bool operator()(const char* lhs, const char* rhs) const noexcept {
-                    return lhs == rhs || std::strcmp(lhs, rhs) == 0;
+            /**
+             * Hash function for strings processing eight bytes at a
+             * time.
+             */
+            inline uint64_t string_hash(const char* str, size_t size) noexcept {
+                constexpr const uint64_t m = 0xff51afd7ed558ccdULL;
+                uint64_t hash = size * 0x9e3779b97f4a7c15ULL;
+
+                for (; size >= 8; str += 8, size -= 8) {
+                    uint64_t word;
+                    std::memcpy(&word, str, 8);
+                    hash = (hash ^ word) * m;
+                    hash ^= hash >> 32;
                 }
 
-            }; // struct str_equal
-
-            struct djb2_hash {
-
-                size_t operator()(const char* str) const noexcept {
-                    size_t hash = 5381;
-                    int c;
-
-                    while ((c = *str++)) {
-                        hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
-                    }
-
-                    return hash;
+                if (size > 0) {
+                    uint64_t word = 0;
+                    std::memcpy(&word, str, size);
+                    hash = (hash ^ word) * m;
                 }
 
-            }; // struct djb2_hash
+                hash ^= hash >> 29;
+                hash *= 0xc4ceb9fe1a85ec53ULL;
+                hash ^= hash >> 32;
+                return hash;
+            }
 
             class StringTable {
 
@@ -239,52 +282,188 @@ namespace osmium {
                 // allocation.
                 static constexpr const size_t default_stringtable_chunk_size = 100 * 1024;
 
+                static constexpr const size_t initial_index_size = 1024;
+
+                struct entry {
+                    const char* str;
+                    uint32_t size;
+                    uint32_t count;
+                };
+
                 StringStore m_strings;
-                std::unordered_map<const char*, size_t, djb2_hash, str_equal> m_index;
-                uint32_t m_size;
+
+                // Entry 0 is always the empty string which is never used
+                // as a real index in a PBF file.
+                std::vector<entry> m_entries;
+
+                // Open addressing hash table with indexes into m_entries.
+                // 0 marks an empty slot.
+                std::vector<uint32_t> m_index;
+
+                size_t find_slot(const char* s, size_t size) const noexcept {
+                    const size_t mask = m_index.size() - 1;
+                    for (size_t n = static_cast<size_t>(string_hash(s, size)) & mask; ; n = (n + 1) & mask) {
+                        const uint32_t id = m_index[n];
+                        if (id == 0 || (m_entries[id].size == size && !std::memcmp(m_entries[id].str, s, size))) {
+                            return n;
+                        }
+                    }
+                }
+
+                void grow_index() {
+                    m_index.assign(m_index.size() * 2, 0);
+                    for (uint32_t id = 1; id < m_entries.size(); ++id) {
+                        m_index[find_slot(m_entries[id].str, m_entries[id].size)] = id;
+                    }
+                }
+
+                void add_empty_entry() {
+                    m_entries.push_back(entry{m_strings.add("", 0), 0, 0});
+                }
 
             public:
 
+                class const_iterator {
+
+                    std::vector<entry>::const_iterator m_it;
+
+                public:
+
+                    using iterator_category = std::forward_iterator_tag;
+                    using value_type        = const char*;
+                    using difference_type   = std::ptrdiff_t;
+                    using pointer           = value_type*;
+                    using reference         = value_type&;
+
+                    explicit const_iterator(std::vector<entry>::const_iterator it) :
+                        m_it(it) {
+                    }
+
+                    const_iterator& operator++() {
+                        ++m_it;
+                        return *this;
+                    }
+
+                    const_iterator operator++(int) {
+                        const_iterator tmp(*this);
+                        operator++();
+                        return tmp;
+                    }
+
+                    bool operator==(const const_iterator& rhs) const {
+                        return m_it == rhs.m_it;
+                    }
+
+                    bool operator!=(const const_iterator& rhs) const {
+                        return !(*this == rhs);
+                    }
+
+                    const char* operator*() const {
+                        return m_it->str;
+                    }
+
+                    /// The size of the current string.
+                    size_t size() const noexcept {
+                        return m_it->size;
+                    }
+
+                }; // class const_iterator
+
                 explicit StringTable(size_t size = default_stringtable_chunk_size) :
                     m_strings(size),
-                    m_index(),
-                    m_size(0) {
-                    m_strings.add("");
+                    m_entries(),
+                    m_index(initial_index_size, 0) {
+                    add_empty_entry();
                 }
 
+                /**
+                 * Remove all strings from the table. All memory is kept
+                 * for re-use.
+                 */
                 void clear() {
                     m_strings.clear();
-                    m_index.clear();
-                    m_size = 0;
-                    m_strings.add("");
+                    m_entries.clear();
+                    std::fill(m_index.begin(), m_index.end(), 0);
+                    add_empty_entry();
                 }
 
                 uint32_t size() const noexcept {
-                    return m_size + 1;
+                    return static_cast<uint32_t>(m_entries.size());
                 }
 
-                uint32_t add(const char* s) {
-                    const auto f = m_index.find(s);
-                    if (f != m_index.end()) {
-                        return uint32_t(f->second);
+                /**
+                 * Add a string to the table if it isn't in there already.
+                 *
+                 * @returns The index of the string.
+                 * @throws osmium::pbf_error if the table is full.
+                 */
+                uint32_t add(const char* s, size_t size) {
+                    size_t slot = find_slot(s, size);
+                    uint32_t id = m_index[slot];
+                    if (id != 0) {
+                        ++m_entries[id].count;
+                        return id;
                     }
 
-                    const char* cs = m_strings.add(s);
-                    m_index[cs] = ++m_size;
-
-                    if (m_size > max_entries) {
+                    id = static_cast<uint32_t>(m_entries.size());
+                    if (id > max_entries) {
                         throw osmium::pbf_error("string table has too many entries");
                     }
 
-                    return m_size;
+                    m_entries.push_back(entry{m_strings.add(s, size), static_cast<uint32_t>(size), 1});
+
+                    // keep load factor below 1/2
+                    if (m_entries.size() * 2 > m_index.size()) {
+                        grow_index();
+                    } else {
+                        m_index[slot] = id;
+                    }
+
+                    return id;
                 }
 
-                StringStore::const_iterator begin() const {
-                    return m_strings.begin();
+                uint32_t add(const char* s) {
+                    return add(s, std::strlen(s));
                 }
 
-                StringStore::const_iterator end() const {
-                    return m_strings.end();
+                /**
+                 * Sort the strings so that the most often used strings
+                 * come first and get the smallest indexes. Strings used
+                 * equally often keep their order. The empty string at
+                 * index 0 stays where it is.
+                 *
+                 * @returns Vector mapping the old indexes to the new ones.
+                 */
+                std::vector<uint32_t> sort_by_frequency() {
+                    std::vector<uint32_t> order(m_entries.size());
+                    std::iota(order.begin(), order.end(), 0);
+                    std::stable_sort(std::next(order.begin()), order.end(), [this](uint32_t lhs, uint32_t rhs) {
+                        return m_entries[lhs].count > m_entries[rhs].count;
+                    });
+
+                    std::vector<uint32_t> old_to_new(m_entries.size());
+                    std::vector<entry> entries;
+                    entries.reserve(m_entries.size());
+                    for (uint32_t id = 0; id < order.size(); ++id) {
+                        old_to_new[order[id]] = id;
+                        entries.push_back(m_entries[order[id]]);
+                    }
+                    m_entries.swap(entries);
+
+                    std::fill(m_index.begin(), m_index.end(), 0);
+                    for (uint32_t id = 1; id < m_entries.size(); ++id) {
+                        m_index[find_slot(m_entries[id].str, m_entries[id].size)] = id;
+                    }
+
+                    return old_to_new;
+                }
+
+                const_iterator begin() const {
+                    return const_iterator(m_entries.cbegin());
+                }
+
+                const_iterator end() const {
+                    return const_iterator(m_entries.cend());
                 }
 
             }; // class StringTable
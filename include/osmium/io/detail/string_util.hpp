@@ -225,6 +225,49 @@ namespace osmium {
                 }
             }
 
+            // Write out the string escaped for use inside a JSON string.
+            inline void append_json_encoded_string(std::string& out, const char* data) {
+                static const char* lookup_hex = "0123456789abcdef";
+                for (; *data != '\0'; ++data) {
+                    switch(*data) {
+                        case '"':  out += "\\\""; break;
+                        case '\\': out += "\\\\"; break;
+                        case '\n': out += "\\n";  break;
+                        case '\r': out += "\\r";  break;
+                        case '\t': out += "\\t";  break;
+                        case '\b': out += "\\b";  break;
+                        case '\f': out += "\\f";  break;
+                        default:
+                            if (static_cast<unsigned char>(*data) < 0x20) {
+                                out += "\\u00";
+                                append_2_hex_digits(out, static_cast<unsigned char>(*data), lookup_hex);
+                            } else {
+                                out += *data;
+                            }
+                            break;
+                    }
+                }
+            }
+
+            // Write out the data escaped for use as a column value in
+            // the text format of the PostgreSQL COPY command.
+            inline void append_pg_copy_encoded_string(std::string& out, const char* data, size_t size) {
+                const char* end = data + size;
+                for (; data != end; ++data) {
+                    switch(*data) {
+                        case '\\': out += "\\\\"; break;
+                        case '\n': out += "\\n";  break;
+                        case '\r': out += "\\r";  break;
+                        case '\t': out += "\\t";  break;
+                        default:   out += *data;   break;
+                    }
+                }
+            }
+
+            inline void append_pg_copy_encoded_string(std::string& out, const char* data) {
+                append_pg_copy_encoded_string(out, data, std::strlen(data));
+            }
+
         } // namespace detail
 
     } // namespace io
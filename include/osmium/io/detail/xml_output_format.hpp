@@ -152,7 +152,7 @@ namespace osmium {
 
                         if (object.timestamp()) {
                             *m_out += " timestamp=\"";
-                            *m_out += object.timestamp().to_iso();
+                            object.timestamp().to_iso_str(*m_out);
                             *m_out += "\"";
                         }
 
@@ -196,7 +196,7 @@ namespace osmium {
                         *m_out += " user=\"";
                         append_xml_encoded_string(*m_out, comment.user());
                         *m_out += "\" date=\"";
-                        *m_out += comment.date().to_iso();
+                        comment.date().to_iso_str(*m_out);
                         *m_out += "\">\n";
                         *m_out += "    <text>";
                         append_xml_encoded_string(*m_out, comment.text());
@@ -378,13 +378,13 @@ namespace osmium {
 
                     if (changeset.created_at()) {
                         *m_out += " created_at=\"";
-                        *m_out += changeset.created_at().to_iso();
+                        changeset.created_at().to_iso_str(*m_out);
                         *m_out += "\"";
                     }
 
                     if (changeset.closed_at()) {
                         *m_out += " closed_at=\"";
-                        *m_out += changeset.closed_at().to_iso();
+                        changeset.closed_at().to_iso_str(*m_out);
                         *m_out += "\" open=\"false\"";
                     } else {
                         *m_out += " open=\"true\"";
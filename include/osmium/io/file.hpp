@@ -231,6 +231,9 @@ namespace osmium {
                 } else if (suffixes.back() == "debug") {
                     m_file_format = file_format::debug;
                     suffixes.pop_back();
+                } else if (suffixes.back() == "pg") {
+                    m_file_format = file_format::pg;
+                    suffixes.pop_back();
                 }
 
                 if (suffixes.empty()) return;
@@ -46,7 +46,8 @@ namespace osmium {
             opl     = 3,
             json    = 4,
             o5m     = 5,
-            debug   = 6
+            debug   = 6,
+            pg      = 7
         };
 
         enum class read_meta {
@@ -73,6 +74,8 @@ namespace osmium {
                     return "O5M";
                 case file_format::debug:
                     return "DEBUG";
+                case file_format::pg:
+                    return "PG";
             }
         }
 #pragma GCC diagnostic pop
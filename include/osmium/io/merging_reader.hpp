@@ -0,0 +1,383 @@
+#ifndef OSMIUM_IO_MERGING_READER_HPP
+#define OSMIUM_IO_MERGING_READER_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <osmium/io/file.hpp>
+#include <osmium/io/header.hpp>
+#include <osmium/io/reader.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/item_type.hpp>
+#include <osmium/osm/object.hpp>
+#include <osmium/osm/object_comparisons.hpp>
+#include <osmium/osm/types.hpp>
+
+namespace osmium {
+
+    namespace io {
+
+        namespace detail {
+
+            /**
+             * One input of the MergingReader: A Reader and the buffer
+             * currently being merged.
+             */
+            class merging_reader_input {
+
+                osmium::io::Reader m_reader;
+                osmium::memory::Buffer m_buffer;
+                osmium::memory::Buffer::t_const_iterator<osmium::OSMObject> m_it;
+                osmium::memory::Buffer::t_const_iterator<osmium::OSMObject> m_end;
+
+                bool read_next_buffer() {
+                    while ((m_buffer = m_reader.read())) {
+                        m_it = m_buffer.cbegin<osmium::OSMObject>();
+                        m_end = m_buffer.cend<osmium::OSMObject>();
+                        if (m_it != m_end) {
+                            return true;
+                        }
+                    }
+                    return false;
+                }
+
+            public:
+
+                template <typename... TArgs>
+                explicit merging_reader_input(const osmium::io::File& file, TArgs&&... args) :
+                    m_reader(file, std::forward<TArgs>(args)...),
+                    m_buffer(),
+                    m_it(),
+                    m_end() {
+                }
+
+                osmium::io::Reader& reader() noexcept {
+                    return m_reader;
+                }
+
+                /**
+                 * Read the first buffer.
+                 *
+                 * @returns false if there is no data in this input.
+                 */
+                bool start() {
+                    return read_next_buffer();
+                }
+
+                /// The current object.
+                const osmium::OSMObject& current() const noexcept {
+                    return *m_it;
+                }
+
+                /**
+                 * Go to the next object. This might read the next buffer
+                 * from the Reader which invalidates all references to
+                 * objects from the current buffer.
+                 *
+                 * @returns false if there are no more objects.
+                 */
+                bool next() {
+                    ++m_it;
+                    return m_it != m_end || read_next_buffer();
+                }
+
+            }; // class merging_reader_input
+
+        } // namespace detail
+
+        /**
+         * Reads several OSM files at the same time and returns their
+         * contents merged into one stream of objects in buffers. All input
+         * files must be sorted in the order given by the comparison
+         * function object (by default type, id, and version as in usual
+         * OSM files). Only one buffer per input file is kept in memory
+         * (plus the buffers in the queues of the Readers), so files of any
+         * size can be merged.
+         *
+         * Objects comparing equal are returned in the order of the input
+         * files. If set_remove_duplicates() is called, only the first of
+         * several objects with the same type, id, and version is returned.
+         * Duplicates are only found among objects comparing equal to each
+         * other, so the comparison function object must not distinguish
+         * between objects with the same type, id, and version (all
+         * function objects in osm/object_comparisons.hpp qualify).
+         *
+         * @code
+         *   std::vector<osmium::io::File> files{...};
+         *   osmium::io::MergingReader<> reader{files};
+         *   osmium::io::Writer writer{"out.osm.pbf", reader.header()};
+         *   while (osmium::memory::Buffer buffer = reader.read()) {
+         *       writer(std::move(buffer));
+         *   }
+         *   writer.close();
+         *   reader.close();
+         * @endcode
+         *
+         * @tparam TCompare Comparison function object for OSM objects (see
+         *                  osm/object_comparisons.hpp).
+         */
+        template <typename TCompare = osmium::object_order_type_id_version>
+        class MergingReader {
+
+            // Buffers returned by read() will be about this size.
+            static constexpr const size_t buffer_size = 1024 * 1024;
+
+            struct queue_element {
+                const osmium::OSMObject* object;
+                size_t input;
+            };
+
+            struct queue_element_greater {
+
+                TCompare* compare;
+
+                bool operator()(const queue_element& lhs, const queue_element& rhs) const {
+                    if ((*compare)(*rhs.object, *lhs.object)) {
+                        return true;
+                    }
+                    if ((*compare)(*lhs.object, *rhs.object)) {
+                        return false;
+                    }
+                    return lhs.input > rhs.input;
+                }
+
+            }; // struct queue_element_greater
+
+            TCompare m_compare;
+
+            std::vector<std::unique_ptr<detail::merging_reader_input>> m_inputs;
+
+            std::priority_queue<queue_element, std::vector<queue_element>, queue_element_greater> m_queue;
+
+            bool m_remove_duplicates = false;
+            bool m_started = false;
+
+            struct object_key {
+
+                osmium::item_type type;
+                osmium::object_id_type id;
+                osmium::object_version_type version;
+
+                bool operator==(const object_key& other) const noexcept {
+                    return type == other.type && id == other.id && version == other.version;
+                }
+
+            }; // struct object_key
+
+            // Used for removing duplicates: A copy of the first object
+            // of the current run of objects comparing equal and the
+            // keys of all objects returned from this run. Duplicates
+            // can only be in the same run, but with comparison function
+            // objects not looking at all of type, id, and version they
+            // don't have to follow each other.
+            osmium::memory::Buffer m_last_object{1024, osmium::memory::Buffer::auto_grow::yes};
+            std::vector<object_key> m_keys_in_run;
+
+            void start() {
+                m_started = true;
+                for (size_t n = 0; n < m_inputs.size(); ++n) {
+                    if (m_inputs[n]->start()) {
+                        m_queue.push(queue_element{&m_inputs[n]->current(), n});
+                    }
+                }
+            }
+
+            /**
+             * Has an object with the same type, id, and version already
+             * been returned? If not, remember this one.
+             */
+            bool check_duplicate(const osmium::OSMObject& object) {
+                const object_key key{object.type(), object.id(), object.version()};
+
+                if (!m_keys_in_run.empty()) {
+                    const auto& last = m_last_object.get<osmium::OSMObject>(0);
+                    if (!m_compare(last, object) && !m_compare(object, last)) {
+                        if (std::find(m_keys_in_run.cbegin(), m_keys_in_run.cend(), key) != m_keys_in_run.cend()) {
+                            return true;
+                        }
+                        m_keys_in_run.push_back(key);
+                        return false;
+                    }
+                }
+
+                m_last_object.clear();
+                m_last_object.add_item(object);
+                m_last_object.commit();
+                m_keys_in_run.clear();
+                m_keys_in_run.push_back(key);
+                return false;
+            }
+
+        public:
+
+            /**
+             * Create a MergingReader.
+             *
+             * @param files The files to read.
+             * @param args All further arguments are handed to the
+             *             constructors of the Readers for all files. See
+             *             osmium::io::Reader for details.
+             *
+             * @throws osmium::io_error If there was an error.
+             * @throws std::system_error If a file could not be opened.
+             */
+            template <typename... TArgs>
+            explicit MergingReader(const std::vector<osmium::io::File>& files, TArgs&&... args) :
+                m_compare(),
+                m_inputs(),
+                m_queue(queue_element_greater{&m_compare}) {
+                m_inputs.reserve(files.size());
+                for (const auto& file : files) {
+                    m_inputs.emplace_back(new detail::merging_reader_input{file, args...});
+                }
+            }
+
+            MergingReader(const MergingReader&) = delete;
+            MergingReader& operator=(const MergingReader&) = delete;
+
+            MergingReader(MergingReader&&) = delete;
+            MergingReader& operator=(MergingReader&&) = delete;
+
+            ~MergingReader() noexcept = default;
+
+            /**
+             * Only return the first of several objects with the same type,
+             * id, and version. Must be called before the first call to
+             * read().
+             */
+            void set_remove_duplicates(bool value = true) noexcept {
+                m_remove_duplicates = value;
+            }
+
+            /// The number of input files.
+            size_t num_inputs() const noexcept {
+                return m_inputs.size();
+            }
+
+            /**
+             * Get the header. This is the header of the first file with the
+             * bounding boxes of all files. The "multiple object versions"
+             * flag is set if it is set in any of the files.
+             *
+             * @throws Some form of osmium::io_error if there is an error.
+             */
+            osmium::io::Header header() {
+                osmium::io::Header header;
+                bool first = true;
+                for (auto& input : m_inputs) {
+                    const osmium::io::Header input_header = input->reader().header();
+                    if (first) {
+                        header = input_header;
+                        first = false;
+                    } else {
+                        for (const auto& box : input_header.boxes()) {
+                            header.add_box(box);
+                        }
+                        if (input_header.has_multiple_object_versions()) {
+                            header.set_has_multiple_object_versions(true);
+                        }
+                    }
+                }
+                return header;
+            }
+
+            /**
+             * Reads the next buffer of merged objects. An invalid buffer
+             * signals the end of the data.
+             *
+             * @returns Buffer.
+             * @throws Some form of osmium::io_error if there is an error.
+             */
+            osmium::memory::Buffer read() {
+                if (!m_started) {
+                    start();
+                }
+
+                osmium::memory::Buffer buffer{buffer_size, osmium::memory::Buffer::auto_grow::yes};
+
+                while (!m_queue.empty() && buffer.committed() < buffer_size) {
+                    const queue_element element = m_queue.top();
+                    m_queue.pop();
+
+                    const osmium::OSMObject& object = *element.object;
+                    if (!m_remove_duplicates || !check_duplicate(object)) {
+                        buffer.add_item(object);
+                        buffer.commit();
+                    }
+
+                    auto& input = *m_inputs[element.input];
+                    if (input.next()) {
+                        m_queue.push(queue_element{&input.current(), element.input});
+                    }
+                }
+
+                if (buffer.committed() == 0) {
+                    return osmium::memory::Buffer{};
+                }
+                return buffer;
+            }
+
+            /**
+             * Has the end of all input files been reached?
+             */
+            bool eof() const noexcept {
+                return m_started && m_queue.empty();
+            }
+
+            /**
+             * Close all Readers. A call to this is optional, because the
+             * destructor will also close them. But if you don't call this
+             * function first, you might miss an exception, because the
+             * destructor is not allowed to throw.
+             *
+             * @throws Some form of osmium::io_error when there is a problem.
+             */
+            void close() {
+                for (auto& input : m_inputs) {
+                    input->reader().close();
+                }
+            }
+
+        }; // class MergingReader
+
+    } // namespace io
+
+} // namespace osmium
+
+#endif // OSMIUM_IO_MERGING_READER_HPP
@@ -0,0 +1,344 @@
+#ifndef OSMIUM_MEMORY_NODE_BATCH_HPP
+#define OSMIUM_MEMORY_NODE_BATCH_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <osmium/builder/osm_object_builder.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/node.hpp>
+#include <osmium/osm/tag.hpp>
+#include <osmium/osm/timestamp.hpp>
+#include <osmium/osm/types.hpp>
+#include <osmium/tags/key_dictionary.hpp>
+
+namespace osmium {
+
+    namespace memory {
+
+        /**
+         * Columnar representation of a number of nodes. Each attribute
+         * is stored in its own array with one entry per node, so code
+         * only interested in, say, the locations can scan them
+         * sequentially without walking through the nodes in a Buffer.
+         *
+         * Locations are stored as the fixed-point x and y coordinates
+         * used by osmium::Location. Tags are dictionary-encoded: Each tag
+         * key and value is stored as an id of the string in the keys()
+         * or values() dictionary. The tags of node n are the entries
+         * tag_offsets()[n] to tag_offsets()[n+1] in tag_keys() and
+         * tag_values(). User names are dictionary-encoded in the same
+         * way with the id 0 for an empty user name.
+         *
+         * Nodes can be added from buffers with add_buffer() and written
+         * back into a buffer with write_to(). All attributes of the nodes
+         * are kept, so this round-trip doesn't lose any information.
+         *
+         * @code
+         *   osmium::memory::NodeBatch batch;
+         *   batch.add_buffer(buffer);
+         *   const uint32_t highway = batch.keys().lookup("highway");
+         *   const auto column = batch.tag_column(highway);
+         *   for (std::size_t n = 0; n < batch.size(); ++n) {
+         *       if (column[n] != 0) {
+         *           heatmap.add(batch.x()[n], batch.y()[n]);
+         *       }
+         *   }
+         * @endcode
+         */
+        class NodeBatch {
+
+            std::vector<osmium::object_id_type> m_ids;
+            std::vector<int32_t> m_x;
+            std::vector<int32_t> m_y;
+            std::vector<osmium::object_version_type> m_versions;
+            std::vector<uint32_t> m_timestamps;
+            std::vector<osmium::changeset_id_type> m_changesets;
+            std::vector<osmium::user_id_type> m_uids;
+            std::vector<uint32_t> m_user_ids;
+            std::vector<bool> m_visible;
+
+            std::vector<std::size_t> m_tag_offsets{0};
+            std::vector<uint32_t> m_tag_keys;
+            std::vector<uint32_t> m_tag_values;
+
+            osmium::tags::KeyDictionary m_keys;
+            osmium::tags::KeyDictionary m_values;
+            osmium::tags::KeyDictionary m_users;
+
+            static uint32_t lookup_or_add(osmium::tags::KeyDictionary& dictionary, const char* str) {
+                const uint32_t id = dictionary.lookup(str);
+                return id != osmium::tags::KeyDictionary::unknown ? id : dictionary.add(str);
+            }
+
+        public:
+
+            NodeBatch() = default;
+
+            /// The number of nodes in this batch.
+            std::size_t size() const noexcept {
+                return m_ids.size();
+            }
+
+            /// Is this batch empty?
+            bool empty() const noexcept {
+                return m_ids.empty();
+            }
+
+            /**
+             * Remove all nodes from this batch. The dictionaries are
+             * kept, so ids of strings stay the same.
+             */
+            void clear() noexcept {
+                m_ids.clear();
+                m_x.clear();
+                m_y.clear();
+                m_versions.clear();
+                m_timestamps.clear();
+                m_changesets.clear();
+                m_uids.clear();
+                m_user_ids.clear();
+                m_visible.clear();
+                m_tag_offsets.resize(1);
+                m_tag_keys.clear();
+                m_tag_values.clear();
+            }
+
+            /// Reserve space for the given number of nodes.
+            void reserve(std::size_t num_nodes) {
+                m_ids.reserve(num_nodes);
+                m_x.reserve(num_nodes);
+                m_y.reserve(num_nodes);
+                m_versions.reserve(num_nodes);
+                m_timestamps.reserve(num_nodes);
+                m_changesets.reserve(num_nodes);
+                m_uids.reserve(num_nodes);
+                m_user_ids.reserve(num_nodes);
+                m_visible.reserve(num_nodes);
+                m_tag_offsets.reserve(num_nodes + 1);
+            }
+
+            /// Add a node to the end of this batch.
+            void add(const osmium::Node& node) {
+                m_ids.push_back(node.id());
+                m_x.push_back(node.location().x());
+                m_y.push_back(node.location().y());
+                m_versions.push_back(node.version());
+                m_timestamps.push_back(uint32_t(node.timestamp()));
+                m_changesets.push_back(node.changeset());
+                m_uids.push_back(node.uid());
+                m_user_ids.push_back(node.user()[0] == '\0' ? 0 : lookup_or_add(m_users, node.user()));
+                m_visible.push_back(node.visible());
+
+                for (const auto& tag : node.tags()) {
+                    m_tag_keys.push_back(lookup_or_add(m_keys, tag.key()));
+                    m_tag_values.push_back(lookup_or_add(m_values, tag.value()));
+                }
+                m_tag_offsets.push_back(m_tag_keys.size());
+            }
+
+            /**
+             * Add all nodes in the buffer to the end of this batch. Other
+             * objects in the buffer are ignored.
+             *
+             * @returns The number of nodes added.
+             */
+            std::size_t add_buffer(const osmium::memory::Buffer& buffer) {
+                const std::size_t old_size = size();
+                for (const auto& node : buffer.select<osmium::Node>()) {
+                    add(node);
+                }
+                return size() - old_size;
+            }
+
+            /**
+             * Write the nodes in this batch into the buffer. Each node is
+             * committed after it is written.
+             */
+            void write_to(osmium::memory::Buffer& buffer) const {
+                for (std::size_t n = 0; n < size(); ++n) {
+                    {
+                        osmium::builder::NodeBuilder builder{buffer};
+                        builder.set_id(m_ids[n])
+                               .set_location(location(n))
+                               .set_version(m_versions[n])
+                               .set_timestamp(m_timestamps[n])
+                               .set_changeset(m_changesets[n])
+                               .set_uid(m_uids[n])
+                               .set_visible(m_visible[n]);
+                        if (m_user_ids[n] != 0) {
+                            builder.set_user(m_users.key(m_user_ids[n]));
+                        }
+                        if (m_tag_offsets[n] != m_tag_offsets[n + 1]) {
+                            osmium::builder::TagListBuilder tl_builder{builder};
+                            for (std::size_t t = m_tag_offsets[n]; t < m_tag_offsets[n + 1]; ++t) {
+                                tl_builder.add_tag(m_keys.key(m_tag_keys[t]), m_values.key(m_tag_values[t]));
+                            }
+                        }
+                    }
+                    buffer.commit();
+                }
+            }
+
+            /// The ids of the nodes.
+            const std::vector<osmium::object_id_type>& ids() const noexcept {
+                return m_ids;
+            }
+
+            /// The x coordinates (longitudes) in Location::coordinate_precision units.
+            const std::vector<int32_t>& x() const noexcept {
+                return m_x;
+            }
+
+            /// The y coordinates (latitudes) in Location::coordinate_precision units.
+            const std::vector<int32_t>& y() const noexcept {
+                return m_y;
+            }
+
+            /// The versions of the nodes.
+            const std::vector<osmium::object_version_type>& versions() const noexcept {
+                return m_versions;
+            }
+
+            /// The timestamps of the nodes in seconds since the epoch.
+            const std::vector<uint32_t>& timestamps() const noexcept {
+                return m_timestamps;
+            }
+
+            /// The changeset ids of the nodes.
+            const std::vector<osmium::changeset_id_type>& changesets() const noexcept {
+                return m_changesets;
+            }
+
+            /// The user ids of the nodes.
+            const std::vector<osmium::user_id_type>& uids() const noexcept {
+                return m_uids;
+            }
+
+            /// The ids of the user names in the users() dictionary.
+            const std::vector<uint32_t>& user_ids() const noexcept {
+                return m_user_ids;
+            }
+
+            /// The visible flags of the nodes.
+            const std::vector<bool>& visible() const noexcept {
+                return m_visible;
+            }
+
+            /// Offsets of the tags of each node into tag_keys() and tag_values().
+            const std::vector<std::size_t>& tag_offsets() const noexcept {
+                return m_tag_offsets;
+            }
+
+            /// The ids of the tag keys in the keys() dictionary.
+            const std::vector<uint32_t>& tag_keys() const noexcept {
+                return m_tag_keys;
+            }
+
+            /// The ids of the tag values in the values() dictionary.
+            const std::vector<uint32_t>& tag_values() const noexcept {
+                return m_tag_values;
+            }
+
+            /// The dictionary of tag keys.
+            const osmium::tags::KeyDictionary& keys() const noexcept {
+                return m_keys;
+            }
+
+            /// The dictionary of tag values.
+            const osmium::tags::KeyDictionary& values() const noexcept {
+                return m_values;
+            }
+
+            /// The dictionary of user names.
+            const osmium::tags::KeyDictionary& users() const noexcept {
+                return m_users;
+            }
+
+            /// The location of node n.
+            osmium::Location location(std::size_t n) const noexcept {
+                assert(n < size());
+                return osmium::Location{m_x[n], m_y[n]};
+            }
+
+            /**
+             * Get the id of the value of the tag with the given key id
+             * of node n.
+             *
+             * @returns The id of the value in the values() dictionary or
+             *          0 if the node doesn't have this tag.
+             */
+            uint32_t tag_value_id(std::size_t n, uint32_t key_id) const noexcept {
+                assert(n < size());
+                for (std::size_t t = m_tag_offsets[n]; t < m_tag_offsets[n + 1]; ++t) {
+                    if (m_tag_keys[t] == key_id) {
+                        return m_tag_values[t];
+                    }
+                }
+                return 0;
+            }
+
+            /**
+             * Get the ids of the values of the tag with the given key id
+             * for all nodes as a column with one entry for each node. The
+             * entry is 0 for nodes without this tag.
+             */
+            std::vector<uint32_t> tag_column(uint32_t key_id) const {
+                std::vector<uint32_t> column(size(), 0);
+                if (key_id == osmium::tags::KeyDictionary::unknown) {
+                    return column;
+                }
+                for (std::size_t n = 0; n < size(); ++n) {
+                    for (std::size_t t = m_tag_offsets[n]; t < m_tag_offsets[n + 1]; ++t) {
+                        if (m_tag_keys[t] == key_id) {
+                            column[n] = m_tag_values[t];
+                            break;
+                        }
+                    }
+                }
+                return column;
+            }
+
+        }; // class NodeBatch
+
+    } // namespace memory
+
+} // namespace osmium
+
+#endif // OSMIUM_MEMORY_NODE_BATCH_HPP
@@ -34,6 +34,7 @@ DEALINGS IN THE SOFTWARE.
 */
 
 #include <cstdint>
+#include <cstring>
 
 #include <osmium/osm/area.hpp>
 #include <osmium/osm/box.hpp>
@@ -136,9 +137,7 @@ namespace osmium {
         }
 
         void update_string(const char* str) noexcept {
-            while (*str) {
-                m_crc.process_byte(*str++);
-            }
+            m_crc.process_bytes(str, std::strlen(str));
         }
 
         void update(const Timestamp& timestamp) noexcept {
@@ -161,9 +160,17 @@ namespace osmium {
         }
 
         void update(const NodeRefList& node_refs) noexcept {
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+            // The in-memory layout of the node refs is the same as the
+            // sequence of update_int64() and update_int32() calls for
+            // each node ref, so the whole list can be done in one go.
+            static_assert(sizeof(NodeRef) == sizeof(int64_t) + 2 * sizeof(int32_t), "unexpected padding in NodeRef");
+            m_crc.process_bytes(node_refs.cbegin(), node_refs.size() * sizeof(NodeRef));
+#else
             for (const NodeRef& node_ref : node_refs) {
                 update(node_ref);
             }
+#endif
         }
 
         void update(const TagList& tags) noexcept {
@@ -35,6 +35,7 @@ DEALINGS IN THE SOFTWARE.
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <iosfwd>
 #include <iterator>
@@ -45,6 +46,10 @@ DEALINGS IN THE SOFTWARE.
 
 namespace osmium {
 
+    namespace tags {
+        class KeyDictionary;
+    } // namespace tags
+
     class Tag : public osmium::memory::detail::ItemHelper {
 
         Tag(const Tag&) = delete;
@@ -84,6 +89,13 @@ namespace osmium {
             return reinterpret_cast<const char*>(after_null(data()));
         }
 
+        /**
+         * Get the id of the key of this tag in the given dictionary or
+         * osmium::tags::KeyDictionary::unknown if it is not in there.
+         * Include <osmium/tags/key_dictionary.hpp> to use this.
+         */
+        uint32_t key_id(const osmium::tags::KeyDictionary& dictionary) const noexcept;
+
     }; // class Tag
 
     inline bool operator==(const Tag& lhs, const Tag& rhs) {
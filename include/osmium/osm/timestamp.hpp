@@ -33,7 +33,6 @@ DEALINGS IN THE SOFTWARE.
 
 */
 
-#include <cassert>
 #include <cstdint>
 #include <ctime>
 #include <iosfwd>
@@ -49,55 +48,93 @@ namespace osmium {
 
     namespace detail {
 
+        /**
+         * Number of days since 1970-01-01 for the given date in the
+         * proleptic Gregorian calendar. Days out of range for the month
+         * are carried over into the next month.
+         *
+         * See http://howardhinnant.github.io/date_algorithms.html
+         */
+        inline int64_t days_from_civil(int64_t year, int64_t month, int64_t day) noexcept {
+            year -= month <= 2;
+            const int64_t era = (year >= 0 ? year : year - 399) / 400;
+            const int64_t yoe = year - era * 400;                                         // [0, 399]
+            const int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1; // [0, 365]
+            const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                     // [0, 146096]
+            return era * 146097 + doe - 719468;
+        }
+
+        /**
+         * Calculate year, month, and day from the number of days since
+         * 1970-01-01. Only works for non-negative days.
+         *
+         * See http://howardhinnant.github.io/date_algorithms.html
+         */
+        inline void civil_from_days(uint32_t days, uint32_t& year, uint32_t& month, uint32_t& day) noexcept {
+            const uint32_t z = days + 719468;
+            const uint32_t era = z / 146097;
+            const uint32_t doe = z - era * 146097;                                 // [0, 146096]
+            const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // [0, 399]
+            const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);          // [0, 365]
+            const uint32_t mp = (5 * doy + 2) / 153;                               // [0, 11]
+            day = doy - (153 * mp + 2) / 5 + 1;
+            month = mp < 10 ? mp + 3 : mp - 9;
+            year = yoe + era * 400 + (month <= 2);
+        }
+
+        inline bool is_digit(char c) noexcept {
+            return static_cast<unsigned char>(c - '0') <= 9;
+        }
+
+        inline int two_digits(const char* str) noexcept {
+            return (str[0] - '0') * 10 + (str[1] - '0');
+        }
+
+        /**
+         * Parse a timestamp in the ISO format "yyyy-mm-ddThh:mm:ssZ".
+         * February always has 29 days and there can be a leap second.
+         * Overflowing values are carried over into the next day.
+         *
+         * @throws std::invalid_argument if the timestamp can not be parsed.
+         */
         inline time_t parse_timestamp(const char* str) {
             static const int mon_lengths[] = {
                 31, 29, 31, 30, 31, 30,
                 31, 31, 30, 31, 30, 31
             };
-            if (str[ 0] >= '0' && str[ 0] <= '9' &&
-                str[ 1] >= '0' && str[ 1] <= '9' &&
-                str[ 2] >= '0' && str[ 2] <= '9' &&
-                str[ 3] >= '0' && str[ 3] <= '9' &&
+            if (is_digit(str[ 0]) &&
+                is_digit(str[ 1]) &&
+                is_digit(str[ 2]) &&
+                is_digit(str[ 3]) &&
                 str[ 4] == '-' &&
-                str[ 5] >= '0' && str[ 5] <= '9' &&
-                str[ 6] >= '0' && str[ 6] <= '9' &&
+                is_digit(str[ 5]) &&
+                is_digit(str[ 6]) &&
                 str[ 7] == '-' &&
-                str[ 8] >= '0' && str[ 8] <= '9' &&
-                str[ 9] >= '0' && str[ 9] <= '9' &&
+                is_digit(str[ 8]) &&
+                is_digit(str[ 9]) &&
                 str[10] == 'T' &&
-                str[11] >= '0' && str[11] <= '9' &&
-                str[12] >= '0' && str[12] <= '9' &&
+                is_digit(str[11]) &&
+                is_digit(str[12]) &&
                 str[13] == ':' &&
-                str[14] >= '0' && str[14] <= '9' &&
-                str[15] >= '0' && str[15] <= '9' &&
+                is_digit(str[14]) &&
+                is_digit(str[15]) &&
                 str[16] == ':' &&
-                str[17] >= '0' && str[17] <= '9' &&
-                str[18] >= '0' && str[18] <= '9' &&
+                is_digit(str[17]) &&
+                is_digit(str[18]) &&
                 str[19] == 'Z') {
-                struct tm tm;
-                tm.tm_year = (str[ 0] - '0') * 1000 +
-                             (str[ 1] - '0') *  100 +
-                             (str[ 2] - '0') *   10 +
-                             (str[ 3] - '0')        - 1900;
-                tm.tm_mon  = (str[ 5] - '0') * 10 + (str[ 6] - '0') - 1;
-                tm.tm_mday = (str[ 8] - '0') * 10 + (str[ 9] - '0');
-                tm.tm_hour = (str[11] - '0') * 10 + (str[12] - '0');
-                tm.tm_min  = (str[14] - '0') * 10 + (str[15] - '0');
-                tm.tm_sec  = (str[17] - '0') * 10 + (str[18] - '0');
-                tm.tm_wday = 0;
-                tm.tm_yday = 0;
-                tm.tm_isdst = 0;
-                if (tm.tm_year >= 0 &&
-                    tm.tm_mon  >= 0 && tm.tm_mon  <= 11 &&
-                    tm.tm_mday >= 1 && tm.tm_mday <= mon_lengths[tm.tm_mon] &&
-                    tm.tm_hour >= 0 && tm.tm_hour <= 23 &&
-                    tm.tm_min  >= 0 && tm.tm_min  <= 59 &&
-                    tm.tm_sec  >= 0 && tm.tm_sec  <= 60) {
-#ifndef _WIN32
-                    return timegm(&tm);
-#else
-                    return _mkgmtime(&tm);
-#endif
+                const int year  = two_digits(str) * 100 + two_digits(str + 2);
+                const int month = two_digits(str +  5);
+                const int day   = two_digits(str +  8);
+                const int hour  = two_digits(str + 11);
+                const int min   = two_digits(str + 14);
+                const int sec   = two_digits(str + 17);
+                if (year  >= 1900 &&
+                    month >= 1 && month <= 12 &&
+                    day   >= 1 && day   <= mon_lengths[month - 1] &&
+                    hour  <= 23 &&
+                    min   <= 59 &&
+                    sec   <= 60) {
+                    return static_cast<time_t>(days_from_civil(year, month, day) * 86400 + hour * 3600 + min * 60 + sec);
                 }
             }
             throw std::invalid_argument{"can not parse timestamp"};
@@ -114,14 +151,12 @@ namespace osmium {
      */
     class Timestamp {
 
-        // length of ISO timestamp string yyyy-mm-ddThh:mm:ssZ\0
-        static constexpr const int timestamp_length = 20 + 1;
+        // length of ISO timestamp string yyyy-mm-ddThh:mm:ssZ
+        static constexpr const int timestamp_length = 20;
 
-        // The timestamp format for OSM timestamps in strftime(3) format.
-        // This is the ISO-Format "yyyy-mm-ddThh:mm:ssZ".
-        static const char* timestamp_format() {
-            static const char f[timestamp_length] = "%Y-%m-%dT%H:%M:%SZ";
-            return f;
+        static void add_two_digits(char* out, uint32_t value) noexcept {
+            out[0] = static_cast<char>('0' + value / 10);
+            out[1] = static_cast<char>('0' + value % 10);
         }
 
         uint32_t m_timestamp;
@@ -216,6 +251,36 @@ namespace osmium {
             m_timestamp -= time_difference;
         }
 
+        /**
+         * Append the timestamp as string in ISO date/time
+         * ("yyyy-mm-ddThh:mm:ssZ") format to the given string. If the
+         * timestamp is invalid, nothing will be appended.
+         */
+        void to_iso_str(std::string& s) const {
+            if (m_timestamp == 0) {
+                return;
+            }
+
+            uint32_t year;
+            uint32_t month;
+            uint32_t day;
+            detail::civil_from_days(m_timestamp / 86400, year, month, day);
+            const uint32_t secs = m_timestamp % 86400;
+
+            char buffer[timestamp_length] = {
+                '0', '0', '0', '0', '-', '0', '0', '-', '0', '0', 'T',
+                '0', '0', ':', '0', '0', ':', '0', '0', 'Z'
+            };
+            add_two_digits(buffer, year / 100);
+            add_two_digits(buffer + 2, year % 100);
+            add_two_digits(buffer + 5, month);
+            add_two_digits(buffer + 8, day);
+            add_two_digits(buffer + 11, secs / 3600);
+            add_two_digits(buffer + 14, (secs / 60) % 60);
+            add_two_digits(buffer + 17, secs % 60);
+            s.append(buffer, timestamp_length);
+        }
+
         /**
          * Return the timestamp as string in ISO date/time
          * ("yyyy-mm-ddThh:mm:ssZ") format. If the timestamp is invalid, an
@@ -223,30 +288,7 @@ namespace osmium {
          */
         std::string to_iso() const {
             std::string s;
-
-            if (m_timestamp != 0) {
-                struct tm tm;
-                time_t sse = seconds_since_epoch();
-#ifndef NDEBUG
-                auto result =
-#endif
-#ifndef _MSC_VER
-                              gmtime_r(&sse, &tm);
-                assert(result != nullptr);
-#else
-                              gmtime_s(&tm, &sse);
-                assert(result == 0);
-#endif
-
-                s.resize(timestamp_length);
-                /* This const_cast is ok, because we know we have enough space
-                in the string for the format we are using (well at least until
-                the year will have 5 digits). And by setting the size
-                afterwards from the result of strftime we make sure thats set
-                right, too. */
-                s.resize(strftime(const_cast<char*>(s.c_str()), timestamp_length, timestamp_format(), &tm));
-            }
-
+            to_iso_str(s);
             return s;
         }
 
@@ -0,0 +1,230 @@
+#ifndef OSMIUM_RELATIONS_DETAIL_LINESTRING_MERGER_HPP
+#define OSMIUM_RELATIONS_DETAIL_LINESTRING_MERGER_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <osmium/area/detail/node_ref_segment.hpp>
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/node_ref.hpp>
+#include <osmium/osm/way.hpp>
+
+namespace osmium {
+
+    namespace relations {
+
+        namespace detail {
+
+            /**
+             * Merges the segments of a number of ways into as few
+             * linestrings as possible. Linestrings are split at all
+             * locations where more or less than two segments meet, so
+             * branches and gaps in the ways result in several linestrings.
+             * Segments contained in more than one way (or more than once
+             * in the same way) are only used once.
+             *
+             * The merger can be re-used, it keeps the memory it allocated.
+             */
+            class LinestringMerger {
+
+                using segment_type = osmium::area::detail::NodeRefSegment;
+
+                // All segments sorted and without duplicates.
+                std::vector<segment_type> m_segments;
+
+                // One entry for each end of each segment sorted by location.
+                struct segment_end {
+
+                    osmium::Location location;
+                    uint32_t segment;
+
+                    segment_end(const osmium::Location& l, uint32_t s) noexcept :
+                        location(l),
+                        segment(s) {
+                    }
+
+                }; // struct segment_end
+
+                std::vector<segment_end> m_ends;
+
+                // Segments already added to a linestring.
+                std::vector<bool> m_done;
+
+                // Node refs of the linestrings found. The linestrings are
+                // separated by entries in m_linestring_ends.
+                std::vector<osmium::NodeRef> m_node_refs;
+                std::vector<size_t> m_linestring_ends;
+
+                using ends_iterator = std::vector<segment_end>::const_iterator;
+
+                std::pair<ends_iterator, ends_iterator> ends_at(const osmium::Location& location) const {
+                    return std::equal_range(m_ends.cbegin(), m_ends.cend(), segment_end{location, 0}, [](const segment_end& lhs, const segment_end& rhs) {
+                        return lhs.location < rhs.location;
+                    });
+                }
+
+                const osmium::NodeRef& other_end(const segment_type& segment, const osmium::Location& location) const noexcept {
+                    return segment.first().location() == location ? segment.second() : segment.first();
+                }
+
+                /**
+                 * Follow segments from the given start segment as long as
+                 * exactly two segments meet at each location.
+                 */
+                void follow(uint32_t segment_num, const osmium::NodeRef& start) {
+                    m_node_refs.push_back(start);
+                    osmium::Location location = start.location();
+
+                    while (true) {
+                        m_done[segment_num] = true;
+                        const osmium::NodeRef& next = other_end(m_segments[segment_num], location);
+                        m_node_refs.push_back(next);
+                        location = next.location();
+
+                        const auto range = ends_at(location);
+                        if (std::distance(range.first, range.second) != 2) {
+                            break;
+                        }
+                        const uint32_t next_segment = range.first->segment == segment_num ? std::next(range.first)->segment : range.first->segment;
+                        if (m_done[next_segment]) {
+                            break;
+                        }
+                        segment_num = next_segment;
+                    }
+
+                    m_linestring_ends.push_back(m_node_refs.size());
+                }
+
+                void add_way(const osmium::Way& way) {
+                    const osmium::NodeRef* previous = nullptr;
+                    for (const osmium::NodeRef& nr : way.nodes()) {
+                        if (!nr.location().valid()) {
+                            previous = nullptr;
+                            continue;
+                        }
+                        if (previous && previous->location() != nr.location()) {
+                            m_segments.emplace_back(*previous, nr);
+                        }
+                        previous = &nr;
+                    }
+                }
+
+            public:
+
+                LinestringMerger() = default;
+
+                /**
+                 * Merge the given ways into linestrings. Nodes with
+                 * invalid locations are ignored. Results are available
+                 * from num_linestrings() and linestring() until the next
+                 * call to merge().
+                 */
+                void merge(const std::vector<const osmium::Way*>& ways) {
+                    m_segments.clear();
+                    m_ends.clear();
+                    m_node_refs.clear();
+                    m_linestring_ends.clear();
+
+                    for (const osmium::Way* way : ways) {
+                        add_way(*way);
+                    }
+
+                    std::sort(m_segments.begin(), m_segments.end());
+                    m_segments.erase(std::unique(m_segments.begin(), m_segments.end()), m_segments.end());
+
+                    for (uint32_t n = 0; n < m_segments.size(); ++n) {
+                        m_ends.emplace_back(m_segments[n].first().location(), n);
+                        m_ends.emplace_back(m_segments[n].second().location(), n);
+                    }
+                    std::stable_sort(m_ends.begin(), m_ends.end(), [](const segment_end& lhs, const segment_end& rhs) {
+                        return lhs.location < rhs.location;
+                    });
+
+                    m_done.assign(m_segments.size(), false);
+
+                    // Start linestrings at all ends and branching points.
+                    auto it = m_ends.cbegin();
+                    while (it != m_ends.cend()) {
+                        const auto range = ends_at(it->location);
+                        if (std::distance(range.first, range.second) != 2) {
+                            for (auto e = range.first; e != range.second; ++e) {
+                                if (!m_done[e->segment]) {
+                                    const auto& segment = m_segments[e->segment];
+                                    follow(e->segment, segment.first().location() == e->location ? segment.first() : segment.second());
+                                }
+                            }
+                        }
+                        it = range.second;
+                    }
+
+                    // All remaining segments are in closed rings.
+                    for (const auto& e : m_ends) {
+                        if (!m_done[e.segment]) {
+                            const auto& segment = m_segments[e.segment];
+                            follow(e.segment, segment.first().location() == e.location ? segment.first() : segment.second());
+                        }
+                    }
+                }
+
+                /// The number of linestrings found by the last call to merge().
+                size_t num_linestrings() const noexcept {
+                    return m_linestring_ends.size();
+                }
+
+                /**
+                 * Get the node refs of the linestring with the given index
+                 * as a pair of pointers to the first and one past the last
+                 * node ref.
+                 */
+                std::pair<const osmium::NodeRef*, const osmium::NodeRef*> linestring(size_t n) const noexcept {
+                    assert(n < m_linestring_ends.size());
+                    const size_t begin = n == 0 ? 0 : m_linestring_ends[n - 1];
+                    return std::make_pair(m_node_refs.data() + begin, m_node_refs.data() + m_linestring_ends[n]);
+                }
+
+            }; // class LinestringMerger
+
+        } // namespace detail
+
+    } // namespace relations
+
+} // namespace osmium
+
+#endif // OSMIUM_RELATIONS_DETAIL_LINESTRING_MERGER_HPP
@@ -0,0 +1,231 @@
+#ifndef OSMIUM_RELATIONS_LINESTRING_COLLECTOR_HPP
+#define OSMIUM_RELATIONS_LINESTRING_COLLECTOR_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <osmium/builder/osm_object_builder.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/item_type.hpp>
+#include <osmium/osm/relation.hpp>
+#include <osmium/osm/way.hpp>
+#include <osmium/relations/collector.hpp>
+#include <osmium/relations/detail/linestring_merger.hpp>
+
+namespace osmium {
+
+    namespace relations {
+
+        /**
+         * This class collects all data needed for creating linestrings
+         * from relations with way members, such as route relations. By
+         * default relations tagged type=route are used, other types can
+         * be set in the constructor. Most of its functionality is derived
+         * from the parent class osmium::relations::Collector.
+         *
+         * The member ways of each relation are merged into as few
+         * linestrings as possible. Linestrings are split where ways
+         * branch or where there are gaps between them. The direction of
+         * the resulting linestrings is not necessarily the direction of
+         * the route.
+         *
+         * For each linestring a Way object is created in the output
+         * buffer. It has the id, attributes and tags of the relation. All
+         * Ways created from the same relation follow each other in the
+         * output buffer, together they form a (multi)linestring. Note
+         * that the Way ids are relation ids, so they should not be mixed
+         * with real ways.
+         *
+         * Relations where the member ways don't have any valid locations
+         * don't create any output.
+         */
+        class LinestringCollector : public osmium::relations::Collector<LinestringCollector, false, true, false> {
+
+            using collector_type = osmium::relations::Collector<LinestringCollector, false, true, false>;
+
+            std::vector<std::string> m_types;
+
+            osmium::memory::Buffer m_output_buffer;
+
+            detail::LinestringMerger m_merger;
+
+            // Member ways of the relation currently being assembled.
+            std::vector<const osmium::Way*> m_member_ways;
+
+            size_t m_count_relations = 0;
+            size_t m_count_linestrings = 0;
+
+            static constexpr size_t initial_output_buffer_size = 1024 * 1024;
+            static constexpr size_t max_buffer_size_for_flush = 100 * 1024;
+
+            void flush_output_buffer() {
+                if (this->callback()) {
+                    osmium::memory::Buffer buffer(initial_output_buffer_size);
+                    using std::swap;
+                    swap(buffer, m_output_buffer);
+                    this->callback()(std::move(buffer));
+                }
+            }
+
+            void possibly_flush_output_buffer() {
+                if (m_output_buffer.committed() > max_buffer_size_for_flush) {
+                    flush_output_buffer();
+                }
+            }
+
+            void add_linestring(const osmium::Relation& relation, const osmium::NodeRef* begin, const osmium::NodeRef* end) {
+                {
+                    osmium::builder::WayBuilder builder{m_output_buffer};
+                    builder.set_id(relation.id())
+                           .set_version(relation.version())
+                           .set_changeset(relation.changeset())
+                           .set_timestamp(relation.timestamp())
+                           .set_visible(relation.visible())
+                           .set_uid(relation.uid())
+                           .set_user(relation.user());
+                    builder.add_item(relation.tags());
+
+                    osmium::builder::WayNodeListBuilder wnl_builder{builder};
+                    for (; begin != end; ++begin) {
+                        wnl_builder.add_node_ref(*begin);
+                    }
+                }
+                m_output_buffer.commit();
+            }
+
+        public:
+
+            /**
+             * Create a LinestringCollector.
+             *
+             * @param types The values of the "type" tag of relations that
+             *              should be assembled.
+             */
+            explicit LinestringCollector(const std::vector<std::string>& types = {"route"}) :
+                collector_type(),
+                m_types(types),
+                m_output_buffer(initial_output_buffer_size, osmium::memory::Buffer::auto_grow::yes),
+                m_merger(),
+                m_member_ways() {
+            }
+
+            /// The number of relations assembled so far.
+            size_t count_relations() const noexcept {
+                return m_count_relations;
+            }
+
+            /// The number of linestrings created so far.
+            size_t count_linestrings() const noexcept {
+                return m_count_linestrings;
+            }
+
+            /**
+             * We are interested in all relations with one of the types
+             * given in the constructor.
+             *
+             * Overwritten from the base class.
+             */
+            bool keep_relation(const osmium::Relation& relation) const {
+                const char* type = relation.tags().get_value_by_key("type");
+
+                // ignore relations without "type" tag
+                if (!type) {
+                    return false;
+                }
+
+                for (const auto& t : m_types) {
+                    if (!std::strcmp(type, t.c_str())) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            /**
+             * Overwritten from the base class.
+             */
+            bool keep_member(const osmium::relations::RelationMeta& /*relation_meta*/, const osmium::RelationMember& member) const {
+                // We are only interested in members of type way.
+                return member.type() == osmium::item_type::way;
+            }
+
+            void complete_relation(osmium::relations::RelationMeta& relation_meta) {
+                const osmium::Relation& relation = this->get_relation(relation_meta);
+                const osmium::memory::Buffer& buffer = this->members_buffer();
+
+                m_member_ways.clear();
+                for (const auto& member : relation.members()) {
+                    if (member.ref() != 0) {
+                        const size_t offset = this->get_offset(member.type(), member.ref());
+                        m_member_ways.push_back(&buffer.get<const osmium::Way>(offset));
+                    }
+                }
+
+                m_merger.merge(m_member_ways);
+
+                ++m_count_relations;
+                for (size_t n = 0; n < m_merger.num_linestrings(); ++n) {
+                    const auto linestring = m_merger.linestring(n);
+                    add_linestring(relation, linestring.first, linestring.second);
+                    ++m_count_linestrings;
+                }
+
+                possibly_flush_output_buffer();
+            }
+
+            void flush() {
+                flush_output_buffer();
+            }
+
+            osmium::memory::Buffer read() {
+                osmium::memory::Buffer buffer(initial_output_buffer_size, osmium::memory::Buffer::auto_grow::yes);
+
+                using std::swap;
+                swap(buffer, m_output_buffer);
+
+                return buffer;
+            }
+
+        }; // class LinestringCollector
+
+    } // namespace relations
+
+} // namespace osmium
+
+#endif // OSMIUM_RELATIONS_LINESTRING_COLLECTOR_HPP
@@ -0,0 +1,160 @@
+#ifndef OSMIUM_TAGS_DETAIL_STRING_MAP_HPP
+#define OSMIUM_TAGS_DETAIL_STRING_MAP_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osmium {
+
+    namespace tags {
+
+        namespace detail {
+
+            /**
+             * Hash map from strings to values of type T using open
+             * addressing with linear probing. Lookups are done with
+             * NUL-terminated C strings which are hashed and measured
+             * in one pass, no std::string is created for them.
+             *
+             * Entries can only be added, never removed.
+             */
+            template <typename T>
+            class string_map {
+
+                struct slot {
+                    std::string key{};
+                    T value{};
+                    bool used = false;
+                }; // struct slot
+
+                std::vector<slot> m_slots;
+                std::size_t m_size = 0;
+
+                // FNV-1a
+                static uint64_t hash_and_size(const char* str, std::size_t& size) noexcept {
+                    uint64_t hash = 14695981039346656037ull;
+                    const char* s = str;
+                    for (; *s; ++s) {
+                        hash = (hash ^ static_cast<unsigned char>(*s)) * 1099511628211ull;
+                    }
+                    size = static_cast<std::size_t>(s - str);
+                    return hash;
+                }
+
+                static uint64_t hash(const std::string& str) noexcept {
+                    uint64_t hash = 14695981039346656037ull;
+                    for (const char c : str) {
+                        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+                    }
+                    return hash;
+                }
+
+                std::size_t find_slot(uint64_t hash, const char* str, std::size_t size) const noexcept {
+                    const std::size_t mask = m_slots.size() - 1;
+                    for (std::size_t n = static_cast<std::size_t>(hash) & mask; ; n = (n + 1) & mask) {
+                        const slot& s = m_slots[n];
+                        if (!s.used || (s.key.size() == size && !std::memcmp(s.key.data(), str, size))) {
+                            return n;
+                        }
+                    }
+                }
+
+                void grow() {
+                    std::vector<slot> old_slots(m_slots.empty() ? 8 : m_slots.size() * 2);
+                    m_slots.swap(old_slots);
+                    for (slot& s : old_slots) {
+                        if (s.used) {
+                            slot& new_slot = m_slots[find_slot(hash(s.key), s.key.data(), s.key.size())];
+                            new_slot = std::move(s);
+                        }
+                    }
+                }
+
+            public:
+
+                /// The number of entries in the map.
+                std::size_t size() const noexcept {
+                    return m_size;
+                }
+
+                /**
+                 * Find the value for the given key. Returns nullptr if
+                 * the key is not in the map.
+                 */
+                const T* find(const char* key) const noexcept {
+                    if (m_size == 0) {
+                        return nullptr;
+                    }
+                    std::size_t size;
+                    const uint64_t h = hash_and_size(key, size);
+                    const slot& s = m_slots[find_slot(h, key, size)];
+                    return s.used ? &s.value : nullptr;
+                }
+
+                /**
+                 * Get the value for the given key. A value-initialized
+                 * entry is added if the key is not in the map yet. The
+                 * second element of the returned pair tells whether this
+                 * happened.
+                 */
+                std::pair<T*, bool> insert(const std::string& key) {
+                    // keep load factor below 1/2
+                    if ((m_size + 1) * 2 > m_slots.size()) {
+                        grow();
+                    }
+                    slot& s = m_slots[find_slot(hash(key), key.data(), key.size())];
+                    if (s.used) {
+                        return std::make_pair(&s.value, false);
+                    }
+                    s.key = key;
+                    s.used = true;
+                    ++m_size;
+                    return std::make_pair(&s.value, true);
+                }
+
+            }; // class string_map
+
+        } // namespace detail
+
+    } // namespace tags
+
+} // namespace osmium
+
+#endif // OSMIUM_TAGS_DETAIL_STRING_MAP_HPP
@@ -42,6 +42,7 @@ DEALINGS IN THE SOFTWARE.
 
 #include <osmium/memory/collection.hpp>
 #include <osmium/osm/tag.hpp>
+#include <osmium/tags/detail/string_map.hpp>
 
 namespace osmium {
 
@@ -74,6 +75,19 @@ namespace osmium {
             }
         }; // struct match_value<void>
 
+        /**
+         * A filter for tags. It contains an ordered list of rules. Each
+         * rule has a key, optionally a value, and the result returned if
+         * the rule matches a tag. The result of the first matching rule
+         * is returned, if no rule matches, the default result.
+         *
+         * If keys are std::strings compared for equality (as in the
+         * KeyFilter, KeyValueFilter, and RegexFilter) the filter keeps
+         * an index of the rules by key, so matching a tag doesn't scan
+         * all rules. If values are std::strings compared for equality,
+         * too, the rules for each key are compiled into a hash map from
+         * value to result.
+         */
         template <typename TKey, typename TValue=void, typename TKeyComp=match_key<TKey>, typename TValueComp=match_value<TValue>>
         class Filter {
 
@@ -102,9 +116,100 @@ namespace osmium {
 
             }; // struct Rule
 
+            using index_keys = std::integral_constant<bool,
+                std::is_same<TKey, std::string>::value &&
+                std::is_same<TKeyComp, match_key<std::string>>::value>;
+
+            using index_values = std::integral_constant<bool,
+                index_keys::value &&
+                std::is_same<TValue, std::string>::value &&
+                std::is_same<TValueComp, match_value<std::string>>::value>;
+
+            // All rules with the same key. Rules after the first one
+            // ignoring the value can never match, they are not added.
+            struct key_rules {
+
+                // Rules with values in order (if values are not indexed).
+                std::vector<std::size_t> rules{};
+
+                // Result of the first rule for each value (if values are
+                // indexed).
+                detail::string_map<bool> values{};
+
+                // Is there a rule ignoring the value and what is its result?
+                bool has_fallback = false;
+                bool fallback_result = false;
+
+            }; // struct key_rules
+
             std::vector<Rule> m_rules;
+            detail::string_map<key_rules> m_index;
             bool m_default_result;
 
+            void add_to_index(std::false_type /* index_keys */) {
+            }
+
+            void add_to_index(std::true_type /* index_keys */) {
+                const Rule& rule = m_rules.back();
+                key_rules& entry = *m_index.insert(rule.key).first;
+                if (entry.has_fallback) {
+                    return;
+                }
+                if (rule.ignore_value) {
+                    entry.has_fallback = true;
+                    entry.fallback_result = rule.result;
+                } else {
+                    add_value_rule(index_values{}, entry, rule);
+                }
+            }
+
+            void add_value_rule(std::true_type /* index_values */, key_rules& entry, const Rule& rule) {
+                // only the first rule for each value can match
+                const auto r = entry.values.insert(rule.value);
+                if (r.second) {
+                    *r.first = rule.result;
+                }
+            }
+
+            void add_value_rule(std::false_type /* index_values */, key_rules& entry, const Rule&) {
+                entry.rules.push_back(m_rules.size() - 1);
+            }
+
+            bool match_value_rules(std::true_type /* index_values */, const key_rules& entry, const char* value) const {
+                const bool* result = entry.values.find(value);
+                if (result) {
+                    return *result;
+                }
+                return entry.has_fallback ? entry.fallback_result : m_default_result;
+            }
+
+            bool match_value_rules(std::false_type /* index_values */, const key_rules& entry, const char* value) const {
+                for (const std::size_t n : entry.rules) {
+                    const Rule& rule = m_rules[n];
+                    if (TValueComp()(rule.value, value)) {
+                        return rule.result;
+                    }
+                }
+                return entry.has_fallback ? entry.fallback_result : m_default_result;
+            }
+
+            bool match(std::true_type /* index_keys */, const osmium::Tag& tag) const {
+                const key_rules* entry = m_index.find(tag.key());
+                if (!entry) {
+                    return m_default_result;
+                }
+                return match_value_rules(index_values{}, *entry, tag.value());
+            }
+
+            bool match(std::false_type /* index_keys */, const osmium::Tag& tag) const {
+                for (const Rule& rule : m_rules) {
+                    if (TKeyComp()(rule.key, tag.key()) && (rule.ignore_value || TValueComp()(rule.value, tag.value()))) {
+                        return rule.result;
+                    }
+                }
+                return m_default_result;
+            }
+
         public:
 
             using filter_type   = Filter<TKey, TValue, TKeyComp, TValueComp>;
@@ -119,28 +224,25 @@ namespace osmium {
             template <typename V=TValue, typename std::enable_if<!std::is_void<V>::value, int>::type = 0>
             Filter& add(bool result, const key_type& key, const value_type& value) {
                 m_rules.emplace_back(result, false, key, value);
+                add_to_index(index_keys{});
                 return *this;
             }
 
             Filter& add(bool result, const key_type& key) {
                 m_rules.emplace_back(result, true, key);
+                add_to_index(index_keys{});
                 return *this;
             }
 
             bool operator()(const osmium::Tag& tag) const {
-                for (const Rule& rule : m_rules) {
-                    if (TKeyComp()(rule.key, tag.key()) && (rule.ignore_value || TValueComp()(rule.value, tag.value()))) {
-                        return rule.result;
-                    }
-                }
-                return m_default_result;
+                return match(index_keys{}, tag);
             }
 
             /**
              * Return the number of rules in this filter.
              */
             size_t count() const {
-                return m_rules.count();
+                return m_rules.size();
             }
 
             /**
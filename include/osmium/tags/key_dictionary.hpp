@@ -0,0 +1,159 @@
+#ifndef OSMIUM_TAGS_KEY_DICTIONARY_HPP
+#define OSMIUM_TAGS_KEY_DICTIONARY_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <osmium/osm/tag.hpp>
+#include <osmium/tags/detail/string_map.hpp>
+
+namespace osmium {
+
+    namespace tags {
+
+        /**
+         * Maps tag keys to small integer ids. Ids are given out in the
+         * order keys are added to the dictionary starting with 1, the id
+         * 0 (KeyDictionary::unknown) is used for keys not in the
+         * dictionary. So if the dictionary is set up with a fixed list of
+         * keys, their ids can be used in an enum and handlers can
+         * dispatch on the key of a tag with a switch statement instead
+         * of comparing it with all interesting keys one after the other:
+         *
+         * @code
+         * enum key : uint32_t { unknown = 0, highway = 1, building = 2 };
+         * const osmium::tags::KeyDictionary dictionary{"highway", "building"};
+         * ...
+         * for (const auto& tag : way.tags()) {
+         *     switch (tag.key_id(dictionary)) {
+         *         case highway:
+         *             ...
+         *     }
+         * }
+         * @endcode
+         *
+         * Looking up a key hashes it once and compares it with at most
+         * a few keys in the dictionary.
+         *
+         * Lookups are const and can be done from several threads at the
+         * same time, adding keys can not.
+         */
+        class KeyDictionary {
+
+            detail::string_map<uint32_t> m_ids;
+            std::vector<std::string> m_keys;
+
+        public:
+
+            enum : uint32_t {
+                /// The id returned for keys not in the dictionary.
+                unknown = 0
+            };
+
+            KeyDictionary() = default;
+
+            /**
+             * Create a dictionary containing the given keys. They get
+             * the ids 1, 2, ... in order.
+             */
+            KeyDictionary(std::initializer_list<const char*> keys) {
+                for (const char* key : keys) {
+                    add(key);
+                }
+            }
+
+            /// The number of keys in the dictionary.
+            std::size_t size() const noexcept {
+                return m_keys.size();
+            }
+
+            /// Is the dictionary empty?
+            bool empty() const noexcept {
+                return m_keys.empty();
+            }
+
+            /**
+             * Add a key to the dictionary if it isn't in there already.
+             *
+             * @returns The id of the key.
+             */
+            uint32_t add(const std::string& key) {
+                assert(m_keys.size() < std::numeric_limits<uint32_t>::max());
+                const auto result = m_ids.insert(key);
+                if (result.second) {
+                    m_keys.push_back(key);
+                    *result.first = static_cast<uint32_t>(m_keys.size());
+                }
+                return *result.first;
+            }
+
+            /**
+             * Get the id of the given key.
+             *
+             * @returns The id or KeyDictionary::unknown if the key is not
+             *          in the dictionary.
+             */
+            uint32_t lookup(const char* key) const noexcept {
+                const uint32_t* id = m_ids.find(key);
+                return id ? *id : unknown;
+            }
+
+            /**
+             * Get the key with the given id.
+             *
+             * @pre @code id != unknown && id <= size() @endcode
+             */
+            const char* key(uint32_t id) const noexcept {
+                assert(id != unknown && id <= m_keys.size());
+                return m_keys[id - 1].c_str();
+            }
+
+        }; // class KeyDictionary
+
+    } // namespace tags
+
+    inline uint32_t Tag::key_id(const osmium::tags::KeyDictionary& dictionary) const noexcept {
+        return dictionary.lookup(key());
+    }
+
+} // namespace osmium
+
+#endif // OSMIUM_TAGS_KEY_DICTIONARY_HPP
@@ -33,6 +33,7 @@ DEALINGS IN THE SOFTWARE.
 
 */
 
+#include <cstring>
 #include <regex>
 #include <string>
 
@@ -42,6 +43,72 @@ namespace osmium {
 
     namespace tags {
 
+        /**
+         * A regular expression together with the literal prefix all
+         * strings matching it must start with. When matching, the prefix
+         * is compared first and the (much more expensive) regular
+         * expression is only run if the prefix matches.
+         *
+         * The prefix can only be found if the regular expression is
+         * created from a pattern string in the ECMAScript grammar without
+         * the icase flag. A PrefixedRegex created from a std::regex
+         * has an empty prefix and behaves exactly like the std::regex.
+         */
+        class PrefixedRegex {
+
+            std::regex m_regex;
+            std::string m_prefix;
+
+            static std::string literal_prefix(const std::string& pattern, std::regex::flag_type flags) {
+                const auto other_grammars = std::regex::basic | std::regex::extended | std::regex::awk |
+                                            std::regex::grep | std::regex::egrep;
+                if ((flags & (other_grammars | std::regex::icase)) || pattern.find('|') != std::string::npos) {
+                    return std::string{};
+                }
+
+                std::string prefix;
+                for (const char c : pattern) {
+                    if (c == '\0' || std::strchr("\\^$.?*+()[]{}", c)) {
+                        // a quantifier applies to the last literal character
+                        if ((c == '?' || c == '*' || c == '{') && !prefix.empty()) {
+                            prefix.pop_back();
+                        }
+                        break;
+                    }
+                    prefix += c;
+                }
+                return prefix;
+            }
+
+        public:
+
+            PrefixedRegex(const std::string& pattern, std::regex::flag_type flags = std::regex::ECMAScript) :
+                m_regex(pattern, flags),
+                m_prefix(literal_prefix(pattern, flags)) {
+            }
+
+            PrefixedRegex(const char* pattern, std::regex::flag_type flags = std::regex::ECMAScript) :
+                PrefixedRegex(std::string{pattern}, flags) {
+            }
+
+            PrefixedRegex(const std::regex& regex) :
+                m_regex(regex),
+                m_prefix() {
+            }
+
+            /// The literal prefix of the pattern (can be empty).
+            const std::string& prefix() const noexcept {
+                return m_prefix;
+            }
+
+            /// Does the regular expression match the whole string?
+            bool match(const char* str) const {
+                return !std::strncmp(str, m_prefix.data(), m_prefix.size()) &&
+                       std::regex_match(str, m_regex);
+            }
+
+        }; // class PrefixedRegex
+
         template <>
         struct match_key<std::regex> {
             bool operator()(const std::regex& rule_key, const char* tag_key) {
@@ -56,7 +123,21 @@ namespace osmium {
             }
         }; // struct match_value<std::regex>
 
-        using RegexFilter = Filter<std::string, std::regex>;
+        template <>
+        struct match_key<PrefixedRegex> {
+            bool operator()(const PrefixedRegex& rule_key, const char* tag_key) {
+                return rule_key.match(tag_key);
+            }
+        }; // struct match_key<PrefixedRegex>
+
+        template <>
+        struct match_value<PrefixedRegex> {
+            bool operator()(const PrefixedRegex& rule_value, const char* tag_value) {
+                return rule_value.match(tag_value);
+            }
+        }; // struct match_value<PrefixedRegex>
+
+        using RegexFilter = Filter<std::string, PrefixedRegex>;
 
     } // namespace tags
 
@@ -0,0 +1,223 @@
+#ifndef OSMIUM_UTIL_CRC32C_HPP
+#define OSMIUM_UTIL_CRC32C_HPP
+
+/*
+
+This file is part of Osmium (http://osmcode.org/libosmium).
+
+Copyright 2013-2016 Jochen Topf <jochen@topf.org> and others (see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <osmium/util/endian.hpp>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+# define OSMIUM_CRC32C_SSE42
+# include <nmmintrin.h>
+#endif
+
+namespace osmium {
+
+    namespace util {
+
+        namespace detail {
+
+            // CRC32C (Castagnoli) polynomial in reversed bit order.
+            constexpr const uint32_t crc32c_polynomial = 0x82f63b78;
+
+            /**
+             * Lookup tables for the software implementation of CRC32C
+             * processing eight bytes at a time ("slicing-by-8").
+             */
+            struct crc32c_tables {
+
+                uint32_t table[8][256];
+
+                crc32c_tables() noexcept {
+                    for (uint32_t n = 0; n < 256; ++n) {
+                        uint32_t crc = n;
+                        for (int k = 0; k < 8; ++k) {
+                            crc = (crc >> 1) ^ (crc32c_polynomial & (0 - (crc & 1)));
+                        }
+                        table[0][n] = crc;
+                    }
+                    for (uint32_t n = 0; n < 256; ++n) {
+                        for (int k = 1; k < 8; ++k) {
+                            table[k][n] = (table[k - 1][n] >> 8) ^ table[0][table[k - 1][n] & 0xff];
+                        }
+                    }
+                }
+
+                static const crc32c_tables& get() noexcept {
+                    static const crc32c_tables tables;
+                    return tables;
+                }
+
+            }; // struct crc32c_tables
+
+            /**
+             * Portable implementation of CRC32C. Does not do the initial
+             * and final inversion of the CRC.
+             */
+            inline uint32_t crc32c_software(uint32_t crc, const void* data, size_t size) noexcept {
+                const auto& t = crc32c_tables::get().table;
+                auto p = static_cast<const unsigned char*>(data);
+
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+                for (; size >= 8; p += 8, size -= 8) {
+                    uint32_t lo;
+                    uint32_t hi;
+                    std::memcpy(&lo, p, 4);
+                    std::memcpy(&hi, p + 4, 4);
+                    lo ^= crc;
+                    crc = t[7][lo & 0xff] ^
+                          t[6][(lo >> 8) & 0xff] ^
+                          t[5][(lo >> 16) & 0xff] ^
+                          t[4][lo >> 24] ^
+                          t[3][hi & 0xff] ^
+                          t[2][(hi >> 8) & 0xff] ^
+                          t[1][(hi >> 16) & 0xff] ^
+                          t[0][hi >> 24];
+                }
+#endif
+
+                for (; size > 0; ++p, --size) {
+                    crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xff];
+                }
+
+                return crc;
+            }
+
+#ifdef OSMIUM_CRC32C_SSE42
+            /**
+             * Implementation of CRC32C using the crc32 instruction from
+             * SSE 4.2. Only call this if has_crc32c_hardware() returns
+             * true. Does not do the initial and final inversion of the
+             * CRC.
+             */
+            __attribute__((target("sse4.2")))
+            inline uint32_t crc32c_hardware(uint32_t crc, const void* data, size_t size) noexcept {
+                auto p = static_cast<const unsigned char*>(data);
+
+# ifdef __x86_64__
+                uint64_t crc64 = crc;
+                for (; size >= 8; p += 8, size -= 8) {
+                    uint64_t value;
+                    std::memcpy(&value, p, 8);
+                    crc64 = _mm_crc32_u64(crc64, value);
+                }
+                crc = static_cast<uint32_t>(crc64);
+# endif
+
+                for (; size >= 4; p += 4, size -= 4) {
+                    uint32_t value;
+                    std::memcpy(&value, p, 4);
+                    crc = _mm_crc32_u32(crc, value);
+                }
+
+                for (; size > 0; ++p, --size) {
+                    crc = _mm_crc32_u8(crc, *p);
+                }
+
+                return crc;
+            }
+
+            inline bool has_crc32c_hardware() noexcept {
+                static const bool supported = __builtin_cpu_supports("sse4.2");
+                return supported;
+            }
+#else
+            inline uint32_t crc32c_hardware(uint32_t crc, const void* data, size_t size) noexcept {
+                return crc32c_software(crc, data, size);
+            }
+
+            inline bool has_crc32c_hardware() noexcept {
+                return false;
+            }
+#endif
+
+        } // namespace detail
+
+        /**
+         * Calculates the CRC32C (Castagnoli) checksum. Uses the crc32
+         * instruction of SSE 4.2 if the CPU supports it (detected at
+         * runtime) and a portable table-driven implementation otherwise.
+         * Both return the same results.
+         *
+         * This has the same interface as the Boost CRC classes, so it can
+         * be used with the osmium::CRC class:
+         * @code
+         *   osmium::CRC<osmium::util::CRC32C> crc32;
+         *   crc32.update(node);
+         *   auto checksum = crc32().checksum();
+         * @endcode
+         */
+        class CRC32C {
+
+            uint32_t m_crc = 0xffffffff;
+            bool m_hardware = detail::has_crc32c_hardware();
+
+        public:
+
+            CRC32C() = default;
+
+            /// Is the crc32 instruction used?
+            bool hardware() const noexcept {
+                return m_hardware;
+            }
+
+            void process_byte(unsigned char byte) noexcept {
+                process_bytes(&byte, 1);
+            }
+
+            void process_bytes(const void* data, size_t size) noexcept {
+                if (m_hardware) {
+                    m_crc = detail::crc32c_hardware(m_crc, data, size);
+                } else {
+                    m_crc = detail::crc32c_software(m_crc, data, size);
+                }
+            }
+
+            uint32_t checksum() const noexcept {
+                return ~m_crc;
+            }
+
+            void reset() noexcept {
+                m_crc = 0xffffffff;
+            }
+
+        }; // class CRC32C
+
+    } // namespace util
+
+} // namespace osmium
+
+#endif // OSMIUM_UTIL_CRC32C_HPP
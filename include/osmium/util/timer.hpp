@@ -65,6 +65,10 @@ namespace osmium {
             return std::chrono::duration_cast<std::chrono::microseconds>(m_stop - m_start).count();
         }
 
+        int64_t elapsed_nanoseconds() const {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(m_stop - m_start).count();
+        }
+
     };
 
 } // namespace osmium
@@ -89,6 +93,10 @@ namespace osmium {
             return 0;
         }
 
+        int64_t elapsed_nanoseconds() const {
+            return 0;
+        }
+
     };
 
 } // namespace osmium
@@ -33,14 +33,17 @@ DEALINGS IN THE SOFTWARE.
 
 */
 
+#include <cstdint>
 #include <type_traits>
 #include <utility>
 
 #include <osmium/fwd.hpp>
+#include <osmium/handler.hpp>
 #include <osmium/io/reader_iterator.hpp> // IWYU pragma: keep
 #include <osmium/memory/buffer.hpp>
 #include <osmium/osm.hpp>
 #include <osmium/osm/entity.hpp>
+#include <osmium/osm/entity_bits.hpp>
 #include <osmium/osm/item_type.hpp>
 
 namespace osmium {
@@ -198,12 +201,89 @@ namespace osmium {
             }
         }
 
+/**
+ * Defines a trait detail::overrides_CALLBACK<THandler> which is false if
+ * THandler uses the empty CALLBACK function inherited from the
+ * osmium::handler::Handler class and true otherwise. It is also true if
+ * the callback is overloaded or a template, because in that case we can't
+ * tell whether it does anything.
+ */
+#define OSMIUM_HANDLER_OVERRIDES(callback) \
+        template <typename THandler, typename = void> \
+        struct overrides_##callback : public std::true_type { \
+        }; \
+        template <typename THandler> \
+        struct overrides_##callback<THandler, typename std::enable_if<std::is_same<decltype(&THandler::callback), decltype(&osmium::handler::Handler::callback)>::value>::type> : public std::false_type { \
+        };
+
+        OSMIUM_HANDLER_OVERRIDES(osm_object)
+        OSMIUM_HANDLER_OVERRIDES(node)
+        OSMIUM_HANDLER_OVERRIDES(way)
+        OSMIUM_HANDLER_OVERRIDES(relation)
+        OSMIUM_HANDLER_OVERRIDES(area)
+        OSMIUM_HANDLER_OVERRIDES(changeset)
+
+#undef OSMIUM_HANDLER_OVERRIDES
+
+        /**
+         * The OSM entities the handler is interested in, ie the entities
+         * for which it has callbacks other than the empty ones from the
+         * osmium::handler::Handler class.
+         */
+        template <typename THandler>
+        constexpr osmium::osm_entity_bits::type handler_entities() noexcept {
+            using handler_type = typename std::decay<THandler>::type;
+            return (overrides_osm_object<handler_type>::value ? osmium::osm_entity_bits::object : osmium::osm_entity_bits::nothing) |
+                   (overrides_node<handler_type>::value       ? osmium::osm_entity_bits::node : osmium::osm_entity_bits::nothing) |
+                   (overrides_way<handler_type>::value        ? osmium::osm_entity_bits::way : osmium::osm_entity_bits::nothing) |
+                   (overrides_relation<handler_type>::value   ? osmium::osm_entity_bits::relation : osmium::osm_entity_bits::nothing) |
+                   (overrides_area<handler_type>::value       ? osmium::osm_entity_bits::area : osmium::osm_entity_bits::nothing) |
+                   (overrides_changeset<handler_type>::value  ? osmium::osm_entity_bits::changeset : osmium::osm_entity_bits::nothing);
+        }
+
+        /// The OSM entities any of the handlers is interested in.
+        template <typename... THandlers>
+        constexpr typename std::enable_if<sizeof...(THandlers) == 0, osmium::osm_entity_bits::type>::type handlers_entities() noexcept {
+            return osmium::osm_entity_bits::nothing;
+        }
+
+        template <typename THandler, typename... THandlers>
+        constexpr osmium::osm_entity_bits::type handlers_entities() noexcept {
+            return handler_entities<THandler>() | handlers_entities<THandlers...>();
+        }
+
+        /**
+         * Does an item of this type have to be dispatched to handlers
+         * interested in the given entities? Items which are not OSM
+         * entities (such as tag lists) are always dispatched.
+         */
+        inline bool dispatch_item(osmium::item_type type, osmium::osm_entity_bits::type entities) noexcept {
+            const auto ut = static_cast<uint16_t>(type);
+            if (ut == 0 || ut > static_cast<uint16_t>(osmium::item_type::changeset)) {
+                return true;
+            }
+            return (entities & static_cast<osmium::osm_entity_bits::type>(0x1 << (ut - 1))) != 0;
+        }
+
+        template <typename THandler, typename TItem>
+        inline void apply_item_if_handled(TItem& item, THandler&& handler) {
+            if (handler_entities<THandler>() == osmium::osm_entity_bits::all ||
+                dispatch_item(item.type(), handler_entities<THandler>())) {
+                apply_item_impl(item, std::forward<THandler>(handler));
+            }
+        }
+
     } // namespace detail
 
+    /**
+     * Call the callbacks of all handlers for the item. Handlers derived
+     * from osmium::handler::Handler are not called at all for OSM entities
+     * they don't have callbacks for, this is detected at compile time.
+     */
     template <typename TItem, typename... THandlers>
     inline void apply_item(TItem& item, THandlers&&... handlers) {
         (void)std::initializer_list<int>{
-            (detail::apply_item_impl(item, std::forward<THandlers>(handlers)), 0)...
+            (detail::apply_item_if_handled(item, std::forward<THandlers>(handlers)), 0)...
         };
     }
 
@@ -214,10 +294,18 @@ namespace osmium {
         };
     }
 
+    /**
+     * Apply all handlers to all items from the iterator range and call
+     * their flush() functions at the end. Items none of the handlers is
+     * interested in are skipped without looking at them any further.
+     */
     template <typename TIterator, typename... THandlers>
     inline void apply(TIterator it, TIterator end, THandlers&&... handlers) {
+        constexpr const osmium::osm_entity_bits::type entities = detail::handlers_entities<THandlers...>();
         for (; it != end; ++it) {
-            apply_item(*it, std::forward<THandlers>(handlers)...);
+            if (entities == osmium::osm_entity_bits::all || detail::dispatch_item(it->type(), entities)) {
+                apply_item(*it, std::forward<THandlers>(handlers)...);
+            }
         }
         apply_flush(std::forward<THandlers>(handlers)...);
     }
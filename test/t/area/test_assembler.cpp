@@ -0,0 +1,360 @@
+#include "catch.hpp"
+
+#include <vector>
+
+#include <osmium/area/assembler.hpp>
+#include <osmium/area/multipolygon_collector.hpp>
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/area.hpp>
+#include <osmium/osm/way.hpp>
+#include <osmium/visitor.hpp>
+
+using namespace osmium::builder::attr;
+
+namespace {
+
+    std::vector<osmium::object_id_type> outer_ring_ids(const osmium::Area& area) {
+        std::vector<osmium::object_id_type> ids;
+        for (const auto& ring : area.outer_rings()) {
+            for (const auto& nr : ring) {
+                ids.push_back(nr.ref());
+            }
+        }
+        return ids;
+    }
+
+    const osmium::Area& assemble(const osmium::Way& way, osmium::memory::Buffer& out, osmium::area::area_stats& stats) {
+        osmium::area::AssemblerConfig config;
+        osmium::area::Assembler assembler{config};
+        assembler(way, out);
+        stats = assembler.stats();
+        REQUIRE(out.committed() > 0);
+        return out.get<osmium::Area>(0);
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Assemble area from closed way") {
+    osmium::memory::Buffer buffer{10240};
+    osmium::memory::Buffer out{10240};
+    osmium::area::area_stats stats;
+
+    SECTION("counter-clockwise way not starting at smallest location") {
+        osmium::builder::add_way(buffer,
+            _id(1),
+            _tag("building", "yes"),
+            _nodes({
+                {3, {1.0, 1.0}},
+                {4, {0.0, 1.0}},
+                {1, {0.0, 0.0}},
+                {2, {1.0, 0.0}},
+                {3, {1.0, 1.0}}
+            })
+        );
+
+        const osmium::Area& area = assemble(buffer.get<osmium::Way>(0), out, stats);
+        REQUIRE(area.id() == 2);
+        REQUIRE(area.tags().size() == 1);
+        REQUIRE(outer_ring_ids(area) == (std::vector<osmium::object_id_type>{1, 2, 3, 4, 1}));
+        REQUIRE(stats.from_ways == 1);
+        REQUIRE(stats.nodes == 4);
+        REQUIRE(stats.area_simple_case == 1);
+        REQUIRE(stats.outer_rings == 1);
+        REQUIRE(stats.inner_rings == 0);
+    }
+
+    SECTION("clockwise way is reversed") {
+        osmium::builder::add_way(buffer,
+            _id(1),
+            _nodes({
+                {1, {0.0, 0.0}},
+                {4, {0.0, 1.0}},
+                {3, {1.0, 1.0}},
+                {2, {1.0, 0.0}},
+                {1, {0.0, 0.0}}
+            })
+        );
+
+        const osmium::Area& area = assemble(buffer.get<osmium::Way>(0), out, stats);
+        REQUIRE(outer_ring_ids(area) == (std::vector<osmium::object_id_type>{1, 2, 3, 4, 1}));
+        REQUIRE(stats.area_simple_case == 1);
+    }
+
+    SECTION("way with duplicate node") {
+        osmium::builder::add_way(buffer,
+            _id(1),
+            _nodes({
+                {1, {0.0, 0.0}},
+                {2, {1.0, 0.0}},
+                {5, {1.0, 0.0}},
+                {3, {1.0, 1.0}},
+                {4, {0.0, 1.0}},
+                {1, {0.0, 0.0}}
+            })
+        );
+
+        const osmium::Area& area = assemble(buffer.get<osmium::Way>(0), out, stats);
+        REQUIRE(outer_ring_ids(area).size() == 5);
+        REQUIRE(stats.duplicate_nodes == 1);
+        REQUIRE(stats.nodes == 4);
+    }
+
+    SECTION("self-intersecting way results in empty area") {
+        osmium::builder::add_way(buffer,
+            _id(1),
+            _nodes({
+                {1, {0.0, 0.0}},
+                {2, {1.0, 1.0}},
+                {3, {1.0, 0.0}},
+                {4, {0.0, 1.0}},
+                {1, {0.0, 0.0}}
+            })
+        );
+
+        const osmium::Area& area = assemble(buffer.get<osmium::Way>(0), out, stats);
+        REQUIRE(area.num_rings().first == 0);
+        REQUIRE(stats.intersections == 1);
+    }
+
+    SECTION("way with spike results in empty area") {
+        osmium::builder::add_way(buffer,
+            _id(1),
+            _nodes({
+                {1, {0.0, 0.0}},
+                {2, {2.0, 0.0}},
+                {3, {1.0, 0.0}},
+                {4, {1.0, 1.0}},
+                {1, {0.0, 0.0}}
+            })
+        );
+
+        const osmium::Area& area = assemble(buffer.get<osmium::Way>(0), out, stats);
+        REQUIRE(area.num_rings().first == 0);
+    }
+
+    SECTION("way touching itself") {
+        osmium::builder::add_way(buffer,
+            _id(1),
+            _nodes({
+                {1, {0.0, 0.0}},
+                {2, {1.0, 0.0}},
+                {3, {1.0, 1.0}},
+                {4, {2.0, 1.0}},
+                {5, {2.0, 2.0}},
+                {6, {1.0, 2.0}},
+                {3, {1.0, 1.0}},
+                {7, {0.0, 1.0}},
+                {1, {0.0, 0.0}}
+            })
+        );
+
+        const osmium::Area& area = assemble(buffer.get<osmium::Way>(0), out, stats);
+        REQUIRE(area.num_rings().first == 2);
+        REQUIRE(stats.area_touching_rings_case == 1);
+    }
+
+}
+
+TEST_CASE("MultipolygonCollector builds areas from closed ways") {
+    osmium::memory::Buffer buffer{102400};
+
+    for (osmium::object_id_type id = 1; id <= 100; ++id) {
+        const double x = static_cast<double>(id);
+        osmium::builder::add_way(buffer,
+            _id(id),
+            _tag("building", "yes"),
+            _nodes({
+                {id * 10 + 1, {x,       0.0}},
+                {id * 10 + 2, {x + 0.5, 0.0}},
+                {id * 10 + 3, {x + 0.5, 0.5}},
+                {id * 10 + 1, {x,       0.0}}
+            })
+        );
+    }
+
+    osmium::area::AssemblerConfig config;
+    osmium::area::MultipolygonCollector<osmium::area::Assembler> collector{config};
+
+    std::vector<osmium::object_id_type> area_ids;
+    osmium::apply(buffer, collector.handler([&area_ids](osmium::memory::Buffer&& areas) {
+        for (const auto& area : areas.select<osmium::Area>()) {
+            area_ids.push_back(area.id());
+        }
+    }));
+
+    REQUIRE(area_ids.size() == 100);
+    for (osmium::object_id_type id = 1; id <= 100; ++id) {
+        REQUIRE(area_ids[id - 1] == id * 2);
+    }
+    REQUIRE(collector.stats().from_ways == 100);
+    REQUIRE(collector.stats().area_simple_case == 100);
+}
+
+TEST_CASE("MultipolygonCollector builds areas from closed ways in parallel") {
+    osmium::memory::Buffer buffer{1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+
+    for (osmium::object_id_type id = 1; id <= 10000; ++id) {
+        const double x = static_cast<double>(id % 100);
+        const double y = static_cast<double>(id / 100);
+        osmium::builder::add_way(buffer,
+            _id(id),
+            _tag("building", "yes"),
+            _nodes({
+                {id * 10 + 1, {x,       y}},
+                {id * 10 + 2, {x + 0.5, y}},
+                {id * 10 + 3, {x + 0.5, y + 0.5}},
+                {id * 10 + 1, {x,       y}}
+            })
+        );
+    }
+
+    osmium::area::AssemblerConfig config;
+    osmium::area::MultipolygonCollector<osmium::area::Assembler> collector{config};
+    collector.set_parallel_way_assembly();
+
+    std::vector<osmium::object_id_type> area_ids;
+    osmium::apply(buffer, collector.handler([&area_ids](osmium::memory::Buffer&& areas) {
+        for (const auto& area : areas.select<osmium::Area>()) {
+            REQUIRE(area.num_rings().first == 1);
+            area_ids.push_back(area.id());
+        }
+    }));
+
+    REQUIRE(area_ids.size() == 10000);
+    for (osmium::object_id_type id = 1; id <= 10000; ++id) {
+        REQUIRE(area_ids[id - 1] == id * 2);
+    }
+    REQUIRE(collector.stats().from_ways == 10000);
+    REQUIRE(collector.stats().area_simple_case == 10000);
+}
+
+TEST_CASE("Re-use assembler for several areas") {
+    osmium::memory::Buffer buffer{10240};
+
+    const auto way1 = osmium::builder::add_way(buffer,
+        _id(1),
+        _nodes({
+            {1, {0.0, 0.0}},
+            {2, {1.0, 0.0}},
+            {3, {1.0, 1.0}},
+            {1, {0.0, 0.0}}
+        })
+    );
+
+    const auto way2 = osmium::builder::add_way(buffer,
+        _id(2),
+        _nodes({
+            {1, {0.0, 0.0}},
+            {2, {1.0, 1.0}},
+            {3, {1.0, 0.0}},
+            {4, {0.0, 1.0}},
+            {1, {0.0, 0.0}}
+        })
+    );
+
+    osmium::area::AssemblerConfig config;
+    osmium::area::Assembler assembler{config};
+    osmium::memory::Buffer out{10240};
+
+    assembler(buffer.get<osmium::Way>(way2), out);
+    REQUIRE(assembler.stats().intersections == 1);
+    REQUIRE(assembler.stats().nodes == 4);
+    const auto max_scratch_memory = assembler.stats().max_scratch_memory;
+    REQUIRE(max_scratch_memory > 0);
+
+    assembler(buffer.get<osmium::Way>(way1), out);
+    REQUIRE(assembler.stats().intersections == 0);
+    REQUIRE(assembler.stats().nodes == 3);
+    REQUIRE(assembler.stats().from_ways == 1);
+    REQUIRE(assembler.stats().max_scratch_memory == max_scratch_memory);
+
+    assembler(buffer.get<osmium::Way>(way2), out);
+    REQUIRE(assembler.stats().intersections == 1);
+    REQUIRE(assembler.stats().max_scratch_memory == max_scratch_memory);
+
+    int areas = 0;
+    for (const auto& area : out.select<osmium::Area>()) {
+        REQUIRE(area.num_rings().first == (area.id() == 2 ? 1 : 0));
+        ++areas;
+    }
+    REQUIRE(areas == 3);
+}
+
+TEST_CASE("Adding area stats keeps the maximum scratch memory") {
+    osmium::area::area_stats s1;
+    s1.nodes = 10;
+    s1.max_scratch_memory = 100;
+    s1.time_build_rings = 1000;
+
+    osmium::area::area_stats s2;
+    s2.nodes = 5;
+    s2.max_scratch_memory = 50;
+    s2.time_build_rings = 500;
+
+    s1 += s2;
+    REQUIRE(s1.nodes == 15);
+    REQUIRE(s1.max_scratch_memory == 100);
+    REQUIRE(s1.time_build_rings == 1500);
+
+    s2 += s1;
+    REQUIRE(s2.max_scratch_memory == 100);
+}
+
+TEST_CASE("Re-use assembler for relations with inner ways that are areas") {
+    osmium::memory::Buffer buffer{10240};
+
+    const auto relation_pos = osmium::builder::add_relation(buffer,
+        _id(1),
+        _tag("type", "multipolygon"),
+        _tag("landuse", "forest"),
+        _member(osmium::item_type::way, 1, "outer"),
+        _member(osmium::item_type::way, 2, "inner")
+    );
+
+    const auto outer_pos = osmium::builder::add_way(buffer,
+        _id(1),
+        _nodes({
+            {1, {0.0, 0.0}},
+            {2, {10.0, 0.0}},
+            {3, {10.0, 10.0}},
+            {4, {0.0, 10.0}},
+            {1, {0.0, 0.0}}
+        })
+    );
+
+    const auto inner_pos = osmium::builder::add_way(buffer,
+        _id(2),
+        _tag("natural", "water"),
+        _nodes({
+            {5, {2.0, 2.0}},
+            {6, {2.0, 4.0}},
+            {7, {4.0, 4.0}},
+            {8, {4.0, 2.0}},
+            {5, {2.0, 2.0}}
+        })
+    );
+
+    const auto& relation = buffer.get<osmium::Relation>(relation_pos);
+    const std::vector<const osmium::Way*> members = {
+        &buffer.get<osmium::Way>(outer_pos),
+        &buffer.get<osmium::Way>(inner_pos)
+    };
+
+    osmium::area::AssemblerConfig config;
+    osmium::area::Assembler assembler{config};
+    osmium::memory::Buffer out{10240};
+
+    assembler(relation, members, out);
+    const auto max_scratch_memory = assembler.stats().max_scratch_memory;
+    REQUIRE(max_scratch_memory > 0);
+
+    assembler(relation, members, out);
+    REQUIRE(assembler.stats().max_scratch_memory == max_scratch_memory);
+
+    std::vector<osmium::object_id_type> area_ids;
+    for (const auto& area : out.select<osmium::Area>()) {
+        area_ids.push_back(area.id());
+    }
+    REQUIRE(area_ids == (std::vector<osmium::object_id_type>{3, 4, 3, 4}));
+}
@@ -0,0 +1,157 @@
+#include "catch.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/extract/extractor.hpp>
+#include <osmium/extract/polygon.hpp>
+#include <osmium/index/id_set.hpp>
+#include <osmium/io/opl_input.hpp>
+#include <osmium/io/opl_output.hpp>
+#include <osmium/io/reader.hpp>
+#include <osmium/io/writer.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/box.hpp>
+#include <osmium/osm/object.hpp>
+
+namespace {
+
+    const std::string input =
+        "n1 v1 x1.5 y1.5\n"
+        "n2 v1 x2.5 y1.5\n"
+        "n3 v1 x5.5 y5.5\n"
+        "n4 v1 x9.5 y9.5\n"
+        "w10 v1 Nn1,n2\n"
+        "w11 v1 Nn2,n3\n"
+        "w12 v1 Nn3,n4\n"
+        "w13 v1 Nn4\n"
+        "r20 v1 Mw10@\n"
+        "r21 v1 Mn4@\n"
+        "r22 v1 Mr20@,r21@\n";
+
+    struct collector {
+
+        std::vector<std::string> ids;
+
+        void operator()(osmium::memory::Buffer&& buffer) {
+            for (const auto& object : buffer.select<osmium::OSMObject>()) {
+                ids.push_back(osmium::item_type_to_char(object.type()) + std::to_string(object.id()));
+            }
+        }
+
+    }; // struct collector
+
+    template <typename TIdSet>
+    void check_extracts() {
+        collector c1;
+        collector c2;
+        collector c3;
+
+        osmium::extract::Extractor<TIdSet> extractor;
+        extractor.add_extract(osmium::extract::Polygon{osmium::Box{1.0, 1.0, 3.0, 3.0}}, [&c1](osmium::memory::Buffer&& buffer) {
+            c1(std::move(buffer));
+        });
+        extractor.add_extract(osmium::extract::Polygon{osmium::Box{5.0, 5.0, 10.0, 10.0}}, [&c2](osmium::memory::Buffer&& buffer) {
+            c2(std::move(buffer));
+        });
+        extractor.add_extract(osmium::extract::Polygon{osmium::Box{20.0, 20.0, 30.0, 30.0}}, [&c3](osmium::memory::Buffer&& buffer) {
+            c3(std::move(buffer));
+        });
+        REQUIRE(extractor.num_extracts() == 3);
+
+        osmium::io::Reader reader{osmium::io::File{input.data(), input.size(), "opl"}};
+        extractor.apply(reader);
+        reader.close();
+
+        REQUIRE(c1.ids == (std::vector<std::string>{"n1", "n2", "w10", "w11", "r20", "r22"}));
+        REQUIRE(c2.ids == (std::vector<std::string>{"n3", "n4", "w11", "w12", "w13", "r21", "r22"}));
+        REQUIRE(c3.ids.empty());
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Extractor with IdSetDense") {
+    check_extracts<osmium::index::IdSetDense<osmium::unsigned_object_id_type>>();
+}
+
+TEST_CASE("Extractor with IdSetCompressed") {
+    check_extracts<osmium::index::IdSetCompressed<osmium::unsigned_object_id_type>>();
+}
+
+TEST_CASE("Extractor with single extract") {
+    osmium::memory::Buffer buffer{1024, osmium::memory::Buffer::auto_grow::yes};
+    {
+        osmium::io::Reader reader{osmium::io::File{input.data(), input.size(), "opl"}};
+        while (osmium::memory::Buffer b = reader.read()) {
+            buffer.add_buffer(b);
+            buffer.commit();
+        }
+        reader.close();
+    }
+
+    collector c;
+    osmium::extract::Extractor<> extractor;
+    extractor.add_extract(osmium::extract::Polygon{osmium::Box{5.0, 5.0, 6.0, 6.0}}, [&c](osmium::memory::Buffer&& b) {
+        c(std::move(b));
+    });
+    extractor(buffer);
+    REQUIRE(c.ids.empty());
+    extractor.flush();
+    REQUIRE(c.ids == (std::vector<std::string>{"n3", "w11", "w12"}));
+}
+
+TEST_CASE("Extractor writing to several writers") {
+    using namespace osmium::builder::attr; // NOLINT(google-build-using-namespace)
+
+    // Enough nodes so that the extract buffers are flushed several times
+    // while processing the input.
+    const int num_nodes = 100000;
+    const int nodes_per_buffer = 1000;
+
+    {
+        osmium::io::Header header;
+        osmium::io::Writer writer1{"test-extractor-out-1.opl", header, osmium::io::overwrite::allow};
+        osmium::io::Writer writer2{"test-extractor-out-2.opl", header, osmium::io::overwrite::allow};
+        osmium::io::Writer writer3{"test-extractor-out-3.opl", header, osmium::io::overwrite::allow};
+
+        osmium::extract::Extractor<> extractor;
+        extractor.add_extract(osmium::extract::Polygon{osmium::Box{0.0, 0.0, 10.0, 10.0}}, writer1);
+        extractor.add_extract(osmium::extract::Polygon{osmium::Box{10.0, 0.0, 20.0, 10.0}}, writer2);
+        extractor.add_extract(osmium::extract::Polygon{osmium::Box{0.0, 0.0, 20.0, 10.0}}, writer3);
+
+        for (int id = 1; id <= num_nodes; id += nodes_per_buffer) {
+            osmium::memory::Buffer buffer{1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+            for (int n = id; n < id + nodes_per_buffer; ++n) {
+                const double x = (n % 2 == 0) ? 5.0 : 15.0;
+                osmium::builder::add_node(buffer, _id(n), _version(1), _location(osmium::Location{x, 5.0}));
+            }
+            extractor(buffer);
+        }
+        extractor.flush();
+
+        writer1.close();
+        writer2.close();
+        writer3.close();
+    }
+
+    const auto count_nodes = [](const char* filename, int remainder) {
+        std::size_t count = 0;
+        osmium::io::Reader reader{filename};
+        while (osmium::memory::Buffer buffer = reader.read()) {
+            for (const auto& node : buffer.select<osmium::Node>()) {
+                if (remainder >= 0 && node.id() % 2 != remainder) {
+                    return std::size_t{0};
+                }
+                ++count;
+            }
+        }
+        reader.close();
+        return count;
+    };
+
+    REQUIRE(count_nodes("test-extractor-out-1.opl", 0) == num_nodes / 2);
+    REQUIRE(count_nodes("test-extractor-out-2.opl", 1) == num_nodes / 2);
+    REQUIRE(count_nodes("test-extractor-out-3.opl", -1) == num_nodes);
+}
@@ -0,0 +1,199 @@
+#include "catch.hpp"
+
+#include <cmath>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/extract/geojson.hpp>
+#include <osmium/extract/polygon.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/area.hpp>
+#include <osmium/osm/box.hpp>
+#include <osmium/osm/location.hpp>
+
+using namespace osmium::builder::attr;
+
+namespace {
+
+    // Simple point-in-polygon check for comparison.
+    bool brute_force_contains(const std::vector<std::vector<osmium::Location>>& rings, const osmium::Location& location) {
+        bool inside = false;
+        for (const auto& ring : rings) {
+            for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+                const double xi = ring[i].lon();
+                const double yi = ring[i].lat();
+                const double xj = ring[j].lon();
+                const double yj = ring[j].lat();
+                if ((yi > location.lat()) != (yj > location.lat()) &&
+                    location.lon() < (xj - xi) * (location.lat() - yi) / (yj - yi) + xi) {
+                    inside = !inside;
+                }
+            }
+        }
+        return inside;
+    }
+
+    // Star shaped ring with many segments and a hole in the middle.
+    std::vector<std::vector<osmium::Location>> star_rings() {
+        std::vector<std::vector<osmium::Location>> rings(2);
+        for (int i = 0; i < 1000; ++i) {
+            const double angle = 2 * 3.14159265 * i / 1000;
+            const double r = (i % 2) ? 10.0 : 4.0;
+            rings[0].emplace_back(5.0 + r * std::cos(angle), 40.0 + r * std::sin(angle));
+        }
+        for (int i = 0; i < 40; ++i) {
+            const double angle = 2 * 3.14159265 * i / 40;
+            rings[1].emplace_back(5.0 + std::cos(angle), 40.0 + std::sin(angle));
+        }
+        return rings;
+    }
+
+    // Minimal JSON value with the interface of rapidjson::Value used by
+    // polygon_from_geojson().
+    class MockJson {
+
+        std::string m_string;
+        double m_number = 0.0;
+        std::vector<MockJson> m_array;
+        std::map<std::string, MockJson> m_object;
+        int m_kind; // 0 number, 1 string, 2 array, 3 object
+
+    public:
+
+        MockJson(double number) : m_number(number), m_kind(0) {} // NOLINT
+        MockJson(const char* string) : m_string(string), m_kind(1) {} // NOLINT
+        explicit MockJson(const std::vector<MockJson>& array) : m_array(array), m_kind(2) {}
+        explicit MockJson(const std::map<std::string, MockJson>& object) : m_object(object), m_kind(3) {}
+
+        bool IsNumber() const { return m_kind == 0; }
+        bool IsString() const { return m_kind == 1; }
+        bool IsArray() const { return m_kind == 2; }
+        bool IsObject() const { return m_kind == 3; }
+        double GetDouble() const { return m_number; }
+        const char* GetString() const { return m_string.c_str(); }
+        const std::vector<MockJson>& GetArray() const { return m_array; }
+        unsigned Size() const { return static_cast<unsigned>(m_array.size()); }
+        const MockJson& operator[](unsigned n) const { return m_array[n]; }
+        const MockJson& operator[](const char* key) const { return m_object.at(key); }
+        bool HasMember(const char* key) const { return m_object.count(key) > 0; }
+
+    }; // class MockJson
+
+    MockJson arr(const std::vector<MockJson>& values) {
+        return MockJson{values};
+    }
+
+    MockJson obj(const char* type, const char* key, const MockJson& value) {
+        return MockJson{std::map<std::string, MockJson>{{"type", type}, {key, value}}};
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Polygon from box") {
+    const osmium::Box box{1.0, 2.0, 3.0, 4.0};
+    const osmium::extract::Polygon polygon{box};
+
+    REQUIRE(polygon.envelope() == box);
+    REQUIRE(polygon.num_segments() == 4);
+    REQUIRE(polygon.contains(osmium::Location{2.0, 3.0}));
+    REQUIRE(polygon.contains(osmium::Location{1.5, 3.9}));
+    REQUIRE_FALSE(polygon.contains(osmium::Location{0.5, 3.0}));
+    REQUIRE_FALSE(polygon.contains(osmium::Location{2.0, 4.5}));
+    REQUIRE_FALSE(polygon.contains(osmium::Location{}));
+}
+
+TEST_CASE("Empty polygon contains nothing") {
+    const osmium::extract::Polygon polygon{std::vector<std::vector<osmium::Location>>{}};
+    REQUIRE(polygon.num_segments() == 0);
+    REQUIRE_FALSE(polygon.contains(osmium::Location{1.0, 1.0}));
+}
+
+TEST_CASE("Polygon with many segments and a hole") {
+    const auto rings = star_rings();
+    const osmium::extract::Polygon polygon{rings};
+    REQUIRE(polygon.num_segments() == 1040);
+
+    REQUIRE_FALSE(polygon.contains(osmium::Location{5.0, 40.0}));
+    REQUIRE(polygon.contains(osmium::Location{7.0, 40.0}));
+    REQUIRE_FALSE(polygon.contains(osmium::Location{20.0, 40.0}));
+
+    std::mt19937 gen{42};
+    std::uniform_real_distribution<double> dx{-6.0, 16.0};
+    std::uniform_real_distribution<double> dy{29.0, 51.0};
+    int inside = 0;
+    for (int i = 0; i < 100000; ++i) {
+        const osmium::Location location{dx(gen), dy(gen)};
+        const bool result = polygon.contains(location);
+        REQUIRE(result == brute_force_contains(rings, location));
+        inside += result;
+    }
+    REQUIRE(inside > 10000);
+}
+
+TEST_CASE("Polygon from area") {
+    osmium::memory::Buffer buffer{10240};
+    osmium::builder::add_area(buffer,
+        _id(2),
+        _outer_ring({
+            {1, {0.0, 0.0}},
+            {2, {4.0, 0.0}},
+            {3, {4.0, 4.0}},
+            {4, {0.0, 4.0}},
+            {1, {0.0, 0.0}}
+        }),
+        _inner_ring({
+            {5, {1.0, 1.0}},
+            {6, {1.0, 2.0}},
+            {7, {2.0, 2.0}},
+            {8, {2.0, 1.0}},
+            {5, {1.0, 1.0}}
+        }),
+        _outer_ring({
+            {11, {10.0, 10.0}},
+            {12, {11.0, 10.0}},
+            {13, {11.0, 11.0}},
+            {11, {10.0, 10.0}}
+        })
+    );
+
+    const osmium::extract::Polygon polygon{buffer.get<osmium::Area>(0)};
+    REQUIRE(polygon.num_segments() == 11);
+    REQUIRE(polygon.contains(osmium::Location{3.0, 3.0}));
+    REQUIRE_FALSE(polygon.contains(osmium::Location{1.5, 1.5}));
+    REQUIRE(polygon.contains(osmium::Location{10.9, 10.5}));
+    REQUIRE_FALSE(polygon.contains(osmium::Location{10.1, 10.5}));
+    REQUIRE_FALSE(polygon.contains(osmium::Location{7.0, 7.0}));
+}
+
+TEST_CASE("Polygon from GeoJSON") {
+    const MockJson ring = arr({arr({1.0, 1.0}), arr({3.0, 1.0}), arr({3.0, 3.0}), arr({1.0, 3.0}), arr({1.0, 1.0})});
+    const MockJson ring2 = arr({arr({5.0, 5.0}), arr({6.0, 5.0}), arr({6.0, 6.0}), arr({5.0, 5.0})});
+
+    SECTION("Polygon") {
+        const auto polygon = osmium::extract::polygon_from_geojson(obj("Polygon", "coordinates", arr({ring})));
+        REQUIRE(polygon.num_segments() == 4);
+        REQUIRE(polygon.contains(osmium::Location{2.0, 2.0}));
+        REQUIRE_FALSE(polygon.contains(osmium::Location{4.0, 2.0}));
+    }
+
+    SECTION("MultiPolygon in Feature") {
+        const MockJson geometry = obj("MultiPolygon", "coordinates", arr({arr({ring}), arr({ring2})}));
+        const auto polygon = osmium::extract::polygon_from_geojson(obj("Feature", "geometry", geometry));
+        REQUIRE(polygon.num_segments() == 7);
+        REQUIRE(polygon.contains(osmium::Location{2.0, 2.0}));
+        REQUIRE(polygon.contains(osmium::Location{5.9, 5.5}));
+        REQUIRE_FALSE(polygon.contains(osmium::Location{4.0, 4.0}));
+    }
+
+    SECTION("Wrong geometry type") {
+        REQUIRE_THROWS_AS(osmium::extract::polygon_from_geojson(obj("Point", "coordinates", arr({1.0, 2.0}))), osmium::geometry_error);
+    }
+
+    SECTION("Invalid coordinates") {
+        const MockJson coordinates = arr({arr({arr({1.0, 1.0}), arr({"x", 1.0})})});
+        REQUIRE_THROWS_AS(osmium::extract::polygon_from_geojson(obj("Polygon", "coordinates", coordinates)), osmium::geometry_error);
+    }
+}
@@ -145,3 +145,22 @@ TEST_CASE("GeoJSON area geometry") {
 
 }
 
+TEST_CASE("GeoJSON geometries appended to string") {
+    std::string out;
+    osmium::geom::GeoJSONAppendFactory<> factory{out};
+    osmium::memory::Buffer wnl_buffer{1000};
+    osmium::memory::Buffer area_buffer{1000};
+
+    const auto& wnl = create_test_wnl_okay(wnl_buffer);
+    const osmium::Area& area = create_test_area_1outer_0inner(area_buffer);
+
+    factory.create_point(osmium::Location{3.2, 4.2});
+    out += '\n';
+    factory.create_linestring(wnl);
+    out += '\n';
+    factory.create_multipolygon(area);
+
+    REQUIRE(out == "{\"type\":\"Point\",\"coordinates\":[3.2,4.2]}\n"
+                   "{\"type\":\"LineString\",\"coordinates\":[[3.2,4.2],[3.5,4.7],[3.6,4.9]]}\n"
+                   "{\"type\":\"MultiPolygon\",\"coordinates\":[[[[3.2,4.2],[3.5,4.7],[3.6,4.9],[3.2,4.2]]]]}");
+}
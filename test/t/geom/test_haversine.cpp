@@ -0,0 +1,123 @@
+#include "catch.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/geom/equirectangular.hpp>
+#include <osmium/geom/haversine.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/way.hpp>
+
+#include "wnl_helper.hpp"
+
+namespace {
+
+    // Create a way node list with a zig-zag line over a large part of the
+    // world with segments of different lengths, some crossing the
+    // antimeridian, and enough nodes to need several chunks.
+    const osmium::WayNodeList& create_test_wnl_long(osmium::memory::Buffer& buffer) {
+        {
+            osmium::builder::WayNodeListBuilder wnl_builder{buffer};
+            for (int i = 0; i < 1000; ++i) {
+                const double lon = std::fmod(i * 1.37, 360.0) - 180.0;
+                const double lat = (i % 2 ? 1.0 : -1.0) * (i % 89) + (i % 7) * 0.0001;
+                wnl_builder.add_node_ref(osmium::NodeRef{i, osmium::Location{lon, lat}});
+            }
+            wnl_builder.add_node_ref(osmium::NodeRef{2000, osmium::Location{179.9995, 10.0}});
+            wnl_builder.add_node_ref(osmium::NodeRef{2001, osmium::Location{-179.9995, 10.0}});
+            wnl_builder.add_node_ref(osmium::NodeRef{2002, osmium::Location{-179.9995, 10.0001}});
+        }
+
+        return buffer.get<osmium::WayNodeList>(buffer.commit());
+    }
+
+    double scalar_length(const osmium::WayNodeList& wnl) {
+        double sum = 0.0;
+        for (auto it = wnl.begin(); std::next(it) != wnl.end(); ++it) {
+            sum += osmium::geom::haversine::distance(it->location(), std::next(it)->location());
+        }
+        return sum;
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Haversine distance between two points") {
+    const osmium::geom::Coordinates c1{3.2, 4.2};
+    const osmium::geom::Coordinates c2{3.5, 4.7};
+
+    REQUIRE(osmium::geom::haversine::distance(c1, c1) == 0.0);
+    REQUIRE(osmium::geom::haversine::distance(c1, c2) == Approx(64803.77).epsilon(0.000001));
+}
+
+TEST_CASE("Haversine length of way") {
+    osmium::memory::Buffer buffer{100000};
+
+    SECTION("short way") {
+        const auto& wnl = create_test_wnl_okay(buffer);
+        REQUIRE(osmium::geom::haversine::distance(wnl) == Approx(scalar_length(wnl)).epsilon(1e-10));
+    }
+
+    SECTION("empty way") {
+        const auto& wnl = create_test_wnl_empty(buffer);
+        REQUIRE(osmium::geom::haversine::distance(wnl) == 0.0);
+        REQUIRE(osmium::geom::equirectangular::distance(wnl) == 0.0);
+    }
+
+    SECTION("way with undefined location") {
+        const auto& wnl = create_test_wnl_undefined_location(buffer);
+        REQUIRE_THROWS_AS(osmium::geom::haversine::distance(wnl), osmium::invalid_location);
+        REQUIRE_THROWS_AS(osmium::geom::equirectangular::distance(wnl), osmium::invalid_location);
+    }
+
+    SECTION("long way with long segments") {
+        const auto& wnl = create_test_wnl_long(buffer);
+        REQUIRE(osmium::geom::haversine::distance(wnl) == Approx(scalar_length(wnl)).epsilon(1e-10));
+    }
+
+    SECTION("lengths of all segments") {
+        const auto& wnl = create_test_wnl_long(buffer);
+        std::vector<double> lengths(wnl.size() - 1);
+        osmium::geom::haversine::distances(wnl, lengths.data());
+
+        for (std::size_t i = 0; i < lengths.size(); ++i) {
+            const double expected = osmium::geom::haversine::distance(wnl[i].location(), wnl[i + 1].location());
+            REQUIRE(std::abs(lengths[i] - expected) <= expected * 1e-10 + 1e-8);
+        }
+    }
+}
+
+TEST_CASE("Equirectangular approximation") {
+    osmium::memory::Buffer buffer{100000};
+
+    SECTION("short segments are close to haversine") {
+        for (int i = -80; i <= 80; ++i) {
+            const osmium::geom::Coordinates c1{i * 2.0, static_cast<double>(i)};
+            const osmium::geom::Coordinates c2{i * 2.0 + 0.005, i + 0.007};
+            const double expected = osmium::geom::haversine::distance(c1, c2);
+            REQUIRE(std::abs(osmium::geom::equirectangular::distance(c1, c2) - expected) <= expected * 1e-8);
+        }
+    }
+
+    SECTION("segment crossing the antimeridian") {
+        const osmium::geom::Coordinates c1{179.9995, 10.0};
+        const osmium::geom::Coordinates c2{-179.9995, 10.0};
+        const double expected = osmium::geom::haversine::distance(c1, c2);
+        REQUIRE(expected < 200.0);
+        REQUIRE(std::abs(osmium::geom::equirectangular::distance(c1, c2) - expected) <= expected * 1e-8);
+    }
+
+    SECTION("batch version is the same as the scalar version") {
+        const auto& wnl = create_test_wnl_long(buffer);
+        std::vector<double> lengths(wnl.size() - 1);
+        osmium::geom::equirectangular::distances(wnl, lengths.data());
+
+        double sum = 0.0;
+        for (std::size_t i = 0; i < lengths.size(); ++i) {
+            const double expected = osmium::geom::equirectangular::distance(wnl[i].location(), wnl[i + 1].location());
+            REQUIRE(std::abs(lengths[i] - expected) <= expected * 1e-10 + 1e-8);
+            sum += lengths[i];
+        }
+        REQUIRE(osmium::geom::equirectangular::distance(wnl) == Approx(sum).epsilon(1e-10));
+    }
+}
@@ -1,5 +1,9 @@
 #include "catch.hpp"
 
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
 #include <osmium/geom/mercator_projection.hpp>
 
 TEST_CASE("Mercator") {
@@ -35,3 +39,61 @@ TEST_CASE("Mercator") {
     }
 
 }
+
+TEST_CASE("Mercator batch projection") {
+
+    SECTION("approximation is within 0.02mm of exact formula") {
+        for (int32_t y = -850511288; y <= 850511288; y += 9973) {
+            const double lat = osmium::Location{0, y}.lat();
+            REQUIRE(std::abs(osmium::geom::detail::lat_to_y_approx(lat) - osmium::geom::detail::lat_to_y(lat)) < 0.00002);
+        }
+        REQUIRE(osmium::geom::detail::lat_to_y_approx(0.0) == 0.0);
+    }
+
+    SECTION("batch projection of locations") {
+        std::vector<osmium::Location> locations;
+        for (int i = -170; i <= 170; ++i) {
+            locations.emplace_back(static_cast<double>(i), i / 2.0);
+        }
+        locations.emplace_back();
+        locations.emplace_back(1.0, 89.0);
+
+        std::vector<osmium::geom::Coordinates> coordinates(locations.size(), osmium::geom::Coordinates{1.0, 2.0});
+        osmium::geom::lonlat_to_mercator(locations.data(), locations.data() + locations.size(), coordinates.data());
+
+        for (size_t i = 0; i < locations.size(); ++i) {
+            if (locations[i].valid()) {
+                const osmium::geom::Coordinates c = osmium::geom::lonlat_to_mercator(locations[i]);
+                REQUIRE(coordinates[i].x == c.x);
+                REQUIRE(std::abs(coordinates[i].y - c.y) < 0.00002);
+            } else {
+                REQUIRE(coordinates[i].x == 1.0);
+                REQUIRE(coordinates[i].y == 2.0);
+            }
+        }
+
+        // outside range of projection the exact formula is used
+        REQUIRE(coordinates.back().y == osmium::geom::detail::lat_to_y(89.0));
+    }
+
+}
+
+TEST_CASE("FastMercatorProjection") {
+    const osmium::geom::MercatorProjection exact;
+    const osmium::geom::FastMercatorProjection fast;
+    REQUIRE(fast.epsg() == 3857);
+
+    for (const double lat : {-89.0, -85.0, -45.3, 0.0, 12.5, 60.0, 85.05, 89.9}) {
+        const osmium::Location location{13.4, lat};
+        const auto c = fast(location);
+        REQUIRE(c.x == exact(location).x);
+        REQUIRE(c.y == Approx(exact(location).y).epsilon(0.0000001));
+
+        osmium::geom::Coordinates batch{0.0, 0.0};
+        osmium::geom::lonlat_to_mercator(&location, &location + 1, &batch);
+        REQUIRE(c.x == batch.x);
+        REQUIRE(c.y == batch.y);
+    }
+
+    REQUIRE_THROWS_AS(fast(osmium::Location{}), osmium::invalid_location);
+}
@@ -1,8 +1,15 @@
 #include "catch.hpp"
 
+#include <algorithm>
+#include <set>
 #include <sstream>
+#include <vector>
 
+#include <osmium/builder/attr.hpp>
 #include <osmium/geom/tile.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/area.hpp>
+#include <osmium/osm/way.hpp>
 
 #include "test_tile_data.hpp"
 
@@ -99,3 +106,175 @@ TEST_CASE("Check a random list of tiles") {
     }
 }
 
+
+namespace {
+
+    // Reference implementation: sample many points along each segment
+    // in Mercator coordinates and collect the tiles they are in.
+    std::set<osmium::geom::Tile> sampled_tiles(const osmium::Way& way, uint32_t zoom) {
+        using osmium::geom::detail::max_coordinate_epsg3857;
+        const double n = static_cast<double>(1u << zoom);
+        const double scale = max_coordinate_epsg3857 * 2 / n;
+
+        std::set<osmium::geom::Tile> tiles;
+        const auto& nodes = way.nodes();
+        for (auto it = nodes.cbegin(); std::next(it) != nodes.cend(); ++it) {
+            const auto c0 = osmium::geom::lonlat_to_mercator(it->location());
+            const auto c1 = osmium::geom::lonlat_to_mercator(std::next(it)->location());
+            const int samples = 100000;
+            for (int i = 0; i <= samples; ++i) {
+                const double f = static_cast<double>(i) / samples;
+                const double x = (c0.x + f * (c1.x - c0.x) + max_coordinate_epsg3857) / scale;
+                const double y = (max_coordinate_epsg3857 - (c0.y + f * (c1.y - c0.y))) / scale;
+                tiles.emplace(zoom, uint32_t(std::min(x, n - 1)), uint32_t(std::min(y, n - 1)));
+            }
+        }
+        return tiles;
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Tiles for way with single node") {
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer{1024};
+    const auto& way = buffer.get<osmium::Way>(osmium::builder::add_way(buffer, _nodes({{1, {8.1, 50.3}}})));
+
+    std::vector<osmium::geom::Tile> tiles;
+    osmium::geom::tiles_for(way, 12, tiles);
+    REQUIRE(tiles.size() == 1);
+    REQUIRE(tiles.front() == osmium::geom::Tile(12, osmium::Location{8.1, 50.3}));
+}
+
+TEST_CASE("Tiles for way along a tile row") {
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer{1024};
+    const auto& way = buffer.get<osmium::Way>(osmium::builder::add_way(buffer, _nodes({
+        {1, {-170.0, 0.1}},
+        {2, { 170.0, 0.1}}
+    })));
+
+    std::vector<osmium::geom::Tile> tiles;
+    osmium::geom::tiles_for(way, 4, tiles);
+    REQUIRE(tiles.size() == 16);
+    for (uint32_t x = 0; x < 16; ++x) {
+        REQUIRE(tiles[x] == osmium::geom::Tile(4, x, 7));
+    }
+}
+
+TEST_CASE("Tiles for way include tiles crossed between nodes") {
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer{1024};
+    const auto& way = buffer.get<osmium::Way>(osmium::builder::add_way(buffer, _nodes({
+        {1, {  7.31,  47.2}},
+        {2, { 13.77,  52.9}},
+        {3, { 11.02,  48.1}},
+        {4, {-20.5,   -3.3}},
+        {5, { 30.0,   10.0}}
+    })));
+
+    std::vector<osmium::geom::Tile> tiles;
+    for (uint32_t zoom : {0u, 3u, 7u, 10u}) {
+        osmium::geom::tiles_for(way, zoom, tiles);
+        REQUIRE(std::is_sorted(tiles.cbegin(), tiles.cend()));
+        REQUIRE(std::adjacent_find(tiles.cbegin(), tiles.cend()) == tiles.cend());
+
+        const auto expected = sampled_tiles(way, zoom);
+        REQUIRE(std::includes(tiles.cbegin(), tiles.cend(), expected.cbegin(), expected.cend()));
+        REQUIRE(tiles.size() <= expected.size() + 2);
+    }
+}
+
+TEST_CASE("Tiles for way with invalid location") {
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer{1024};
+    const auto& way = buffer.get<osmium::Way>(osmium::builder::add_way(buffer, _nodes({
+        {1, {1.0, 1.0}},
+        {2, osmium::Location{}}
+    })));
+
+    std::vector<osmium::geom::Tile> tiles;
+    REQUIRE_THROWS_AS(osmium::geom::tiles_for(way, 10, tiles), osmium::invalid_location);
+}
+
+TEST_CASE("Tiles for area") {
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer{1024};
+
+    SECTION("square") {
+        const auto& area = buffer.get<osmium::Area>(osmium::builder::add_area(buffer,
+            _outer_ring({
+                {1, {0.1, 0.1}},
+                {2, {9.9, 0.1}},
+                {3, {9.9, 9.9}},
+                {4, {0.1, 9.9}},
+                {1, {0.1, 0.1}}
+            })
+        ));
+
+        const osmium::geom::Tile top_left{8, osmium::Location{0.1, 9.9}};
+        const osmium::geom::Tile bottom_right{8, osmium::Location{9.9, 0.1}};
+
+        std::vector<osmium::geom::Tile> expected;
+        for (uint32_t x = top_left.x; x <= bottom_right.x; ++x) {
+            for (uint32_t y = top_left.y; y <= bottom_right.y; ++y) {
+                expected.emplace_back(8, x, y);
+            }
+        }
+
+        std::vector<osmium::geom::Tile> tiles;
+        osmium::geom::tiles_for(area, 8, tiles);
+        REQUIRE(tiles == expected);
+
+        // re-using the vectors gives the same result without allocating
+        osmium::geom::tile_crossings_type crossings;
+        osmium::geom::tiles_for(area, 8, tiles, crossings);
+        REQUIRE(tiles == expected);
+        const auto* tiles_data = tiles.data();
+        const auto* crossings_data = crossings.data();
+        osmium::geom::tiles_for(area, 8, tiles, crossings);
+        REQUIRE(tiles == expected);
+        REQUIRE(tiles.data() == tiles_data);
+        REQUIRE(crossings.data() == crossings_data);
+    }
+
+    SECTION("triangle with hole") {
+        const auto& area = buffer.get<osmium::Area>(osmium::builder::add_area(buffer,
+            _outer_ring({
+                {1, {-10.0, -10.0}},
+                {2, { 10.0, -10.0}},
+                {3, {  0.0,  10.0}},
+                {1, {-10.0, -10.0}}
+            }),
+            _inner_ring({
+                {4, {-4.0, -6.0}},
+                {5, { 0.0,  2.0}},
+                {6, { 4.0, -6.0}},
+                {4, {-4.0, -6.0}}
+            })
+        ));
+
+        std::vector<osmium::geom::Tile> tiles;
+        osmium::geom::tiles_for(area, 8, tiles);
+
+        const auto contains = [&tiles](const osmium::Location& location) {
+            return std::binary_search(tiles.cbegin(), tiles.cend(), osmium::geom::Tile{8, location});
+        };
+
+        // boundary of outer and inner ring
+        REQUIRE(contains(osmium::Location{-10.0, -10.0}));
+        REQUIRE(contains(osmium::Location{5.0, 0.0}));
+        REQUIRE(contains(osmium::Location{0.0, 2.0}));
+        REQUIRE(contains(osmium::Location{2.0, -2.0}));
+
+        // inside outer ring
+        REQUIRE(contains(osmium::Location{-6.0, -8.0}));
+        REQUIRE(contains(osmium::Location{0.0, 6.0}));
+
+        // inside inner ring
+        REQUIRE_FALSE(contains(osmium::Location{0.0, -3.0}));
+
+        // outside
+        REQUIRE_FALSE(contains(osmium::Location{-8.0, 5.0}));
+        REQUIRE_FALSE(contains(osmium::Location{0.0, -12.0}));
+    }
+}
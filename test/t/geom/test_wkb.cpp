@@ -111,10 +111,47 @@ TEST_CASE("WKB geometry factory (byte-order-dependant)") {
         REQUIRE_THROWS_AS(factory.create_linestring(wnl), osmium::invalid_location);
     }
 
+    SECTION("geometries appended to string") {
+        std::string out;
+        osmium::geom::WKBAppendFactory<> factory{out, osmium::geom::wkb_type::wkb, osmium::geom::out_type::hex};
+
+        const auto& wnl = create_test_wnl_okay(buffer);
+
+        factory.create_point(osmium::Location{3.2, 4.2});
+        factory.create_linestring(wnl);
+
+        const std::string expected{"01010000009A99999999990940CDCCCCCCCCCC1040"
+                                   "0102000000030000009A99999999990940CDCCCCCCCCCC10400000000000000C40CDCCCCCCCCCC1240CDCCCCCCCCCC0C409A99999999991340"};
+        REQUIRE(out == expected);
+
+        const auto* data = out.data();
+        out.clear();
+
+        factory.create_point(osmium::Location{3.2, 4.2});
+        factory.create_linestring(wnl);
+        REQUIRE(out == expected);
+        REQUIRE(out.data() == data);
+    }
+
+    SECTION("binary geometries appended to string") {
+        std::string out;
+        osmium::geom::WKBAppendFactory<> factory{out, osmium::geom::wkb_type::ewkb, osmium::geom::out_type::binary};
+
+        const auto& wnl = create_test_wnl_okay(buffer);
+
+        factory.create_linestring(wnl);
+        REQUIRE(osmium::geom::detail::convert_to_hex(out) == "0102000020E6100000030000009A99999999990940CDCCCCCCCCCC10400000000000000C40CDCCCCCCCCCC1240CDCCCCCCCCCC0C409A99999999991340");
+    }
+
 }
 
 #endif
 
+TEST_CASE("Convert to hex") {
+    REQUIRE(osmium::geom::detail::convert_to_hex(std::string{}).empty());
+    REQUIRE(osmium::geom::detail::convert_to_hex(std::string{"\x00\x01\x7f\x80\xab\xff", 6}) == "00017F80ABFF");
+}
+
 TEST_CASE("WKB geometry (byte-order-independent)") {
 
     osmium::geom::WKBFactory<> factory{osmium::geom::wkb_type::wkb, osmium::geom::out_type::hex};
@@ -1,5 +1,8 @@
 #include "catch.hpp"
 
+#include <random>
+#include <string>
+
 #include <osmium/geom/mercator_projection.hpp>
 #include <osmium/geom/wkt.hpp>
 
@@ -131,3 +134,127 @@ TEST_CASE("WKT geometry factory") {
 
 }
 
+
+namespace {
+
+    // Same as FastMercatorProjection, but projects one location at a time.
+    class ScalarFastMercatorProjection {
+
+        osmium::geom::FastMercatorProjection m_projection;
+
+    public:
+
+        osmium::geom::Coordinates operator()(osmium::Location location) const {
+            return m_projection(location);
+        }
+
+        int epsg() const noexcept {
+            return m_projection.epsg();
+        }
+
+        std::string proj_string() const {
+            return m_projection.proj_string();
+        }
+
+    }; // class ScalarFastMercatorProjection
+
+    // Check that the vertices of linestrings are the same as the points
+    // created for the same locations.
+    template <typename TProjection>
+    void check_points_match_vertices() {
+        osmium::geom::WKTFactory<TProjection> factory;
+        osmium::memory::Buffer buffer{1024 * 1024};
+
+        std::mt19937 gen{17};
+        std::uniform_real_distribution<double> lon{-180.0, 180.0};
+        std::uniform_real_distribution<double> lat{-85.0, 85.0};
+
+        for (int n = 0; n < 2000; ++n) {
+            const osmium::Location l1{lon(gen), lat(gen)};
+            const osmium::Location l2{lon(gen), lat(gen)};
+            const auto pos = osmium::builder::add_way_node_list(buffer, _nodes({{1, l1}, {2, l2}}));
+            const auto& wnl = buffer.get<osmium::WayNodeList>(pos);
+
+            const std::string p1{factory.create_point(l1)};
+            const std::string p2{factory.create_point(l2)};
+            const std::string expected = "LINESTRING(" + p1.substr(6, p1.size() - 7) + "," + p2.substr(6, p2.size() - 7) + ")";
+            REQUIRE(factory.create_linestring(wnl, osmium::geom::use_nodes::all) == expected);
+        }
+    }
+
+} // anonymous namespace
+
+TEST_CASE("WKT geometry factory in web mercator: points match vertices") {
+    check_points_match_vertices<osmium::geom::MercatorProjection>();
+}
+
+TEST_CASE("WKT geometry factory with fast web mercator: points match vertices") {
+    check_points_match_vertices<osmium::geom::FastMercatorProjection>();
+}
+
+TEST_CASE("WKT geometry factory with fast web mercator projecting whole node lists") {
+    osmium::geom::WKTFactory<osmium::geom::FastMercatorProjection> factory;
+    osmium::geom::WKTFactory<ScalarFastMercatorProjection> scalar_factory;
+
+    osmium::memory::Buffer buffer{10000};
+
+    SECTION("linestring") {
+        const auto& wnl = create_test_wnl_okay(buffer);
+
+        REQUIRE(factory.create_linestring(wnl) == scalar_factory.create_linestring(wnl));
+        REQUIRE(factory.create_linestring(wnl, osmium::geom::use_nodes::unique, osmium::geom::direction::backward) ==
+                scalar_factory.create_linestring(wnl, osmium::geom::use_nodes::unique, osmium::geom::direction::backward));
+        REQUIRE(factory.create_linestring(wnl, osmium::geom::use_nodes::all) ==
+                scalar_factory.create_linestring(wnl, osmium::geom::use_nodes::all));
+        REQUIRE(factory.create_linestring(wnl, osmium::geom::use_nodes::all, osmium::geom::direction::backward) ==
+                scalar_factory.create_linestring(wnl, osmium::geom::use_nodes::all, osmium::geom::direction::backward));
+    }
+
+    SECTION("linestring with undefined location") {
+        const auto& wnl = create_test_wnl_undefined_location(buffer);
+
+        REQUIRE_THROWS_AS(factory.create_linestring(wnl), osmium::invalid_location);
+    }
+
+    SECTION("area with two outer and two inner rings") {
+        const osmium::Area& area = create_test_area_2outer_2inner(buffer);
+
+        REQUIRE(factory.create_multipolygon(area) == scalar_factory.create_multipolygon(area));
+    }
+
+}
+
+TEST_CASE("WKT geometry factory appending to string") {
+    std::string out;
+    osmium::geom::WKTAppendFactory<> factory{out};
+
+    osmium::memory::Buffer wnl_buffer{1000};
+    osmium::memory::Buffer area_buffer{1000};
+    const auto& wnl = create_test_wnl_okay(wnl_buffer);
+    const osmium::Area& area = create_test_area_1outer_0inner(area_buffer);
+
+    factory.create_point(osmium::Location{3.2, 4.2});
+    factory.create_linestring(wnl);
+    factory.create_multipolygon(area);
+
+    const std::string expected{"POINT(3.2 4.2)LINESTRING(3.2 4.2,3.5 4.7,3.6 4.9)MULTIPOLYGON(((3.2 4.2,3.5 4.7,3.6 4.9,3.2 4.2)))"};
+    REQUIRE(out == expected);
+
+    const auto* data = out.data();
+    out.clear();
+
+    factory.create_point(osmium::Location{3.2, 4.2});
+    factory.create_linestring(wnl);
+    factory.create_multipolygon(area);
+
+    REQUIRE(out == expected);
+    REQUIRE(out.data() == data);
+}
+
+TEST_CASE("WKT geometry factory appending to string in ewkt") {
+    std::string out{"x"};
+    osmium::geom::WKTAppendFactory<> factory{out, 7, osmium::geom::wkt_type::ewkt};
+
+    factory.create_point(osmium::Location{3.2, 4.2});
+    REQUIRE(out == "xSRID=4326;POINT(3.2 4.2)");
+}
@@ -0,0 +1,146 @@
+#include "catch.hpp"
+
+#include <string>
+#include <vector>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/handler.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm.hpp>
+#include <osmium/visitor.hpp>
+
+using namespace osmium::builder::attr;
+
+namespace {
+
+    struct NodeHandler : public osmium::handler::Handler {
+
+        std::vector<osmium::object_id_type> ids;
+        int flushed = 0;
+
+        void node(const osmium::Node& node) {
+            ids.push_back(node.id());
+        }
+
+        void flush() {
+            ++flushed;
+        }
+
+    }; // struct NodeHandler
+
+    struct ObjectHandler : public osmium::handler::Handler {
+
+        std::string calls;
+
+        void osm_object(const osmium::OSMObject& object) {
+            calls += osmium::item_type_to_char(object.type());
+        }
+
+        void way(const osmium::Way&) {
+            calls += 'W';
+        }
+
+    }; // struct ObjectHandler
+
+    struct DerivedHandler : public NodeHandler {
+
+        int relations = 0;
+
+        void relation(const osmium::Relation&) {
+            ++relations;
+        }
+
+    }; // struct DerivedHandler
+
+    struct OverloadedHandler : public osmium::handler::Handler {
+
+        int nodes = 0;
+
+        void node(const osmium::Node&) {
+            ++nodes;
+        }
+
+        void node(osmium::Node&) {
+            ++nodes;
+        }
+
+    }; // struct OverloadedHandler
+
+    // Doesn't derive from osmium::handler::Handler.
+    struct FullHandler {
+
+        int count = 0;
+
+        void osm_object(const osmium::OSMObject&) { ++count; }
+        void node(const osmium::Node&) { ++count; }
+        void way(const osmium::Way&) { ++count; }
+        void relation(const osmium::Relation&) { ++count; }
+        void area(const osmium::Area&) { ++count; }
+        void changeset(const osmium::Changeset&) { ++count; }
+        void flush() {}
+
+    }; // struct FullHandler
+
+    osmium::memory::Buffer create_buffer() {
+        osmium::memory::Buffer buffer{10240};
+        osmium::builder::add_node(buffer, _id(1));
+        osmium::builder::add_node(buffer, _id(2));
+        osmium::builder::add_way(buffer, _id(10));
+        osmium::builder::add_relation(buffer, _id(20));
+        osmium::builder::add_changeset(buffer, _cid(30));
+        return buffer;
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Entities handlers are interested in are detected at compile time") {
+    static_assert(osmium::detail::handler_entities<osmium::handler::Handler>() == osmium::osm_entity_bits::nothing, "base handler");
+    static_assert(osmium::detail::handler_entities<NodeHandler>() == osmium::osm_entity_bits::node, "node handler");
+    static_assert(osmium::detail::handler_entities<NodeHandler&>() == osmium::osm_entity_bits::node, "reference to node handler");
+    static_assert(osmium::detail::handler_entities<const NodeHandler&>() == osmium::osm_entity_bits::node, "const reference to node handler");
+    static_assert(osmium::detail::handler_entities<ObjectHandler>() == osmium::osm_entity_bits::object, "object handler");
+    static_assert(osmium::detail::handler_entities<DerivedHandler>() == (osmium::osm_entity_bits::node | osmium::osm_entity_bits::relation), "derived handler");
+    static_assert(osmium::detail::handler_entities<OverloadedHandler>() == osmium::osm_entity_bits::node, "overloaded handler");
+    static_assert(osmium::detail::handler_entities<FullHandler>() == osmium::osm_entity_bits::all, "handler not derived from Handler");
+    static_assert(osmium::detail::handlers_entities<NodeHandler, DerivedHandler>() == (osmium::osm_entity_bits::node | osmium::osm_entity_bits::relation), "several handlers");
+    static_assert(osmium::detail::handlers_entities<>() == osmium::osm_entity_bits::nothing, "no handlers");
+
+    REQUIRE(osmium::detail::dispatch_item(osmium::item_type::node, osmium::osm_entity_bits::node));
+    REQUIRE_FALSE(osmium::detail::dispatch_item(osmium::item_type::way, osmium::osm_entity_bits::node));
+    REQUIRE(osmium::detail::dispatch_item(osmium::item_type::changeset, osmium::osm_entity_bits::changeset));
+    REQUIRE_FALSE(osmium::detail::dispatch_item(osmium::item_type::changeset, osmium::osm_entity_bits::object));
+    REQUIRE(osmium::detail::dispatch_item(osmium::item_type::tag_list, osmium::osm_entity_bits::nothing));
+}
+
+TEST_CASE("Apply handlers only interested in some entities") {
+    const auto buffer = create_buffer();
+
+    NodeHandler node_handler;
+    ObjectHandler object_handler;
+    DerivedHandler derived_handler;
+    OverloadedHandler overloaded_handler;
+    FullHandler full_handler;
+    osmium::handler::Handler base_handler;
+
+    osmium::apply(buffer, node_handler, object_handler, derived_handler, overloaded_handler, full_handler, base_handler);
+
+    REQUIRE(node_handler.ids == (std::vector<osmium::object_id_type>{1, 2}));
+    REQUIRE(node_handler.flushed == 1);
+    REQUIRE(object_handler.calls == "nnwWr");
+    REQUIRE(derived_handler.ids == (std::vector<osmium::object_id_type>{1, 2}));
+    REQUIRE(derived_handler.relations == 1);
+    REQUIRE(derived_handler.flushed == 1);
+    REQUIRE(overloaded_handler.nodes == 2);
+    REQUIRE(full_handler.count == 9);
+}
+
+TEST_CASE("Apply handler to single items") {
+    const auto buffer = create_buffer();
+
+    NodeHandler node_handler;
+    for (const auto& item : buffer) {
+        osmium::apply_item(item, node_handler);
+    }
+    REQUIRE(node_handler.ids == (std::vector<osmium::object_id_type>{1, 2}));
+    REQUIRE(node_handler.flushed == 0);
+}
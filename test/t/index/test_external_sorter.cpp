@@ -0,0 +1,172 @@
+#include "catch.hpp"
+
+#include <vector>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/external_sorter.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/node.hpp>
+#include <osmium/osm/object_comparisons.hpp>
+#include <osmium/osm/way.hpp>
+#include <osmium/visitor.hpp>
+
+using namespace osmium::builder::attr;
+
+namespace {
+
+    osmium::memory::Buffer create_unsorted_data() {
+        osmium::memory::Buffer buffer{1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+
+        for (osmium::object_id_type id = 1; id <= 1000; ++id) {
+            const osmium::object_id_type way_id = (id * 7919) % 1000 + 1;
+            osmium::builder::add_way(buffer,
+                _id(way_id),
+                _version(1),
+                _tag("highway", "residential"),
+                _nodes({1, 2, 3})
+            );
+            const osmium::object_id_type node_id = (id * 104729) % 1000 + 1;
+            osmium::builder::add_node(buffer,
+                _id(node_id),
+                _version(2),
+                _location(1.0, 2.0)
+            );
+            osmium::builder::add_node(buffer,
+                _id(node_id),
+                _version(1),
+                _location(1.0, 2.0)
+            );
+        }
+
+        return buffer;
+    }
+
+    template <typename TSorter>
+    std::vector<const osmium::OSMObject*> read_all(TSorter& sorter, std::vector<osmium::memory::Buffer>& buffers) {
+        std::vector<const osmium::OSMObject*> objects;
+        while (osmium::memory::Buffer buffer = sorter.read()) {
+            buffers.push_back(std::move(buffer));
+            for (const auto& object : buffers.back().select<osmium::OSMObject>()) {
+                objects.push_back(&object);
+            }
+        }
+        return objects;
+    }
+
+    void check_sorted(const std::vector<const osmium::OSMObject*>& objects) {
+        REQUIRE(objects.size() == 3000);
+        for (size_t n = 0; n < 2000; ++n) {
+            REQUIRE(objects[n]->type() == osmium::item_type::node);
+            REQUIRE(objects[n]->id() == static_cast<osmium::object_id_type>(n / 2 + 1));
+            REQUIRE(objects[n]->version() == static_cast<osmium::object_version_type>(n % 2 + 1));
+        }
+        for (size_t n = 2000; n < 3000; ++n) {
+            REQUIRE(objects[n]->type() == osmium::item_type::way);
+            REQUIRE(objects[n]->id() == static_cast<osmium::object_id_type>(n - 1999));
+            REQUIRE(static_cast<const osmium::Way*>(objects[n])->nodes().size() == 3);
+        }
+    }
+
+} // anonymous namespace
+
+TEST_CASE("ExternalSorter with empty input") {
+    osmium::ExternalSorter<> sorter;
+    REQUIRE_FALSE(sorter.read());
+    REQUIRE(sorter.num_runs() == 0);
+}
+
+TEST_CASE("ExternalSorter sorting in memory") {
+    const auto data = create_unsorted_data();
+
+    osmium::ExternalSorter<> sorter;
+    osmium::apply(data, sorter);
+    REQUIRE(sorter.num_runs() == 0);
+
+    std::vector<osmium::memory::Buffer> buffers;
+    check_sorted(read_all(sorter, buffers));
+    REQUIRE_FALSE(sorter.read());
+}
+
+TEST_CASE("ExternalSorter sorting with temporary files") {
+    const auto data = create_unsorted_data();
+
+    osmium::ExternalSorter<> sorter{10 * 1024};
+    sorter.add(data);
+    REQUIRE(sorter.num_runs() > 5);
+
+    std::vector<osmium::memory::Buffer> buffers;
+    check_sorted(read_all(sorter, buffers));
+    REQUIRE_FALSE(sorter.read());
+}
+
+TEST_CASE("ExternalSorter keeps order of equal objects") {
+    osmium::memory::Buffer data{1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+
+    for (int n = 0; n < 500; ++n) {
+        osmium::builder::add_node(data, _id(2 - n % 2), _version(1), _uid(n));
+    }
+
+    osmium::ExternalSorter<osmium::object_order_type_id_version> sorter{4 * 1024};
+    osmium::apply(data, sorter);
+    REQUIRE(sorter.num_runs() > 1);
+
+    std::vector<osmium::memory::Buffer> buffers;
+    const auto objects = read_all(sorter, buffers);
+    REQUIRE(objects.size() == 500);
+    for (size_t n = 0; n < 250; ++n) {
+        REQUIRE(objects[n]->id() == 1);
+        REQUIRE(objects[n]->uid() == static_cast<osmium::user_id_type>(n * 2 + 1));
+        REQUIRE(objects[n + 250]->id() == 2);
+        REQUIRE(objects[n + 250]->uid() == static_cast<osmium::user_id_type>(n * 2));
+    }
+}
+
+TEST_CASE("ExternalSorter with reverse order") {
+    const auto data = create_unsorted_data();
+
+    osmium::ExternalSorter<osmium::object_order_type_id_reverse_version> sorter{10 * 1024};
+    osmium::apply(data, sorter);
+
+    std::vector<osmium::memory::Buffer> buffers;
+    const auto objects = read_all(sorter, buffers);
+    REQUIRE(objects.size() == 3000);
+    REQUIRE(objects[0]->id() == 1);
+    REQUIRE(objects[0]->version() == 2);
+    REQUIRE(objects[1]->id() == 1);
+    REQUIRE(objects[1]->version() == 1);
+}
+
+TEST_CASE("ExternalSorter with more data than the initial buffer size") {
+    osmium::memory::Buffer data{1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+    const osmium::object_id_type num_nodes = 300000;
+    for (osmium::object_id_type id = num_nodes; id > 0; --id) {
+        osmium::builder::add_node(data, _id(id), _version(1), _location(1.0, 2.0));
+    }
+    REQUIRE(data.committed() > 10 * 1024 * 1024);
+
+    SECTION("default memory limit") {
+        osmium::ExternalSorter<> sorter;
+        sorter.add(data);
+        REQUIRE(sorter.num_runs() == 0);
+
+        std::vector<osmium::memory::Buffer> buffers;
+        const auto objects = read_all(sorter, buffers);
+        REQUIRE(objects.size() == static_cast<size_t>(num_nodes));
+        for (size_t n = 0; n < objects.size(); ++n) {
+            REQUIRE(objects[n]->id() == static_cast<osmium::object_id_type>(n + 1));
+        }
+    }
+
+    SECTION("memory limit larger than initial buffer size") {
+        osmium::ExternalSorter<> sorter{12 * 1024 * 1024};
+        sorter.add(data);
+        REQUIRE(sorter.num_runs() == 1);
+
+        std::vector<osmium::memory::Buffer> buffers;
+        const auto objects = read_all(sorter, buffers);
+        REQUIRE(objects.size() == static_cast<size_t>(num_nodes));
+        for (size_t n = 0; n < objects.size(); ++n) {
+            REQUIRE(objects[n]->id() == static_cast<osmium::object_id_type>(n + 1));
+        }
+    }
+}
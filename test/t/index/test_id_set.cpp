@@ -1,6 +1,10 @@
 
 #include "catch.hpp"
 
+#include <random>
+#include <set>
+#include <vector>
+
 #include <osmium/index/id_set.hpp>
 #include <osmium/osm/types.hpp>
 
@@ -164,3 +168,207 @@ TEST_CASE("Iterating over IdSetSmall") {
     REQUIRE(it == s.end());
 }
 
+
+TEST_CASE("Basic functionality of IdSetCompressed") {
+    osmium::index::IdSetCompressed<osmium::unsigned_object_id_type> s;
+
+    REQUIRE_FALSE(s.get(17));
+    REQUIRE(s.empty());
+    REQUIRE(s.size() == 0);
+    REQUIRE(s.begin() == s.end());
+
+    s.set(17);
+    REQUIRE(s.get(17));
+    REQUIRE_FALSE(s.get(28));
+    REQUIRE(s.size() == 1);
+
+    s.set(28);
+    s.set(17);
+    REQUIRE(s.size() == 2);
+
+    REQUIRE_FALSE(s.check_and_set(17));
+    REQUIRE(s.check_and_set(1ULL << 40));
+    REQUIRE(s.get(1ULL << 40));
+    REQUIRE(s.size() == 3);
+
+    s.unset(17);
+    s.unset(18);
+    s.unset(1ULL << 41);
+    REQUIRE_FALSE(s.get(17));
+    REQUIRE(s.size() == 2);
+
+    s.clear();
+    REQUIRE(s.empty());
+    REQUIRE_FALSE(s.get(28));
+}
+
+TEST_CASE("Iterating over IdSetCompressed") {
+    osmium::index::IdSetCompressed<osmium::unsigned_object_id_type> s;
+    s.set(7);
+    s.set(35);
+    s.set(35);
+    s.set(20);
+    s.set(1ULL << 33);
+    s.set(21);
+    s.set((1ULL << 27) + 13);
+
+    REQUIRE(s.size() == 6);
+
+    const std::vector<osmium::unsigned_object_id_type> ids(s.begin(), s.end());
+    REQUIRE(ids == (std::vector<osmium::unsigned_object_id_type>{7, 20, 21, 35, (1ULL << 27) + 13, 1ULL << 33}));
+}
+
+namespace {
+
+    using id_type = osmium::unsigned_object_id_type;
+
+    void compare(const osmium::index::IdSetCompressed<id_type>& s, const std::set<id_type>& expected) {
+        REQUIRE(s.size() == expected.size());
+        REQUIRE(std::vector<id_type>(s.begin(), s.end()) == std::vector<id_type>(expected.begin(), expected.end()));
+        for (const auto id : expected) {
+            REQUIRE(s.get(id));
+            if (expected.count(id + 1) == 0) {
+                REQUIRE_FALSE(s.get(id + 1));
+            }
+        }
+    }
+
+    // Fill with sparse, dense, and consecutive Ids in different 64k ranges.
+    void fill(osmium::index::IdSetCompressed<id_type>& s, std::set<id_type>& expected, unsigned int seed) {
+        std::mt19937 gen{seed};
+        std::uniform_int_distribution<id_type> sparse{0, 1 << 16};
+        std::uniform_int_distribution<id_type> dense{(1 << 17), (1 << 17) + 20000};
+        for (int i = 0; i < 100; ++i) {
+            const auto id = sparse(gen);
+            s.set(id);
+            expected.insert(id);
+        }
+        for (int i = 0; i < 10000; ++i) {
+            const auto id = dense(gen);
+            s.set(id);
+            expected.insert(id);
+        }
+        const id_type start = (1ULL << 35) + seed * 1000;
+        for (id_type id = start; id < start + 5000; ++id) {
+            s.set(id);
+            expected.insert(id);
+        }
+    }
+
+} // anonymous namespace
+
+TEST_CASE("IdSetCompressed with different container types") {
+    osmium::index::IdSetCompressed<id_type> s;
+    std::set<id_type> expected;
+    fill(s, expected, 1);
+    compare(s, expected);
+
+    SECTION("optimize") {
+        const auto memory = s.used_memory();
+        s.optimize();
+        REQUIRE(s.used_memory() < memory);
+        compare(s, expected);
+
+        // changes after optimize
+        s.set(5);
+        expected.insert(5);
+        s.unset((1ULL << 35) + 1500);
+        expected.erase((1ULL << 35) + 1500);
+        REQUIRE_FALSE(s.check_and_set((1ULL << 35) + 1600));
+        compare(s, expected);
+    }
+
+    SECTION("unset everything") {
+        for (const auto id : expected) {
+            s.unset(id);
+        }
+        REQUIRE(s.empty());
+        REQUIRE(s.begin() == s.end());
+    }
+
+    SECTION("unset most Ids in bitmap container") {
+        for (id_type id = (1 << 17); id < (1 << 17) + 19000; ++id) {
+            s.unset(id);
+            expected.erase(id);
+        }
+        compare(s, expected);
+    }
+}
+
+TEST_CASE("Union and intersection of IdSetCompressed") {
+    osmium::index::IdSetCompressed<id_type> s1;
+    osmium::index::IdSetCompressed<id_type> s2;
+    std::set<id_type> e1;
+    std::set<id_type> e2;
+    fill(s1, e1, 1);
+    fill(s2, e2, 2);
+    s2.set(1ULL << 50);
+    e2.insert(1ULL << 50);
+
+    SECTION("union") {
+        e1.insert(e2.begin(), e2.end());
+        s1 |= s2;
+        compare(s1, e1);
+    }
+
+    SECTION("union with optimized sets") {
+        s1.optimize();
+        s2.optimize();
+        e1.insert(e2.begin(), e2.end());
+        s1 |= s2;
+        compare(s1, e1);
+    }
+
+    SECTION("intersection") {
+        std::set<id_type> expected;
+        for (const auto id : e1) {
+            if (e2.count(id)) {
+                expected.insert(id);
+            }
+        }
+        s1 &= s2;
+        compare(s1, expected);
+    }
+
+    SECTION("intersection with optimized sets") {
+        std::set<id_type> expected;
+        for (const auto id : e1) {
+            if (e2.count(id)) {
+                expected.insert(id);
+            }
+        }
+        s1.optimize();
+        s2.optimize();
+        s1 &= s2;
+        compare(s1, expected);
+    }
+
+    SECTION("union with itself") {
+        s1 |= s1;
+        compare(s1, e1);
+        s1.optimize();
+        s1 |= s1;
+        compare(s1, e1);
+    }
+
+    SECTION("intersection with itself") {
+        s1 &= s1;
+        compare(s1, e1);
+        s1.optimize();
+        s1 &= s1;
+        compare(s1, e1);
+    }
+
+    SECTION("intersection with empty set") {
+        s1 &= osmium::index::IdSetCompressed<id_type>{};
+        REQUIRE(s1.empty());
+        REQUIRE(s1.begin() == s1.end());
+    }
+}
+
+TEST_CASE("IdSetCompressed can be used in NWRIdSet") {
+    osmium::index::NWRIdSet<osmium::index::IdSetCompressed> s;
+    s(osmium::item_type::way).set(17);
+    REQUIRE(s(osmium::item_type::way).get(17));
+    REQUIRE_FALSE(s(osmium::item_type::node).get(17));
+}
@@ -0,0 +1,109 @@
+#include "catch.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <osmium/index/id_set.hpp>
+#include <osmium/osm/types.hpp>
+
+using id_type = osmium::unsigned_object_id_type;
+
+TEST_CASE("Basic functionality of IdSetDenseConcurrent") {
+    osmium::index::IdSetDenseConcurrent<id_type> s{1000000000};
+
+    REQUIRE_FALSE(s.get(17));
+    REQUIRE(s.empty());
+    REQUIRE(s.size() == 0);
+    REQUIRE(s.begin() == s.end());
+
+    s.set(17);
+    REQUIRE(s.get(17));
+    REQUIRE_FALSE(s.get(28));
+    REQUIRE(s.size() == 1);
+
+    REQUIRE_FALSE(s.check_and_set(17));
+    REQUIRE(s.check_and_set(999999999));
+    REQUIRE(s.size() == 2);
+
+    s.unset(17);
+    s.unset(18);
+    REQUIRE_FALSE(s.get(17));
+    REQUIRE(s.size() == 1);
+
+    REQUIRE_FALSE(s.get(1ULL << 40));
+    REQUIRE_THROWS_AS(s.set(1ULL << 40), std::out_of_range);
+
+    s.clear();
+    REQUIRE(s.empty());
+    REQUIRE_FALSE(s.get(999999999));
+}
+
+TEST_CASE("Iterating over IdSetDenseConcurrent") {
+    osmium::index::IdSetDenseConcurrent<id_type> s;
+    s.set(7);
+    s.set(35);
+    s.set(35);
+    s.set(20);
+    s.set(1ULL << 33);
+    s.set(21);
+    s.set((1ULL << 27) + 13);
+    s.set(63);
+    s.set(64);
+
+    REQUIRE(s.size() == 8);
+
+    const std::vector<id_type> ids(s.begin(), s.end());
+    REQUIRE(ids == (std::vector<id_type>{7, 20, 21, 35, 63, 64, (1ULL << 27) + 13, 1ULL << 33}));
+}
+
+TEST_CASE("Iterating over IdSetDenseConcurrent with 32bit Ids") {
+    osmium::index::IdSetDenseConcurrent<uint32_t> s;
+    REQUIRE(s.begin() == s.end());
+
+    s.set(17);
+    s.set(std::numeric_limits<uint32_t>::max());
+    REQUIRE(s.size() == 2);
+    REQUIRE(s.get(std::numeric_limits<uint32_t>::max()));
+
+    const std::vector<uint32_t> ids(s.begin(), s.end());
+    REQUIRE(ids == (std::vector<uint32_t>{17, std::numeric_limits<uint32_t>::max()}));
+}
+
+TEST_CASE("Setting Ids in IdSetDenseConcurrent from several threads") {
+    osmium::index::IdSetDenseConcurrent<id_type> s{1ULL << 28};
+
+    const int num_threads = 4;
+    const id_type num_ids = 200000;
+    std::vector<std::thread> threads;
+    std::vector<id_type> added(num_threads, 0);
+
+    // All threads set the same Ids (in different order) spread over
+    // several chunks, so that bits in the same words and allocation of
+    // the same chunks happen concurrently.
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&s, &added, t, num_ids]() {
+            for (id_type n = 0; n < num_ids; ++n) {
+                const id_type i = (n * 7 + static_cast<id_type>(t) * 13) % num_ids;
+                if (s.check_and_set(i * 1000)) {
+                    ++added[t];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(s.size() == num_ids);
+    REQUIRE(added[0] + added[1] + added[2] + added[3] == num_ids);
+
+    id_type expected = 0;
+    for (const auto id : s) {
+        REQUIRE(id == expected);
+        expected += 1000;
+    }
+    REQUIRE(expected == num_ids * 1000);
+}
@@ -0,0 +1,126 @@
+#include "catch.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <osmium/change_applier.hpp>
+#include <osmium/io/opl_input.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/object.hpp>
+
+namespace {
+
+    const std::string snapshot =
+        "n1 v1 dV\n"
+        "n2 v3 dV\n"
+        "n4 v1 dV\n"
+        "n6 v2 dV\n"
+        "w1 v1 dV Nn1,n2\n"
+        "w3 v1 dV Nn2,n4\n"
+        "r1 v5 dV\n";
+
+    struct collector {
+
+        std::vector<std::string> objects;
+        int buffers = 0;
+
+        void operator()(osmium::memory::Buffer&& buffer) {
+            ++buffers;
+            for (const auto& object : buffer.select<osmium::OSMObject>()) {
+                objects.push_back(std::string(1, osmium::item_type_to_char(object.type())) +
+                                  std::to_string(object.id()) + "v" +
+                                  std::to_string(object.version()));
+            }
+        }
+
+    }; // struct collector
+
+    void add_opl(osmium::ChangeApplier& applier, const std::string& data) {
+        applier.read_changes(osmium::io::File{data.data(), data.size(), "opl"});
+    }
+
+    std::vector<std::string> apply(osmium::ChangeApplier& applier) {
+        osmium::io::Reader reader{osmium::io::File{snapshot.data(), snapshot.size(), "opl"}};
+        collector output;
+        applier.apply(reader, output);
+        reader.close();
+        return output.objects;
+    }
+
+} // anonymous namespace
+
+TEST_CASE("ChangeApplier without changes copies input") {
+    osmium::ChangeApplier applier;
+    REQUIRE(applier.num_changes() == 0);
+
+    REQUIRE(apply(applier) == (std::vector<std::string>{
+        "n1v1", "n2v3", "n4v1", "n6v2", "w1v1", "w3v1", "r1v5"
+    }));
+}
+
+TEST_CASE("ChangeApplier with creates, modifies, and deletes") {
+    osmium::ChangeApplier applier;
+    add_opl(applier,
+        "w3 v2 dD\n"
+        "n3 v1 dV\n"
+        "n2 v4 dV\n"
+        "n6 v3 dD\n"
+        "r2 v1 dV\n"
+        "n7 v1 dV\n"
+        "w2 v1 dV Nn3,n4\n"
+    );
+    REQUIRE(applier.num_changes() == 7);
+
+    REQUIRE(apply(applier) == (std::vector<std::string>{
+        "n1v1", "n2v4", "n3v1", "n4v1", "n7v1", "w1v1", "w2v1", "r1v5", "r2v1"
+    }));
+}
+
+TEST_CASE("ChangeApplier with several change files uses newest version") {
+    osmium::ChangeApplier applier;
+    add_opl(applier,
+        "n2 v4 dV\n"
+        "n3 v1 dV\n"
+        "w1 v2 dV Nn1,n3\n"
+    );
+    add_opl(applier,
+        "n2 v5 dV\n"
+        "n3 v2 dD\n"
+        "w1 v3 dV Nn1,n2\n"
+    );
+    REQUIRE(applier.num_changes() == 6);
+    applier.prepare();
+    REQUIRE(applier.num_changes() == 3);
+
+    REQUIRE(apply(applier) == (std::vector<std::string>{
+        "n1v1", "n2v5", "n4v1", "n6v2", "w1v3", "w3v1", "r1v5"
+    }));
+}
+
+TEST_CASE("ChangeApplier ignores older changes, same version replaces snapshot") {
+    osmium::ChangeApplier applier;
+    add_opl(applier,
+        "n2 v2 dV\n"
+        "r1 v5 dD\n"
+    );
+
+    REQUIRE(apply(applier) == (std::vector<std::string>{
+        "n1v1", "n2v3", "n4v1", "n6v2", "w1v1", "w3v1"
+    }));
+}
+
+TEST_CASE("ChangeApplier with changes in buffer") {
+    osmium::ChangeApplier applier;
+
+    const std::string changes = "n5 v1 dV\n";
+    osmium::io::Reader reader{osmium::io::File{changes.data(), changes.size(), "opl"}};
+    while (osmium::memory::Buffer buffer = reader.read()) {
+        applier.add_changes(std::move(buffer));
+    }
+    reader.close();
+
+    REQUIRE(apply(applier) == (std::vector<std::string>{
+        "n1v1", "n2v3", "n4v1", "n5v1", "n6v2", "w1v1", "w3v1", "r1v5"
+    }));
+}
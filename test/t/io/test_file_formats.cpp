@@ -119,6 +119,22 @@ TEST_CASE("FileFormats") {
         f.check();
     }
 
+    SECTION("detect_file_format_by_suffix_pg") {
+        osmium::io::File f {"test.pg"};
+        REQUIRE(osmium::io::file_format::pg == f.format());
+        REQUIRE(osmium::io::file_compression::none == f.compression());
+        REQUIRE(false == f.has_multiple_object_versions());
+        f.check();
+    }
+
+    SECTION("format_options_pg_binary") {
+        osmium::io::File f {"test", "pg,pg_binary=true,pg_tags=hstore"};
+        REQUIRE(osmium::io::file_format::pg == f.format());
+        REQUIRE(f.is_true("pg_binary"));
+        REQUIRE("hstore" == f.get("pg_tags"));
+        f.check();
+    }
+
     SECTION("override_file_format_by_suffix_osm") {
         osmium::io::File f {"test", "osm"};
         REQUIRE(osmium::io::file_format::xml == f.format());
@@ -0,0 +1,172 @@
+#include "catch.hpp"
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <osmium/io/merging_reader.hpp>
+#include <osmium/io/opl_input.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/object.hpp>
+#include <osmium/osm/object_comparisons.hpp>
+
+namespace {
+
+    const std::string input1 =
+        "n1 v1\n"
+        "n3 v1\n"
+        "n3 v2\n"
+        "w1 v1 Nn1,n3\n"
+        "r5 v1\n";
+
+    const std::string input2 =
+        "n2 v1\n"
+        "n3 v2\n"
+        "w2 v1 Nn2,n3\n"
+        "r1 v1\n";
+
+    const std::string input3 =
+        "n4 v1\n"
+        "w1 v1 Nn1,n3\n"
+        "w1 v2 Nn1,n4\n";
+
+    std::vector<osmium::io::File> files() {
+        return std::vector<osmium::io::File>{
+            osmium::io::File{input1.data(), input1.size(), "opl"},
+            osmium::io::File{input2.data(), input2.size(), "opl"},
+            osmium::io::File{input3.data(), input3.size(), "opl"}
+        };
+    }
+
+    template <typename TCompare>
+    std::vector<std::string> read_all(osmium::io::MergingReader<TCompare>& reader) {
+        std::vector<std::string> objects;
+        while (osmium::memory::Buffer buffer = reader.read()) {
+            for (const auto& object : buffer.select<osmium::OSMObject>()) {
+                objects.push_back(std::string(1, osmium::item_type_to_char(object.type())) +
+                                  std::to_string(object.id()) + "v" +
+                                  std::to_string(object.version()));
+            }
+        }
+        return objects;
+    }
+
+    // Orders objects by type and id only, different versions of an object
+    // compare equal.
+    struct order_type_id {
+
+        bool operator()(const osmium::OSMObject& lhs, const osmium::OSMObject& rhs) const noexcept {
+            if (lhs.type() != rhs.type()) {
+                return lhs.type() < rhs.type();
+            }
+            return lhs.id() < rhs.id();
+        }
+
+    }; // struct order_type_id
+
+} // anonymous namespace
+
+TEST_CASE("MergingReader with no inputs") {
+    osmium::io::MergingReader<> reader{std::vector<osmium::io::File>{}};
+    REQUIRE(reader.num_inputs() == 0);
+    REQUIRE_FALSE(reader.read());
+    REQUIRE(reader.eof());
+}
+
+TEST_CASE("MergingReader merges sorted inputs") {
+    osmium::io::MergingReader<> reader{files()};
+    REQUIRE(reader.num_inputs() == 3);
+    REQUIRE_FALSE(reader.eof());
+
+    const auto objects = read_all(reader);
+    REQUIRE(objects == (std::vector<std::string>{
+        "n1v1", "n2v1", "n3v1", "n3v2", "n3v2", "n4v1",
+        "w1v1", "w1v1", "w1v2", "w2v1",
+        "r1v1", "r5v1"
+    }));
+    REQUIRE(reader.eof());
+    REQUIRE_FALSE(reader.read());
+    reader.close();
+}
+
+TEST_CASE("MergingReader removes duplicates") {
+    osmium::io::MergingReader<> reader{files()};
+    reader.set_remove_duplicates();
+
+    const auto objects = read_all(reader);
+    REQUIRE(objects == (std::vector<std::string>{
+        "n1v1", "n2v1", "n3v1", "n3v2", "n4v1",
+        "w1v1", "w1v2", "w2v1",
+        "r1v1", "r5v1"
+    }));
+    reader.close();
+}
+
+TEST_CASE("MergingReader returns duplicates from first input first") {
+    const std::string a = "n1 v1 c10\n";
+    const std::string b = "n1 v1 c20\n";
+    osmium::io::MergingReader<> reader{std::vector<osmium::io::File>{
+        osmium::io::File{b.data(), b.size(), "opl"},
+        osmium::io::File{a.data(), a.size(), "opl"}
+    }};
+    reader.set_remove_duplicates();
+
+    const auto buffer = reader.read();
+    REQUIRE(buffer);
+    const auto& node = buffer.get<osmium::OSMObject>(0);
+    REQUIRE(node.changeset() == 20);
+    REQUIRE(std::distance(buffer.cbegin<osmium::OSMObject>(), buffer.cend<osmium::OSMObject>()) == 1);
+    REQUIRE_FALSE(reader.read());
+}
+
+TEST_CASE("MergingReader removes duplicates with reverse version order") {
+    const std::string a = "n1 v2\nn1 v1\nn2 v1\n";
+    const std::string b = "n1 v2\nn2 v1\n";
+    const std::string c = "n1 v1\nn2 v2\n";
+    osmium::io::MergingReader<osmium::object_order_type_id_reverse_version> reader{std::vector<osmium::io::File>{
+        osmium::io::File{a.data(), a.size(), "opl"},
+        osmium::io::File{b.data(), b.size(), "opl"},
+        osmium::io::File{c.data(), c.size(), "opl"}
+    }};
+    reader.set_remove_duplicates();
+
+    const auto objects = read_all(reader);
+    REQUIRE(objects == (std::vector<std::string>{
+        "n1v2", "n1v1", "n2v2", "n2v1"
+    }));
+}
+
+TEST_CASE("MergingReader removes duplicates not following each other") {
+    // With this order the merged stream is n1v1 n1v2 (from the first
+    // input) and then n1v1 n1v2 (from the second input).
+    const std::string a = "n1 v1\nn1 v2\nn2 v1\n";
+    const std::string b = "n1 v1\nn1 v2\nn3 v1\n";
+    osmium::io::MergingReader<order_type_id> reader{std::vector<osmium::io::File>{
+        osmium::io::File{a.data(), a.size(), "opl"},
+        osmium::io::File{b.data(), b.size(), "opl"}
+    }};
+
+    SECTION("with duplicates") {
+        const auto objects = read_all(reader);
+        REQUIRE(objects == (std::vector<std::string>{
+            "n1v1", "n1v2", "n1v1", "n1v2", "n2v1", "n3v1"
+        }));
+    }
+
+    SECTION("without duplicates") {
+        reader.set_remove_duplicates();
+        const auto objects = read_all(reader);
+        REQUIRE(objects == (std::vector<std::string>{
+            "n1v1", "n1v2", "n2v1", "n3v1"
+        }));
+    }
+}
+
+TEST_CASE("MergingReader reads entity types given to constructor") {
+    osmium::io::MergingReader<> reader{files(), osmium::osm_entity_bits::way};
+
+    const auto objects = read_all(reader);
+    REQUIRE(objects == (std::vector<std::string>{
+        "w1v1", "w1v1", "w1v2", "w2v1"
+    }));
+}
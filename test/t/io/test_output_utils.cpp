@@ -151,3 +151,36 @@ TEST_CASE("encoding of non-printable characters in the first 127 characters") {
 
 }
 
+
+TEST_CASE("json encoding") {
+    std::string out;
+
+    SECTION("plain string") {
+        osmium::io::detail::append_json_encoded_string(out, "foo bar");
+        REQUIRE(out == "foo bar");
+    }
+
+    SECTION("special characters") {
+        osmium::io::detail::append_json_encoded_string(out, "a\"b\\c\nd\te\x01");
+        REQUIRE(out == "a\\\"b\\\\c\\nd\\te\\u0001");
+    }
+
+    SECTION("utf8 is not changed") {
+        osmium::io::detail::append_json_encoded_string(out, "\xc3\xa4");
+        REQUIRE(out == "\xc3\xa4");
+    }
+}
+
+TEST_CASE("pg copy encoding") {
+    std::string out;
+
+    SECTION("plain string") {
+        osmium::io::detail::append_pg_copy_encoded_string(out, "foo \"bar\"");
+        REQUIRE(out == "foo \"bar\"");
+    }
+
+    SECTION("special characters") {
+        osmium::io::detail::append_pg_copy_encoded_string(out, "a\\b\nc\td\re");
+        REQUIRE(out == "a\\\\b\\nc\\td\\re");
+    }
+}
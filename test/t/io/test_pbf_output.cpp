@@ -0,0 +1,147 @@
+#include "catch.hpp"
+
+#include <cstdio>
+#include <string>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/io/pbf_input.hpp>
+#include <osmium/io/pbf_output.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/node.hpp>
+#include <osmium/osm/relation.hpp>
+#include <osmium/osm/way.hpp>
+
+using namespace osmium::builder::attr;
+
+namespace {
+
+    osmium::memory::Buffer create_test_buffer() {
+        osmium::memory::Buffer buffer{10240};
+
+        osmium::builder::add_node(buffer,
+            _id(1),
+            _version(1),
+            _timestamp("2016-01-01T01:02:03Z"),
+            _user("rare"),
+            _location(1.0, 2.0),
+            _tag("amenity", "bench")
+        );
+
+        for (osmium::object_id_type id = 2; id <= 5; ++id) {
+            osmium::builder::add_node(buffer,
+                _id(id),
+                _version(1),
+                _timestamp("2016-01-01T01:02:03Z"),
+                _user("common"),
+                _location(1.0, 2.0),
+                _tag("highway", "crossing"),
+                _tag("crossing", "zebra")
+            );
+        }
+
+        osmium::builder::add_way(buffer,
+            _id(10),
+            _version(1),
+            _timestamp("2016-01-01T01:02:03Z"),
+            _user("rare"),
+            _tag("name", "Foo"),
+            _nodes({1, 2})
+        );
+
+        osmium::builder::add_way(buffer,
+            _id(11),
+            _version(1),
+            _timestamp("2016-01-01T01:02:03Z"),
+            _user("common"),
+            _tag("highway", "primary"),
+            _tag("name", "Bar"),
+            _nodes({2, 3})
+        );
+
+        osmium::builder::add_relation(buffer,
+            _id(20),
+            _version(1),
+            _timestamp("2016-01-01T01:02:03Z"),
+            _user("other"),
+            _tag("type", "route"),
+            _member(osmium::item_type::way, 10, "forward"),
+            _member(osmium::item_type::way, 11, "backward"),
+            _member(osmium::item_type::node, 2, "stop")
+        );
+
+        return buffer;
+    }
+
+    void check_roundtrip(const std::string& format) {
+        const std::string filename{"test-pbf-output.osm.pbf"};
+
+        {
+            osmium::io::Writer writer{osmium::io::File{filename, format}, osmium::io::overwrite::allow};
+            writer(create_test_buffer());
+            writer.close();
+        }
+
+        osmium::memory::Buffer buffer{10240, osmium::memory::Buffer::auto_grow::yes};
+        osmium::io::Reader reader{filename};
+        while (osmium::memory::Buffer read_buffer = reader.read()) {
+            buffer.add_buffer(read_buffer);
+            buffer.commit();
+        }
+        reader.close();
+        std::remove(filename.c_str());
+
+        auto it = buffer.select<osmium::OSMObject>().cbegin();
+
+        REQUIRE(it->id() == 1);
+        REQUIRE(std::string(it->user()) == "rare");
+        REQUIRE(std::string(it->tags().get_value_by_key("amenity")) == "bench");
+        ++it;
+
+        for (osmium::object_id_type id = 2; id <= 5; ++id, ++it) {
+            REQUIRE(it->id() == id);
+            REQUIRE(std::string(it->user()) == "common");
+            REQUIRE(it->tags().size() == 2);
+            REQUIRE(std::string(it->tags().get_value_by_key("highway")) == "crossing");
+            REQUIRE(std::string(it->tags().get_value_by_key("crossing")) == "zebra");
+        }
+
+        REQUIRE(it->id() == 10);
+        REQUIRE(std::string(it->user()) == "rare");
+        REQUIRE(std::string(it->tags().get_value_by_key("name")) == "Foo");
+        ++it;
+
+        REQUIRE(it->id() == 11);
+        REQUIRE(std::string(it->user()) == "common");
+        REQUIRE(std::string(it->tags().get_value_by_key("highway")) == "primary");
+        REQUIRE(std::string(it->tags().get_value_by_key("name")) == "Bar");
+        ++it;
+
+        REQUIRE(it->id() == 20);
+        REQUIRE(std::string(it->user()) == "other");
+        REQUIRE(std::string(it->tags().get_value_by_key("type")) == "route");
+        const auto& relation = static_cast<const osmium::Relation&>(*it);
+        auto mit = relation.members().cbegin();
+        REQUIRE(std::string(mit->role()) == "forward");
+        ++mit;
+        REQUIRE(std::string(mit->role()) == "backward");
+        ++mit;
+        REQUIRE(std::string(mit->role()) == "stop");
+        REQUIRE(mit->ref() == 2);
+        ++it;
+
+        REQUIRE(it == buffer.select<osmium::OSMObject>().cend());
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Write and read PBF file") {
+    check_roundtrip("pbf");
+}
+
+TEST_CASE("Write and read PBF file with sorted string table") {
+    check_roundtrip("pbf,pbf_sort_stringtable=true");
+}
+
+TEST_CASE("Write and read PBF file with sorted string table without dense nodes") {
+    check_roundtrip("pbf,pbf_sort_stringtable=true,pbf_dense_nodes=false");
+}
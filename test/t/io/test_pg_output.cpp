@@ -0,0 +1,139 @@
+#include "catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/io/pg_output.hpp>
+#include <osmium/memory/buffer.hpp>
+
+using namespace osmium::builder::attr;
+
+namespace {
+
+    osmium::memory::Buffer create_test_buffer() {
+        osmium::memory::Buffer buffer{10240};
+
+        osmium::builder::add_node(buffer,
+            _id(1),
+            _version(2),
+            _cid(3),
+            _uid(4),
+            _user("foo\tbar"),
+            _timestamp("2016-01-01T01:02:03Z"),
+            _location(3.2, 4.2),
+            _tag("name", "a\"b\\c")
+        );
+
+        osmium::builder::add_node(buffer,
+            _id(2)
+        );
+
+        osmium::builder::add_way(buffer,
+            _id(20),
+            _tag("highway", "primary"),
+            _nodes({
+                {1, {3.2, 4.2}},
+                {3, {3.5, 4.7}},
+                {4, {3.5, 4.7}},
+                {2, {3.6, 4.9}}
+            })
+        );
+
+        osmium::builder::add_way(buffer,
+            _id(21),
+            _nodes({1, 2})
+        );
+
+        osmium::builder::add_area(buffer,
+            _id(60),
+            _tag("building", "yes"),
+            _outer_ring({
+                {1, {3.2, 4.2}},
+                {2, {3.5, 4.7}},
+                {3, {3.6, 4.9}},
+                {1, {3.2, 4.2}}
+            })
+        );
+
+        return buffer;
+    }
+
+    std::string encode(osmium::io::detail::pg_output_options options) {
+        osmium::io::detail::PgOutputBlock block{create_test_buffer(), options};
+        return block();
+    }
+
+} // anonymous namespace
+
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+
+TEST_CASE("PostgreSQL COPY text output") {
+    osmium::io::detail::pg_output_options options;
+    options.add_metadata = false;
+    options.use_binary = false;
+    options.tags_type = osmium::io::detail::pg_tags_type::json;
+
+    SECTION("json tags") {
+        REQUIRE(encode(options) ==
+            "0101000020E61000009A99999999990940CDCCCCCCCCCC1040\tn\t1\t{\"name\":\"a\\\\\"b\\\\\\\\c\"}\n"
+            "0102000020E6100000030000009A99999999990940CDCCCCCCCCCC10400000000000000C40CDCCCCCCCCCC1240CDCCCCCCCCCC0C409A99999999991340\tw\t20\t{\"highway\":\"primary\"}\n"
+            "0106000020E6100000010000000103000020E610000001000000040000009A99999999990940CDCCCCCCCCCC10400000000000000C40CDCCCCCCCCCC1240CDCCCCCCCCCC0C409A999999999913409A99999999990940CDCCCCCCCCCC1040\tw\t30\t{\"building\":\"yes\"}\n"
+        );
+    }
+
+    SECTION("hstore tags with metadata") {
+        options.add_metadata = true;
+        options.tags_type = osmium::io::detail::pg_tags_type::hstore;
+        const std::string out = encode(options);
+        const std::string first_row = out.substr(0, out.find('\n'));
+        REQUIRE(first_row == "0101000020E61000009A99999999990940CDCCCCCCCCCC1040\tn\t1\t2\t3\t2016-01-01T01:02:03Z\t4\tfoo\\tbar\t\"name\"=>\"a\\\\\"b\\\\\\\\c\"");
+    }
+}
+
+#endif
+
+TEST_CASE("PostgreSQL COPY binary output") {
+    osmium::io::detail::pg_output_options options;
+    options.add_metadata = true;
+    options.use_binary = true;
+    options.tags_type = osmium::io::detail::pg_tags_type::jsonb;
+
+    const std::string out = encode(options);
+
+    // field count
+    REQUIRE(out.substr(0, 2) == std::string("\x00\x09", 2));
+
+    // length of point geometry
+    REQUIRE(out.substr(2, 4) == std::string("\x00\x00\x00\x19", 4));
+
+    // object type
+    REQUIRE(out.substr(2 + 4 + 25, 5) == std::string("\x00\x00\x00\x01n", 5));
+
+    // object id
+    REQUIRE(out.substr(2 + 4 + 25 + 5, 12) == std::string("\x00\x00\x00\x08\x00\x00\x00\x00\x00\x00\x00\x01", 12));
+
+    // tags of the area as jsonb
+    const std::string tags{"\x00\x00\x00\x13\x01{\"building\":\"yes\"}", 23};
+    REQUIRE(out.substr(out.size() - tags.size()) == tags);
+}
+
+TEST_CASE("PostgreSQL COPY binary output with Writer") {
+    const std::string filename{"test-pg-output.pg"};
+
+    {
+        osmium::io::Writer writer{osmium::io::File{filename, "pg,pg_binary=true"}, osmium::io::overwrite::allow};
+        writer(create_test_buffer());
+        writer.close();
+    }
+
+    std::ifstream file{filename, std::ios::binary};
+    const std::string data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    std::remove(filename.c_str());
+
+    REQUIRE(data.size() > 21);
+    REQUIRE(data.substr(0, 19) == std::string("PGCOPY\n\377\r\n\0\0\0\0\0\0\0\0\0", 19));
+    REQUIRE(data.substr(data.size() - 2) == std::string("\377\377", 2));
+}
@@ -1,5 +1,9 @@
 #include "catch.hpp"
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include <osmium/io/detail/string_table.hpp>
 
 TEST_CASE("String store") {
@@ -128,3 +132,92 @@ TEST_CASE("lots of strings in string table so chunk overflows") {
     REQUIRE(it == st.end());
 }
 
+
+TEST_CASE("String store keeps memory after clear") {
+    osmium::io::detail::StringStore ss(100);
+
+    for (int i = 0; i < 100; ++i) {
+        ss.add("abcdefghij");
+    }
+    const auto chunks = ss.get_allocated_chunk_count();
+    REQUIRE(chunks > 1);
+    REQUIRE(ss.get_chunk_count() == chunks);
+
+    ss.clear();
+    REQUIRE(ss.get_chunk_count() == 1);
+    REQUIRE(ss.get_allocated_chunk_count() == chunks);
+
+    for (int i = 0; i < 100; ++i) {
+        ss.add("abcdefghij");
+    }
+    REQUIRE(ss.get_allocated_chunk_count() == chunks);
+
+    int count = 0;
+    for (const char* s : ss) {
+        REQUIRE(std::string(s) == "abcdefghij");
+        ++count;
+    }
+    REQUIRE(count == 100);
+}
+
+TEST_CASE("String table with strings containing the same bytes") {
+    osmium::io::detail::StringTable st;
+
+    REQUIRE(st.add("abcdefgh") == 1);
+    REQUIRE(st.add("abcdefghi") == 2);
+    REQUIRE(st.add("abcdefgh\0x", 10) == 3);
+    REQUIRE(st.add("abcdefgh") == 1);
+    REQUIRE(st.add("abcdefgh\0x", 10) == 3);
+
+    auto it = st.begin();
+    ++it;
+    REQUIRE(it.size() == 8);
+    ++it;
+    REQUIRE(it.size() == 9);
+    ++it;
+    REQUIRE(it.size() == 10);
+}
+
+TEST_CASE("String table grows index") {
+    osmium::io::detail::StringTable st;
+
+    const uint32_t n = 10000;
+    for (uint32_t i = 1; i <= n; ++i) {
+        REQUIRE(st.add(std::to_string(i).c_str()) == i);
+    }
+    for (uint32_t i = 1; i <= n; ++i) {
+        REQUIRE(st.add(std::to_string(i).c_str()) == i);
+    }
+    REQUIRE(st.size() == n + 1);
+
+    st.clear();
+    REQUIRE(st.size() == 1);
+    REQUIRE(st.add("foo") == 1);
+}
+
+TEST_CASE("Sort string table by frequency") {
+    osmium::io::detail::StringTable st;
+
+    st.add("rare");
+    st.add("common");
+    st.add("medium");
+    st.add("common");
+    st.add("medium");
+    st.add("common");
+    st.add("other");
+
+    const auto old_to_new = st.sort_by_frequency();
+    REQUIRE(old_to_new == (std::vector<uint32_t>{0, 3, 1, 2, 4}));
+
+    auto it = st.begin();
+    REQUIRE(std::string("") == *it++);
+    REQUIRE(std::string("common") == *it++);
+    REQUIRE(std::string("medium") == *it++);
+    REQUIRE(std::string("rare") == *it++);
+    REQUIRE(std::string("other") == *it++);
+    REQUIRE(it == st.end());
+
+    REQUIRE(st.add("common") == 1);
+    REQUIRE(st.add("other") == 4);
+    REQUIRE(st.add("new") == 5);
+}
@@ -0,0 +1,139 @@
+#include "catch.hpp"
+
+#include <cstring>
+#include <vector>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/memory/node_batch.hpp>
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/node.hpp>
+#include <osmium/osm/way.hpp>
+
+using namespace osmium::builder::attr;
+
+namespace {
+
+    osmium::memory::Buffer create_buffer() {
+        osmium::memory::Buffer buffer{10240, osmium::memory::Buffer::auto_grow::yes};
+
+        osmium::builder::add_node(buffer,
+            _id(1),
+            _version(2),
+            _cid(17),
+            _uid(42),
+            _user("foo"),
+            _timestamp(osmium::Timestamp{"2016-01-02T03:04:05Z"}),
+            _location(1.5, 2.5),
+            _tag("highway", "crossing"),
+            _tag("name", "Main Street")
+        );
+        osmium::builder::add_way(buffer,
+            _id(10),
+            _nodes({1, 2})
+        );
+        osmium::builder::add_node(buffer,
+            _id(2),
+            _version(1),
+            _visible(false)
+        );
+        osmium::builder::add_node(buffer,
+            _id(3),
+            _version(5),
+            _user("foo"),
+            _location(-3.25, -4.75),
+            _tag("name", "Main Street"),
+            _tag("highway", "stop")
+        );
+
+        return buffer;
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Fill NodeBatch from buffer") {
+    const auto buffer = create_buffer();
+
+    osmium::memory::NodeBatch batch;
+    REQUIRE(batch.empty());
+    REQUIRE(batch.add_buffer(buffer) == 3);
+    REQUIRE(batch.size() == 3);
+
+    REQUIRE(batch.ids() == (std::vector<osmium::object_id_type>{1, 2, 3}));
+    REQUIRE(batch.versions() == (std::vector<osmium::object_version_type>{2, 1, 5}));
+    REQUIRE(batch.changesets() == (std::vector<osmium::changeset_id_type>{17, 0, 0}));
+    REQUIRE(batch.uids() == (std::vector<osmium::user_id_type>{42, 0, 0}));
+    REQUIRE(batch.timestamps()[0] == uint32_t(osmium::Timestamp{"2016-01-02T03:04:05Z"}));
+    REQUIRE(batch.visible() == (std::vector<bool>{true, false, true}));
+
+    REQUIRE(batch.x()[0] == 15000000);
+    REQUIRE(batch.y()[0] == 25000000);
+    REQUIRE(batch.location(0) == osmium::Location(1.5, 2.5));
+    REQUIRE_FALSE(batch.location(1).valid());
+    REQUIRE(batch.location(2) == osmium::Location(-3.25, -4.75));
+
+    REQUIRE(batch.users().size() == 1);
+    REQUIRE(batch.user_ids() == (std::vector<uint32_t>{1, 0, 1}));
+
+    REQUIRE(batch.tag_offsets() == (std::vector<std::size_t>{0, 2, 2, 4}));
+    REQUIRE(batch.keys().size() == 2);
+    REQUIRE(batch.values().size() == 3);
+
+    const uint32_t highway = batch.keys().lookup("highway");
+    const uint32_t name = batch.keys().lookup("name");
+    REQUIRE(highway != 0);
+    REQUIRE(name != 0);
+    REQUIRE(batch.tag_value_id(0, name) == batch.tag_value_id(2, name));
+    REQUIRE(batch.tag_value_id(1, name) == 0);
+    REQUIRE(!std::strcmp(batch.values().key(batch.tag_value_id(2, highway)), "stop"));
+
+    const auto column = batch.tag_column(highway);
+    REQUIRE(column.size() == 3);
+    REQUIRE(!std::strcmp(batch.values().key(column[0]), "crossing"));
+    REQUIRE(column[1] == 0);
+    REQUIRE(!std::strcmp(batch.values().key(column[2]), "stop"));
+
+    REQUIRE(batch.tag_column(batch.keys().lookup("unknown")) == (std::vector<uint32_t>{0, 0, 0}));
+
+    SECTION("clear keeps dictionaries") {
+        batch.clear();
+        REQUIRE(batch.empty());
+        REQUIRE(batch.tag_offsets().size() == 1);
+        REQUIRE(batch.keys().size() == 2);
+        batch.add_buffer(buffer);
+        REQUIRE(batch.keys().lookup("highway") == highway);
+        REQUIRE(batch.tag_offsets() == (std::vector<std::size_t>{0, 2, 2, 4}));
+    }
+}
+
+TEST_CASE("Write NodeBatch back into buffer") {
+    const auto buffer = create_buffer();
+
+    osmium::memory::NodeBatch batch;
+    batch.add_buffer(buffer);
+
+    osmium::memory::Buffer out{1024, osmium::memory::Buffer::auto_grow::yes};
+    batch.write_to(out);
+
+    auto it = out.select<osmium::Node>().begin();
+    for (const auto& node : buffer.select<osmium::Node>()) {
+        REQUIRE(it != out.select<osmium::Node>().end());
+        REQUIRE(it->id() == node.id());
+        REQUIRE(it->version() == node.version());
+        REQUIRE(it->changeset() == node.changeset());
+        REQUIRE(it->uid() == node.uid());
+        REQUIRE(!std::strcmp(it->user(), node.user()));
+        REQUIRE(it->timestamp() == node.timestamp());
+        REQUIRE(it->visible() == node.visible());
+        REQUIRE(it->location() == node.location());
+        REQUIRE(it->tags().size() == node.tags().size());
+        auto tit = it->tags().begin();
+        for (const auto& tag : node.tags()) {
+            REQUIRE(!std::strcmp(tit->key(), tag.key()));
+            REQUIRE(!std::strcmp(tit->value(), tag.value()));
+            ++tit;
+        }
+        ++it;
+    }
+    REQUIRE(it == out.select<osmium::Node>().end());
+}
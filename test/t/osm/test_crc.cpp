@@ -2,6 +2,8 @@
 
 #include <boost/crc.hpp>
 
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
 #include <osmium/osm/crc.hpp>
 
 TEST_CASE("CRC of basic datatypes") {
@@ -66,3 +68,27 @@ TEST_CASE("CRC of basic datatypes") {
 
 }
 
+
+TEST_CASE("CRC of node ref list is the same as CRC of its node refs") {
+    osmium::memory::Buffer buffer{10240};
+    osmium::builder::add_way(buffer,
+        osmium::builder::attr::_nodes({
+            {1, {1.0, 2.0}},
+            {-2, {1.5, 2.5}},
+            {3, osmium::Location{}}
+        })
+    );
+    const auto& nodes = buffer.get<osmium::Way>(0).nodes();
+
+    osmium::CRC<boost::crc_32_type> crc32;
+    crc32.update(nodes);
+
+    osmium::CRC<boost::crc_32_type> crc32_single;
+    for (const auto& nr : nodes) {
+        crc32_single.update_int64(nr.ref());
+        crc32_single.update_int32(nr.location().x());
+        crc32_single.update_int32(nr.location().y());
+    }
+
+    REQUIRE(crc32().checksum() == crc32_single().checksum());
+}
@@ -1,6 +1,11 @@
 #include "catch.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <limits>
 #include <sstream>
+#include <string>
 
 #include <osmium/osm/timestamp.hpp>
 
@@ -119,3 +124,84 @@ TEST_CASE("Invalid timestamps") {
     REQUIRE_THROWS_AS(osmium::Timestamp{"2000-03-32T00:00:00Z"}, std::invalid_argument);
 }
 
+
+TEST_CASE("Overflowing timestamps are carried over like timegm() does") {
+    REQUIRE(osmium::Timestamp{"2015-02-29T00:00:00Z"}.to_iso() == "2015-03-01T00:00:00Z");
+    REQUIRE(osmium::Timestamp{"2016-02-29T00:00:00Z"}.to_iso() == "2016-02-29T00:00:00Z");
+    REQUIRE(osmium::Timestamp{"2016-12-31T23:59:60Z"}.to_iso() == "2017-01-01T00:00:00Z");
+}
+
+TEST_CASE("Timestamps at the limits of the range") {
+    REQUIRE(osmium::Timestamp{"2106-02-07T06:28:15Z"}.to_iso() == "2106-02-07T06:28:15Z");
+    REQUIRE(uint32_t(osmium::Timestamp{"2106-02-07T06:28:15Z"}) == std::numeric_limits<uint32_t>::max());
+    REQUIRE(osmium::end_of_time().to_iso() == "2106-02-07T06:28:15Z");
+    REQUIRE(osmium::start_of_time().to_iso() == "1970-01-01T00:00:01Z");
+    REQUIRE(osmium::detail::parse_timestamp("1970-01-01T00:00:00Z") == 0);
+    REQUIRE(osmium::detail::parse_timestamp("1969-12-31T23:59:59Z") == -1);
+    REQUIRE(osmium::detail::parse_timestamp("1900-01-01T00:00:00Z") == -2208988800LL);
+}
+
+TEST_CASE("to_iso_str() appends to string") {
+    std::string s{"x"};
+    osmium::Timestamp{}.to_iso_str(s);
+    REQUIRE(s == "x");
+    osmium::Timestamp{"2016-01-02T03:04:05Z"}.to_iso_str(s);
+    REQUIRE(s == "x2016-01-02T03:04:05Z");
+}
+
+#ifndef _WIN32
+namespace {
+
+    std::string reference_to_iso(time_t t) {
+        struct tm tm;
+        gmtime_r(&t, &tm);
+        char buffer[21];
+        strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        return buffer;
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Round trip all days in the valid range") {
+    // check every day with a changing time of day
+    const uint64_t max = std::numeric_limits<uint32_t>::max();
+    uint64_t days = 0;
+    for (; days * 86400 <= max; ++days) {
+        const uint64_t t = std::min(days * 86400 + (days * 3607 + 1) % 86400, max);
+        const osmium::Timestamp timestamp{static_cast<uint32_t>(t)};
+        const std::string iso = timestamp.to_iso();
+        REQUIRE(iso == reference_to_iso(static_cast<time_t>(t)));
+        REQUIRE(uint32_t(osmium::Timestamp{iso}) == t);
+    }
+    REQUIRE(days == 49711);
+}
+
+TEST_CASE("Round trip all seconds of a day") {
+    const uint32_t start = 1451606400; // 2016-01-01T00:00:00Z
+    for (uint32_t t = start; t < start + 86400; ++t) {
+        const std::string iso = osmium::Timestamp{t}.to_iso();
+        REQUIRE(iso == reference_to_iso(static_cast<time_t>(t)));
+        REQUIRE(uint32_t(osmium::Timestamp{iso}) == t);
+    }
+}
+
+TEST_CASE("Parse all days from 1900 to 2199 like timegm()") {
+    static const int mon_lengths[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    char buffer[64]; // large enough for any int values, avoids -Wformat-truncation
+    for (int year = 1900; year < 2200; ++year) {
+        for (int month = 1; month <= 12; ++month) {
+            for (int day = 1; day <= mon_lengths[month - 1]; ++day) {
+                std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT12:34:56Z", year, month, day);
+                struct tm tm{};
+                tm.tm_year = year - 1900;
+                tm.tm_mon = month - 1;
+                tm.tm_mday = day;
+                tm.tm_hour = 12;
+                tm.tm_min = 34;
+                tm.tm_sec = 56;
+                REQUIRE(osmium::detail::parse_timestamp(buffer) == timegm(&tm));
+            }
+        }
+    }
+}
+#endif
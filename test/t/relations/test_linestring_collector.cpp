@@ -0,0 +1,137 @@
+#include "catch.hpp"
+
+#include <vector>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/way.hpp>
+#include <osmium/relations/linestring_collector.hpp>
+#include <osmium/visitor.hpp>
+
+using namespace osmium::builder::attr;
+
+namespace {
+
+    std::vector<osmium::object_id_type> node_ids(const osmium::Way& way) {
+        std::vector<osmium::object_id_type> ids;
+        for (const auto& nr : way.nodes()) {
+            ids.push_back(nr.ref());
+        }
+        return ids;
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Merge ways into linestrings") {
+    osmium::memory::Buffer buffer{10240};
+    osmium::relations::detail::LinestringMerger merger;
+
+    const auto w1 = osmium::builder::add_way(buffer, _id(1), _nodes({
+        {1, {0.0, 0.0}},
+        {2, {1.0, 0.0}},
+        {3, {2.0, 0.0}}
+    }));
+    const auto w2 = osmium::builder::add_way(buffer, _id(2), _nodes({
+        {5, {4.0, 0.0}},
+        {4, {3.0, 0.0}},
+        {3, {2.0, 0.0}}
+    }));
+    const auto w3 = osmium::builder::add_way(buffer, _id(3), _nodes({
+        {3, {2.0, 0.0}},
+        {6, {2.0, 1.0}}
+    }));
+    const auto w4 = osmium::builder::add_way(buffer, _id(4), _nodes({
+        {10, {0.0, 5.0}},
+        {11, {1.0, 5.0}},
+        {12, {1.0, 6.0}},
+        {10, {0.0, 5.0}}
+    }));
+
+    const osmium::Way* way1 = &buffer.get<osmium::Way>(w1);
+    const osmium::Way* way2 = &buffer.get<osmium::Way>(w2);
+    const osmium::Way* way3 = &buffer.get<osmium::Way>(w3);
+    const osmium::Way* way4 = &buffer.get<osmium::Way>(w4);
+
+    SECTION("two connected ways with different directions") {
+        merger.merge({way2, way1});
+        REQUIRE(merger.num_linestrings() == 1);
+        const auto ls = merger.linestring(0);
+        REQUIRE(std::distance(ls.first, ls.second) == 5);
+        REQUIRE(ls.first[0].ref() == 1);
+        REQUIRE(ls.first[2].ref() == 3);
+        REQUIRE(ls.first[4].ref() == 5);
+    }
+
+    SECTION("duplicate ways are only used once") {
+        merger.merge({way1, way2, way1});
+        REQUIRE(merger.num_linestrings() == 1);
+    }
+
+    SECTION("branching ways") {
+        merger.merge({way1, way2, way3});
+        REQUIRE(merger.num_linestrings() == 3);
+    }
+
+    SECTION("closed way and disconnected way") {
+        merger.merge({way1, way4});
+        REQUIRE(merger.num_linestrings() == 2);
+        const auto ls = merger.linestring(1);
+        REQUIRE(std::distance(ls.first, ls.second) == 4);
+        REQUIRE(ls.first[0].ref() == 10);
+        REQUIRE(std::prev(ls.second)->ref() == 10);
+    }
+
+    SECTION("re-use merger") {
+        merger.merge({way1, way2, way3});
+        merger.merge({way1});
+        REQUIRE(merger.num_linestrings() == 1);
+    }
+}
+
+TEST_CASE("Collect route relations") {
+    osmium::memory::Buffer buffer{10240};
+
+    osmium::builder::add_way(buffer, _id(1), _nodes({
+        {1, {0.0, 0.0}},
+        {2, {1.0, 0.0}}
+    }));
+    osmium::builder::add_way(buffer, _id(2), _nodes({
+        {3, {2.0, 0.0}},
+        {2, {1.0, 0.0}}
+    }));
+    osmium::builder::add_way(buffer, _id(3), _nodes({
+        {7, {5.0, 0.0}},
+        {8, {6.0, 0.0}}
+    }));
+    osmium::builder::add_relation(buffer, _id(20), _tag("type", "route"), _tag("route", "bus"),
+        _member(osmium::item_type::node, 1, "stop"),
+        _member(osmium::item_type::way, 1, ""),
+        _member(osmium::item_type::way, 2, ""),
+        _member(osmium::item_type::way, 3, "")
+    );
+    osmium::builder::add_relation(buffer, _id(21), _tag("type", "multipolygon"),
+        _member(osmium::item_type::way, 1, "outer")
+    );
+
+    osmium::relations::LinestringCollector collector;
+    collector.read_relations(buffer.cbegin(), buffer.cend());
+
+    std::vector<osmium::memory::Buffer> results;
+    osmium::apply(buffer, collector.handler([&results](osmium::memory::Buffer&& b) {
+        results.push_back(std::move(b));
+    }));
+
+    REQUIRE(results.size() == 1);
+    REQUIRE(collector.count_relations() == 1);
+    REQUIRE(collector.count_linestrings() == 2);
+
+    auto it = results.front().select<osmium::Way>().cbegin();
+    REQUIRE(it->id() == 20);
+    REQUIRE(it->tags().size() == 2);
+    REQUIRE(node_ids(*it) == (std::vector<osmium::object_id_type>{1, 2, 3}));
+    ++it;
+    REQUIRE(it->id() == 20);
+    REQUIRE(node_ids(*it) == (std::vector<osmium::object_id_type>{7, 8}));
+    ++it;
+    REQUIRE(it == results.front().select<osmium::Way>().cend());
+}
@@ -1,6 +1,7 @@
 #include "catch.hpp"
 
 #include <algorithm>
+#include <string>
 
 #include <osmium/builder/attr.hpp>
 #include <osmium/memory/buffer.hpp>
@@ -119,6 +120,56 @@ TEST_CASE("KeyValueFilter") {
         check_filter(tag_list2, filter2, {true, false});
     }
 
+    SECTION("KeyValueFilter first matching rule wins") {
+        osmium::tags::KeyValueFilter filter{true};
+
+        filter.add(false, "highway", "road")
+              .add(true, "highway", "primary")
+              .add(false, "highway", "primary")
+              .add(false, "highway")
+              .add(true, "highway", "secondary")
+              .add(true, "railway", "tram")
+              .add(false, "railway");
+
+        const osmium::TagList& tag_list = make_tag_list(buffer, {
+            { "highway", "road" },
+            { "highway", "primary" },
+            { "highway", "secondary" },
+            { "highway", "tertiary" },
+            { "railway", "tram" },
+            { "railway", "rail" },
+            { "source", "GPS" }
+        });
+
+        check_filter(tag_list, filter, {false, true, false, false, true, false, true});
+    }
+
+    SECTION("KeyValueFilter with many rules") {
+        osmium::tags::KeyValueFilter filter{false};
+
+        for (int i = 0; i < 100; ++i) {
+            const std::string key = "key" + std::to_string(i);
+            if (i % 2) {
+                filter.add(true, key);
+            } else {
+                filter.add(true, key, "yes");
+            }
+        }
+        REQUIRE(filter.count() == 100);
+
+        const osmium::TagList& tag_list = make_tag_list(buffer, {
+            { "key0", "yes" },
+            { "key0", "no" },
+            { "key1", "no" },
+            { "key98", "yes" },
+            { "key99", "" },
+            { "key100", "yes" },
+            { "", "yes" }
+        });
+
+        check_filter(tag_list, filter, {true, false, true, true, true, false, false});
+    }
+
     SECTION("KeyValueFilter matches against taglist with any") {
         osmium::tags::KeyValueFilter filter{false};
 
@@ -218,6 +269,53 @@ TEST_CASE("RegexFilter") {
 
 }
 
+TEST_CASE("PrefixedRegex finds literal prefix") {
+    REQUIRE(osmium::tags::PrefixedRegex{"abc.*"}.prefix() == "abc");
+    REQUIRE(osmium::tags::PrefixedRegex{"name:[a-z]+"}.prefix() == "name:");
+    REQUIRE(osmium::tags::PrefixedRegex{"ab?c"}.prefix() == "a");
+    REQUIRE(osmium::tags::PrefixedRegex{"abc*"}.prefix() == "ab");
+    REQUIRE(osmium::tags::PrefixedRegex{"ab+c"}.prefix() == "ab");
+    REQUIRE(osmium::tags::PrefixedRegex{"ab{0,2}"}.prefix() == "a");
+    REQUIRE(osmium::tags::PrefixedRegex{"abc"}.prefix() == "abc");
+    REQUIRE(osmium::tags::PrefixedRegex{"abc|def"}.prefix().empty());
+    REQUIRE(osmium::tags::PrefixedRegex{".*_link"}.prefix().empty());
+    REQUIRE((osmium::tags::PrefixedRegex{"abc", std::regex::icase}.prefix().empty()));
+    REQUIRE((osmium::tags::PrefixedRegex{"abc", std::regex::extended}.prefix().empty()));
+    REQUIRE(osmium::tags::PrefixedRegex{std::regex{"abc"}}.prefix().empty());
+}
+
+TEST_CASE("PrefixedRegex matches") {
+    const osmium::tags::PrefixedRegex r1{"ab?c.*"};
+    REQUIRE(r1.match("ac"));
+    REQUIRE(r1.match("abcdef"));
+    REQUIRE_FALSE(r1.match("a"));
+    REQUIRE_FALSE(r1.match("xac"));
+
+    const osmium::tags::PrefixedRegex r2{"A.*", std::regex::icase};
+    REQUIRE(r2.match("abc"));
+
+    const osmium::tags::PrefixedRegex r3{std::regex{"x[0-9]"}};
+    REQUIRE(r3.match("x5"));
+    REQUIRE_FALSE(r3.match("x55"));
+}
+
+TEST_CASE("RegexFilter with pattern string") {
+    osmium::memory::Buffer buffer{10240};
+
+    osmium::tags::RegexFilter filter{false};
+    filter.add(true, "highway", "motorway.*")
+          .add(true, "name", std::regex{".*straße"});
+
+    const osmium::TagList& tag_list = make_tag_list(buffer, {
+        { "highway", "motorway_link" },
+        { "highway", "trunk" },
+        { "name", "Hauptstraße" },
+        { "name", "Main Street" }
+    });
+
+    check_filter(tag_list, filter, {true, false, true, false});
+}
+
 TEST_CASE("KeyPrefixFilter matches some keys") {
     osmium::memory::Buffer buffer{10240};
 
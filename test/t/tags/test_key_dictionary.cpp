@@ -0,0 +1,86 @@
+#include "catch.hpp"
+
+#include <string>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/tag.hpp>
+#include <osmium/tags/key_dictionary.hpp>
+
+TEST_CASE("Empty key dictionary") {
+    const osmium::tags::KeyDictionary dictionary;
+    REQUIRE(dictionary.empty());
+    REQUIRE(dictionary.size() == 0);
+    REQUIRE(dictionary.lookup("highway") == osmium::tags::KeyDictionary::unknown);
+    REQUIRE(dictionary.lookup("") == osmium::tags::KeyDictionary::unknown);
+}
+
+TEST_CASE("Key dictionary gives out ids in order") {
+    osmium::tags::KeyDictionary dictionary{"highway", "building", "name"};
+    REQUIRE(dictionary.size() == 3);
+    REQUIRE(dictionary.lookup("highway") == 1);
+    REQUIRE(dictionary.lookup("building") == 2);
+    REQUIRE(dictionary.lookup("name") == 3);
+    REQUIRE(dictionary.lookup("name:de") == osmium::tags::KeyDictionary::unknown);
+    REQUIRE(dictionary.lookup("nam") == osmium::tags::KeyDictionary::unknown);
+
+    REQUIRE(dictionary.add("building") == 2);
+    REQUIRE(dictionary.add("name:de") == 4);
+    REQUIRE(dictionary.size() == 4);
+    REQUIRE(dictionary.lookup("name:de") == 4);
+
+    REQUIRE(std::string{dictionary.key(1)} == "highway");
+    REQUIRE(std::string{dictionary.key(4)} == "name:de");
+}
+
+TEST_CASE("Key dictionary with many keys") {
+    osmium::tags::KeyDictionary dictionary;
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(dictionary.add("key" + std::to_string(i)) == static_cast<uint32_t>(i + 1));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        const std::string key = "key" + std::to_string(i);
+        REQUIRE(dictionary.lookup(key.c_str()) == static_cast<uint32_t>(i + 1));
+        REQUIRE(key == dictionary.key(static_cast<uint32_t>(i + 1)));
+    }
+    REQUIRE(dictionary.lookup("key1000") == osmium::tags::KeyDictionary::unknown);
+}
+
+TEST_CASE("Key id of tags") {
+    enum key : uint32_t {
+        unknown  = osmium::tags::KeyDictionary::unknown,
+        highway  = 1,
+        building = 2
+    };
+
+    const osmium::tags::KeyDictionary dictionary{"highway", "building"};
+
+    osmium::memory::Buffer buffer{10240};
+    const auto pos = osmium::builder::add_tag_list(buffer, osmium::builder::attr::_tags({
+        { "highway", "primary" },
+        { "name", "Main Street" },
+        { "building", "yes" }
+    }));
+    const auto& tags = buffer.get<osmium::TagList>(pos);
+
+    int count_highway = 0;
+    int count_building = 0;
+    int count_unknown = 0;
+    for (const auto& tag : tags) {
+        switch (tag.key_id(dictionary)) {
+            case highway:
+                ++count_highway;
+                break;
+            case building:
+                ++count_building;
+                break;
+            case unknown:
+                ++count_unknown;
+                break;
+        }
+    }
+
+    REQUIRE(count_highway == 1);
+    REQUIRE(count_building == 1);
+    REQUIRE(count_unknown == 1);
+}
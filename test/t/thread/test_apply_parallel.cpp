@@ -0,0 +1,236 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <osmium/apply_parallel.hpp>
+#include <osmium/builder/attr.hpp>
+#include <osmium/diff_handler.hpp>
+#include <osmium/diff_visitor.hpp>
+#include <osmium/handler.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/node.hpp>
+#include <osmium/osm/way.hpp>
+
+using namespace osmium::builder::attr;
+
+namespace {
+
+    // Returns 100 buffers with 10 nodes and one way each, then an
+    // invalid buffer.
+    class TestSource {
+
+        osmium::object_id_type m_next_id = 1;
+
+    public:
+
+        osmium::memory::Buffer read() {
+            if (m_next_id > 1000) {
+                return osmium::memory::Buffer{};
+            }
+            osmium::memory::Buffer buffer{10240};
+            for (int i = 0; i < 10; ++i, ++m_next_id) {
+                osmium::builder::add_node(buffer, _id(m_next_id));
+            }
+            osmium::builder::add_way(buffer, _id(m_next_id), _nodes({1, 2}));
+            return buffer;
+        }
+
+    }; // class TestSource
+
+    struct CountHandler : public osmium::handler::Handler {
+
+        uint64_t nodes = 0;
+        uint64_t ways = 0;
+        int64_t id_sum = 0;
+        std::vector<osmium::object_id_type> ids;
+        bool flushed = false;
+
+        void node(const osmium::Node& node) {
+            ++nodes;
+            id_sum += node.id();
+            ids.push_back(node.id());
+        }
+
+        void way(const osmium::Way&) {
+            ++ways;
+        }
+
+        void flush() {
+            flushed = true;
+        }
+
+    }; // struct CountHandler
+
+    struct ThrowHandler : public osmium::handler::Handler {
+
+        void way(const osmium::Way&) {
+            throw std::runtime_error{"error in handler"};
+        }
+
+    }; // struct ThrowHandler
+
+    // Returns nodes with 1 to 20 versions each in buffers with 1 to 7
+    // objects each, so objects are often split between buffers.
+    class HistorySource {
+
+        std::vector<osmium::memory::Buffer> m_buffers;
+        size_t m_next = 0;
+
+    public:
+
+        HistorySource() {
+            std::vector<std::pair<osmium::object_id_type, osmium::object_version_type>> objects;
+            for (osmium::object_id_type id = 1; id <= 300; ++id) {
+                const auto versions = static_cast<osmium::object_version_type>(id % 13 == 0 ? 20 : id % 4 + 1);
+                for (osmium::object_version_type v = 1; v <= versions; ++v) {
+                    objects.emplace_back(id, v);
+                }
+            }
+
+            size_t n = 0;
+            for (size_t size = 1; n < objects.size(); size = size % 7 + 1) {
+                m_buffers.emplace_back(10240);
+                for (size_t i = 0; i < size && n < objects.size(); ++i, ++n) {
+                    osmium::builder::add_node(m_buffers.back(), _id(objects[n].first), _version(objects[n].second));
+                }
+            }
+        }
+
+        osmium::memory::Buffer read() {
+            if (m_next == m_buffers.size()) {
+                return osmium::memory::Buffer{};
+            }
+            return std::move(m_buffers[m_next++]);
+        }
+
+        std::vector<osmium::memory::Buffer> all() const {
+            std::vector<osmium::memory::Buffer> buffers;
+            for (const auto& buffer : m_buffers) {
+                buffers.emplace_back(buffer.committed());
+                buffers.back().add_buffer(buffer);
+                buffers.back().commit();
+            }
+            return buffers;
+        }
+
+    }; // class HistorySource
+
+    using diff_record = std::tuple<osmium::object_id_type, osmium::object_version_type, osmium::object_version_type, osmium::object_version_type, bool, bool>;
+
+    struct RecordingDiffHandler : public osmium::diff_handler::DiffHandler {
+
+        std::vector<diff_record> records;
+
+        void node(const osmium::DiffNode& diff) {
+            records.emplace_back(diff.id(), diff.curr().version(), diff.prev().version(), diff.next().version(), diff.first(), diff.last());
+        }
+
+    }; // struct RecordingDiffHandler
+
+} // anonymous namespace
+
+TEST_CASE("apply_parallel with per-thread handlers") {
+    TestSource source;
+
+    int handlers = 0;
+    uint64_t nodes = 0;
+    uint64_t ways = 0;
+    int64_t id_sum = 0;
+    osmium::apply_parallel(source, []() {
+        return CountHandler{};
+    }, [&](CountHandler& handler) {
+        REQUIRE(handler.flushed);
+        ++handlers;
+        nodes += handler.nodes;
+        ways += handler.ways;
+        id_sum += handler.id_sum;
+    });
+
+    REQUIRE(handlers > 0);
+    REQUIRE(nodes == 1000);
+    REQUIRE(ways == 100);
+    REQUIRE(id_sum == 500500);
+}
+
+TEST_CASE("apply_parallel_ordered merges in input order") {
+    TestSource source;
+
+    int handlers = 0;
+    std::vector<osmium::object_id_type> ids;
+    osmium::apply_parallel_ordered(source, []() {
+        return CountHandler{};
+    }, [&](CountHandler&& handler) {
+        REQUIRE(handler.flushed);
+        REQUIRE(handler.nodes == 10);
+        ++handlers;
+        ids.insert(ids.end(), handler.ids.begin(), handler.ids.end());
+    });
+
+    REQUIRE(handlers == 100);
+    REQUIRE(ids.size() == 1000);
+    for (osmium::object_id_type id = 1; id <= 1000; ++id) {
+        REQUIRE(ids[id - 1] == id);
+    }
+}
+
+TEST_CASE("apply_parallel passes on exceptions from handlers") {
+    TestSource source;
+    REQUIRE_THROWS_AS(osmium::apply_parallel(source, []() {
+        return ThrowHandler{};
+    }, [](ThrowHandler&) {
+    }), std::runtime_error);
+}
+
+TEST_CASE("apply_parallel_ordered passes on exceptions from handlers") {
+    TestSource source;
+    REQUIRE_THROWS_AS(osmium::apply_parallel_ordered(source, []() {
+        return ThrowHandler{};
+    }, [](ThrowHandler&&) {
+    }), std::runtime_error);
+}
+
+TEST_CASE("apply_diff_parallel gives same results as apply_diff") {
+    HistorySource source;
+
+    // Sequential reference result from all data in one buffer
+    osmium::memory::Buffer all{1024 * 1024};
+    for (const auto& buffer : source.all()) {
+        all.add_buffer(buffer);
+        all.commit();
+    }
+    RecordingDiffHandler expected;
+    osmium::apply_diff(all.cbegin<osmium::OSMObject>(), all.cend<osmium::OSMObject>(), expected);
+    REQUIRE(expected.records.size() > 900);
+
+    std::vector<diff_record> records;
+    int handlers = 0;
+    osmium::apply_diff_parallel(source, []() {
+        return RecordingDiffHandler{};
+    }, [&](RecordingDiffHandler& handler) {
+        ++handlers;
+        records.insert(records.end(), handler.records.begin(), handler.records.end());
+    });
+
+    REQUIRE(handlers > 0);
+    std::sort(records.begin(), records.end());
+    REQUIRE(records == expected.records);
+}
+
+TEST_CASE("apply_diff_parallel with empty input") {
+    HistorySource source;
+    while (source.read()) {
+    }
+
+    int handlers = 0;
+    osmium::apply_diff_parallel(source, []() {
+        return RecordingDiffHandler{};
+    }, [&](RecordingDiffHandler&) {
+        ++handlers;
+    });
+    REQUIRE(handlers == 0);
+}
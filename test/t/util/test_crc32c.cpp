@@ -0,0 +1,90 @@
+#include "catch.hpp"
+
+#include <cstring>
+#include <string>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/crc.hpp>
+#include <osmium/osm/way.hpp>
+#include <osmium/util/crc32c.hpp>
+
+using namespace osmium::builder::attr;
+
+namespace {
+
+    uint32_t crc32c(const std::string& str) {
+        osmium::util::CRC32C crc;
+        crc.process_bytes(str.data(), str.size());
+        return crc.checksum();
+    }
+
+} // anonymous namespace
+
+TEST_CASE("CRC32C check values") {
+    REQUIRE(crc32c("") == 0x00000000);
+    REQUIRE(crc32c("a") == 0xc1d04330);
+    REQUIRE(crc32c("123456789") == 0xe3069283);
+    REQUIRE(crc32c(std::string(32, '\0')) == 0x8a9136aa);
+    REQUIRE(crc32c(std::string(32, '\xff')) == 0x62a8ab43);
+}
+
+TEST_CASE("CRC32C byte by byte is the same as all bytes at once") {
+    const std::string str{"The quick brown fox jumps over the lazy dog"};
+
+    osmium::util::CRC32C crc;
+    for (const char c : str) {
+        crc.process_byte(static_cast<unsigned char>(c));
+    }
+    REQUIRE(crc.checksum() == 0x22620404);
+    REQUIRE(crc32c(str) == 0x22620404);
+
+    crc.reset();
+    REQUIRE(crc.checksum() == 0);
+}
+
+TEST_CASE("CRC32C software and hardware implementations give same results") {
+    char data[100];
+    for (int i = 0; i < 100; ++i) {
+        data[i] = static_cast<char>(i * 37 + 11);
+    }
+
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t size = 0; size < 100 - offset; ++size) {
+            const uint32_t software = osmium::util::detail::crc32c_software(0xffffffff, data + offset, size);
+            REQUIRE(software == osmium::util::detail::crc32c_hardware(0xffffffff, data + offset, size));
+
+            // processing in two parts gives the same result
+            const uint32_t part = osmium::util::detail::crc32c_software(0xffffffff, data + offset, size / 2);
+            REQUIRE(software == osmium::util::detail::crc32c_software(part, data + offset + size / 2, size - size / 2));
+        }
+    }
+}
+
+TEST_CASE("CRC32C of way is the same with bulk node ref update") {
+    osmium::memory::Buffer buffer{10240};
+    osmium::builder::add_way(buffer,
+        _id(17),
+        _tag("highway", "primary"),
+        _nodes({
+            {1, {1.0, 2.0}},
+            {2, {1.5, 2.5}},
+            {3, {-1.5, -2.5}}
+        })
+    );
+    const auto& way = buffer.get<osmium::Way>(0);
+
+    osmium::CRC<osmium::util::CRC32C> crc1;
+    crc1.update(way.nodes());
+
+    osmium::CRC<osmium::util::CRC32C> crc2;
+    for (const auto& nr : way.nodes()) {
+        crc2.update(nr);
+    }
+
+    REQUIRE(crc1().checksum() == crc2().checksum());
+
+    osmium::CRC<osmium::util::CRC32C> crc3;
+    crc3.update(way);
+    REQUIRE(crc3().checksum() != 0);
+}